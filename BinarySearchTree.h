@@ -2,17 +2,21 @@
 #define BINARY_SEARCH_TREE_H
 #include <algorithm>
 #include <iostream>
+#include <utility>
 #include "Queue.h"
-template <class Data>
-class BinarySearchTree
+#include "Stack.h"
+#include "EytzingerIndex.h"
+#include "TreeProfiler.h"
+template <class Data, class Profiler = NoTreeProfiler>
+class BinarySearchTree : private Profiler
 {
 public:
 	BinarySearchTree();
-	BinarySearchTree(BinarySearchTree<Data>&& rhs) noexcept;
-	BinarySearchTree<Data>& operator=(BinarySearchTree<Data>&& rhs) noexcept;
+	BinarySearchTree(BinarySearchTree<Data, Profiler>&& rhs) noexcept;
+	BinarySearchTree<Data, Profiler>& operator=(BinarySearchTree<Data, Profiler>&& rhs) noexcept;
 	virtual ~BinarySearchTree();
-	BinarySearchTree(const BinarySearchTree<Data>&) = delete;
-	BinarySearchTree<Data>& operator=(const BinarySearchTree<Data>&) = delete;
+	BinarySearchTree(const BinarySearchTree<Data, Profiler>&) = delete;
+	BinarySearchTree<Data, Profiler>& operator=(const BinarySearchTree<Data, Profiler>&) = delete;
 
 	bool searchIterative(const Data& data) const;
 	bool insert(const Data& data);
@@ -27,6 +31,8 @@ public:
 	template<class Operation>
 	void walkByLevels(const Operation& operation) const;
 	size_t countNodesBetween(const Data& low, const Data& high) const;
+	EytzingerIndex<Data> freeze() const;
+	TreeProfile profile() const;
 	void clear();
 
 private:
@@ -36,15 +42,18 @@ private:
 		Node* left_;
 		Node* right_;
 		Node* p_;
+		int height_;
 		Node(Data data, Node* p = nullptr) :
 			data_(data),
-			p_(p),
 			left_(nullptr),
-			right_(nullptr)
+			right_(nullptr),
+			p_(p),
+			height_(1)
 		{}
 	};
 
 	Node* root_;
+	size_t size_;
 
 	Node* nextSearchNode(Node* current, const Data& data) const;
 	Node* searchNodeIterative(const Data& data) const;
@@ -57,8 +66,10 @@ private:
 	bool isLeaf(Node* node) const;
 	void printLower(std::ostream& out, Node* root) const;
 	void output(std::ostream& out, Node* root) const;
-	int getNumberOfNodes(const Node* node) const;
 	int getHeight(const Node* node) const;
+	void updateHeights(Node* node);
+	void collectDepths(const Node* root, TreeProfile& profile) const;
+	const Profiler& profiler() const;
 	template<class Operation>
 	void inorderWalk(Node* node, const Operation& operation) const;
 	Node* getNext(Node* current) const;
@@ -70,65 +81,94 @@ private:
 	void processingWalkByLevelsNode(QueueArray<Node*>& queue, const Operation& operation) const;
 };
 
-template <class Data>
-void BinarySearchTree<Data>::clear(Node* node)
+template <class Data, class Profiler>
+void BinarySearchTree<Data, Profiler>::clear(Node* node)
 {
-	if (!node)
+	while (node)
 	{
-		return;
+		if (node->left_)
+		{
+			node = node->left_;
+		}
+		else if (node->right_)
+		{
+			node = node->right_;
+		}
+		else
+		{
+			Node* parent = node->p_;
+			if (parent)
+			{
+				(parent->left_ == node ? parent->left_ : parent->right_) = nullptr;
+			}
+			delete node;
+			node = parent;
+		}
 	}
-	clear(node->left_);
-	clear(node->right_);
-	delete node;
 }
 
-template <class Data>
-void BinarySearchTree<Data>::clear()
+template <class Data, class Profiler>
+void BinarySearchTree<Data, Profiler>::clear()
 {
 	clear(root_);
 	root_ = nullptr;
+	size_ = 0;
 }
 
-template <class Data>
-BinarySearchTree<Data>::BinarySearchTree() :
-	root_(nullptr)
+template <class Data, class Profiler>
+BinarySearchTree<Data, Profiler>::BinarySearchTree() :
+	root_(nullptr),
+	size_(0)
 {}
 
-template <class Data>
-BinarySearchTree<Data>::BinarySearchTree(BinarySearchTree&& rhs) noexcept :
-	root_(rhs.root_)
+template <class Data, class Profiler>
+BinarySearchTree<Data, Profiler>::BinarySearchTree(BinarySearchTree&& rhs) noexcept :
+	Profiler(std::move(static_cast<Profiler&>(rhs))),
+	root_(rhs.root_),
+	size_(rhs.size_)
 {
 	rhs.root_ = nullptr;
+	rhs.size_ = 0;
 }
 
-template <class Data>
-BinarySearchTree<Data>& BinarySearchTree<Data>::operator=(BinarySearchTree<Data>&& rhs) noexcept
+template <class Data, class Profiler>
+BinarySearchTree<Data, Profiler>& BinarySearchTree<Data, Profiler>::operator=(BinarySearchTree<Data, Profiler>&& rhs) noexcept
 {
+	if (this == &rhs)
+	{
+		return *this;
+	}
 	clear();
+	Profiler::operator=(std::move(static_cast<Profiler&>(rhs)));
 	root_ = rhs.root_;
+	size_ = rhs.size_;
 	rhs.root_ = nullptr;
+	rhs.size_ = 0;
 	return *this;
 }
 
-template <class Data>
-BinarySearchTree<Data>::~BinarySearchTree()
+template <class Data, class Profiler>
+BinarySearchTree<Data, Profiler>::~BinarySearchTree()
 {
 	clear();
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::searchNodeIterative(const Data& data) const
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::searchNodeIterative(const Data& data) const
 {
 	Node* current = root_;
+	size_t pathLength = 0;
 	while (current && current->data_ != data)
 	{
+		++pathLength;
 		current = nextSearchNode(current, data);
 	}
+	profiler().onSearch(current ? pathLength + 1 : pathLength);
 	return current;
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::nextSearchNode(Node* current, const Data& data) const
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::nextSearchNode(Node* current, const Data& data) const
 {
 	if (current->data_ < data)
 	{
@@ -140,14 +180,14 @@ typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::nextSearchNode(No
 	}
 }
 
-template <class Data>
-bool BinarySearchTree<Data>::searchIterative(const Data& data) const
+template <class Data, class Profiler>
+bool BinarySearchTree<Data, Profiler>::searchIterative(const Data& data) const
 {
 	return searchNodeIterative(data);
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::searchExpectedParent(const Data& data, Node* current) const
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::searchExpectedParent(const Data& data, Node* current) const
 {
 	Node* expectedParrent = nullptr;
 	while (current && current->data_ != data) {
@@ -161,8 +201,8 @@ typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::searchExpectedPar
 	return expectedParrent;
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::max(Node* root) const
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::max(Node* root) const
 {
 	if (root)
 	{
@@ -174,8 +214,8 @@ typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::max(Node* root) c
 	return root;
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::min(Node* root) const
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::min(Node* root) const
 {
 	if (root)
 	{
@@ -187,8 +227,8 @@ typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::min(Node* root) c
 	return root;
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::getSuccessor(Node* root)
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::getSuccessor(Node* root)
 {
 	if (root->left_)
 	{
@@ -201,12 +241,14 @@ typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::getSuccessor(Node
 	return root;
 }
 
-template <class Data>
-bool BinarySearchTree<Data>::insert(const Data& data)
+template <class Data, class Profiler>
+bool BinarySearchTree<Data, Profiler>::insert(const Data& data)
 {
 	if (!root_)
 	{
 		root_ = new Node(data);
+		++size_;
+		profiler().onInsert();
 		return true;
 	}
 	Node* expectedParrent = searchExpectedParent(data, root_);
@@ -222,11 +264,14 @@ bool BinarySearchTree<Data>::insert(const Data& data)
 	{
 		expectedParrent->right_ = new Node(data, expectedParrent);
 	}
+	++size_;
+	profiler().onInsert();
+	updateHeights(expectedParrent);
 	return true;
 }
 
-template <class Data>
-void BinarySearchTree<Data>::removeSuccessorSourceNode(Node* source)
+template <class Data, class Profiler>
+void BinarySearchTree<Data, Profiler>::removeSuccessorSourceNode(Node* source)
 {
 	if (!source->p_)
 	{
@@ -255,11 +300,12 @@ void BinarySearchTree<Data>::removeSuccessorSourceNode(Node* source)
 	{
 		sourceChild->p_ = source->p_;
 	}
+	updateHeights(source->p_);
 	delete source;
 }
 
-template <class Data>
-bool BinarySearchTree<Data>::remove(const Data& data)
+template <class Data, class Profiler>
+bool BinarySearchTree<Data, Profiler>::remove(const Data& data)
 {
 	Node* expected = searchNodeIterative(data);
 	if (!expected)
@@ -269,17 +315,19 @@ bool BinarySearchTree<Data>::remove(const Data& data)
 	Node* forDelete = getSuccessor(expected);
 	expected->data_ = forDelete->data_;
 	removeSuccessorSourceNode(forDelete);
+	--size_;
+	profiler().onRemove();
 	return true;
 }
 
-template <class Data>
-bool BinarySearchTree<Data>::isLeaf(Node* node) const
+template <class Data, class Profiler>
+bool BinarySearchTree<Data, Profiler>::isLeaf(Node* node) const
 {
 	return !(node->left_ || node->right_);
 }
 
-template <class Data>
-void BinarySearchTree<Data>::printLower(std::ostream& out, Node* root) const
+template <class Data, class Profiler>
+void BinarySearchTree<Data, Profiler>::printLower(std::ostream& out, Node* root) const
 {
 	if (isLeaf(root))
 	{
@@ -292,8 +340,8 @@ void BinarySearchTree<Data>::printLower(std::ostream& out, Node* root) const
 	out << ')';
 }
 
-template <class Data>
-void BinarySearchTree<Data>::output(std::ostream& out, Node* root) const
+template <class Data, class Profiler>
+void BinarySearchTree<Data, Profiler>::output(std::ostream& out, Node* root) const
 {
 	if (!root)
 	{
@@ -303,42 +351,43 @@ void BinarySearchTree<Data>::output(std::ostream& out, Node* root) const
 	printLower(out, root);
 }
 
-template <class Data>
-void BinarySearchTree<Data>::output(std::ostream& out) const
+template <class Data, class Profiler>
+void BinarySearchTree<Data, Profiler>::output(std::ostream& out) const
 {
 	out << '(';
 	output(out, root_);
 	out << ')';
 }
 
-template <class Data>
-int BinarySearchTree<Data>::getNumberOfNodes(const Node* node) const
+template <class Data, class Profiler>
+int BinarySearchTree<Data, Profiler>::getNumberOfNodes() const
 {
-	if (!node)
-	{
-		return 0;
-	}
-	return 1 + getNumberOfNodes(node->left_) + getNumberOfNodes(node->right_);
+	return static_cast<int>(size_);
 }
 
-template <class Data>
-int BinarySearchTree<Data>::getNumberOfNodes() const
+template <class Data, class Profiler>
+int BinarySearchTree<Data, Profiler>::getHeight(const Node* node) const
 {
-	return getNumberOfNodes(root_);
+	return node ? node->height_ : 0;
 }
 
-template <class Data>
-int BinarySearchTree<Data>::getHeight(const Node* node) const
+template <class Data, class Profiler>
+void BinarySearchTree<Data, Profiler>::updateHeights(Node* node)
 {
-	if (!node)
+	while (node)
 	{
-		return 0;
+		int height = 1 + std::max(getHeight(node->left_), getHeight(node->right_));
+		if (height == node->height_)
+		{
+			return;
+		}
+		node->height_ = height;
+		node = node->p_;
 	}
-	return 1 + std::max(getHeight(node->left_), getHeight(node->right_));
 }
 
-template <class Data>
-int BinarySearchTree<Data>::getHeight() const
+template <class Data, class Profiler>
+int BinarySearchTree<Data, Profiler>::getHeight() const
 {
 	if (!root_)
 	{
@@ -347,9 +396,47 @@ int BinarySearchTree<Data>::getHeight() const
 	return getHeight(root_) - 1;
 }
 
-template <class Data>
+template <class Data, class Profiler>
+void BinarySearchTree<Data, Profiler>::collectDepths(const Node* root, TreeProfile& profile) const
+{
+	if (!root)
+	{
+		return;
+	}
+	StackList<std::pair<const Node*, size_t>> stack;
+	stack.push(std::make_pair(root, size_t(0)));
+	while (!stack.isEmpty())
+	{
+		const std::pair<const Node*, size_t> current = stack.pop();
+		++profile.depthHistogram[TreeProfile::histogramSlot(current.second)];
+		if (current.first->right_)
+		{
+			stack.push(std::make_pair(current.first->right_, current.second + 1));
+		}
+		if (current.first->left_)
+		{
+			stack.push(std::make_pair(current.first->left_, current.second + 1));
+		}
+	}
+}
+
+template <class Data, class Profiler>
+TreeProfile BinarySearchTree<Data, Profiler>::profile() const
+{
+	TreeProfile profile = profiler().profile();
+	collectDepths(root_, profile);
+	return profile;
+}
+
+template <class Data, class Profiler>
+const Profiler& BinarySearchTree<Data, Profiler>::profiler() const
+{
+	return *this;
+}
+
+template <class Data, class Profiler>
 template <class Operation>
-void BinarySearchTree<Data>::inorderWalk(Node* node, const Operation& operation) const
+void BinarySearchTree<Data, Profiler>::inorderWalk(Node* node, const Operation& operation) const
 {
 	if (node)
 	{
@@ -359,15 +446,15 @@ void BinarySearchTree<Data>::inorderWalk(Node* node, const Operation& operation)
 	}
 }
 
-template <class Data>
+template <class Data, class Profiler>
 template <class Operation>
-void BinarySearchTree<Data>::inorderWalk(const Operation& operation) const
+void BinarySearchTree<Data, Profiler>::inorderWalk(const Operation& operation) const
 {
 	inorderWalk(root_, operation);
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::searchNextLower(Node* current) const
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::searchNextLower(Node* current) const
 {
 	if (!current || !current->right_)
 	{
@@ -376,8 +463,8 @@ typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::searchNextLower(N
 	return min(current->right_);
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::searchNextHigher(Node* current) const
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::searchNextHigher(Node* current) const
 {
 	if (!current)
 	{
@@ -394,8 +481,8 @@ typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::searchNextHigher(
 	return current->p_;
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::getNext(Node* current) const
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::getNext(Node* current) const
 {
 	Node* expectedNext = searchNextLower(current);
 	if (!expectedNext)
@@ -405,9 +492,9 @@ typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::getNext(Node* cur
 	return expectedNext;
 }
 
-template <class Data>
+template <class Data, class Profiler>
 template <class Operation>
-void BinarySearchTree<Data>::inorderWalkIterative(const Operation& operation) const
+void BinarySearchTree<Data, Profiler>::inorderWalkIterative(const Operation& operation) const
 {
 	Node* current = min(root_);
 	while (current)
@@ -417,9 +504,9 @@ void BinarySearchTree<Data>::inorderWalkIterative(const Operation& operation) co
 	}
 }
 
-template <class Data>
+template <class Data, class Profiler>
 template <class Operation>
-void BinarySearchTree<Data>::processingWalkByLevelsNode(QueueArray<Node*>& queue, const Operation& operation) const
+void BinarySearchTree<Data, Profiler>::processingWalkByLevelsNode(QueueArray<Node*>& queue, const Operation& operation) const
 {
 	Node* tmp = queue.deQueue();
 	operation(tmp->data_);
@@ -433,8 +520,8 @@ void BinarySearchTree<Data>::processingWalkByLevelsNode(QueueArray<Node*>& queue
 	}
 }
 
-template <class Data>
-size_t BinarySearchTree<Data>::pow2(size_t degree) const
+template <class Data, class Profiler>
+size_t BinarySearchTree<Data, Profiler>::pow2(size_t degree) const
 {
 	size_t res = 1;
 	while (degree > 0)
@@ -445,9 +532,9 @@ size_t BinarySearchTree<Data>::pow2(size_t degree) const
 	return res;
 }
 
-template <class Data>
+template <class Data, class Profiler>
 template <class Operation>
-void BinarySearchTree<Data>::walkByLevels(const Operation& operation) const
+void BinarySearchTree<Data, Profiler>::walkByLevels(const Operation& operation) const
 {
 	if (root_)
 	{
@@ -460,8 +547,8 @@ void BinarySearchTree<Data>::walkByLevels(const Operation& operation) const
 	}
 }
 
-template <class Data>
-typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::searchFirstNotLess(const Data& data) const
+template <class Data, class Profiler>
+typename BinarySearchTree<Data, Profiler>::Node* BinarySearchTree<Data, Profiler>::searchFirstNotLess(const Data& data) const
 {
 	Node* current = root_;
 	Node* previous = nullptr;
@@ -481,8 +568,8 @@ typename BinarySearchTree<Data>::Node* BinarySearchTree<Data>::searchFirstNotLes
 	return previous;
 }
 
-template <class Data>
-size_t BinarySearchTree<Data>::countNodesBetween(const Data& low, const Data& high) const
+template <class Data, class Profiler>
+size_t BinarySearchTree<Data, Profiler>::countNodesBetween(const Data& low, const Data& high) const
 {
 	size_t count = 0;
 	Node* current = searchFirstNotLess(low);
@@ -494,6 +581,30 @@ size_t BinarySearchTree<Data>::countNodesBetween(const Data& low, const Data& hi
 	return count;
 }
 
+template <class Data, class Profiler>
+EytzingerIndex<Data> BinarySearchTree<Data, Profiler>::freeze() const
+{
+	size_t size = getNumberOfNodes();
+	if (size == 0)
+	{
+		return EytzingerIndex<Data>();
+	}
+	Data* sorted = new Data[size];
+	size_t next = 0;
+	inorderWalkIterative([sorted, &next](const Data& data) { sorted[next++] = data; });
+	try
+	{
+		EytzingerIndex<Data> index(sorted, size);
+		delete[] sorted;
+		return index;
+	}
+	catch (...)
+	{
+		delete[] sorted;
+		throw;
+	}
+}
+
 template <class Data>
 class Print
 {
@@ -1,6 +1,11 @@
 #ifndef DICTIONARY_LIST
 #define DICTIONARY_LIST
+#include <algorithm>
 #include <iostream>
+#include <vector>
+#include "EytzingerIndex.h"
+#include "LoserTree.h"
+#include "parallel_for.h"
 template <class Data>
 class DictionaryList {
 	struct Node {
@@ -17,8 +22,9 @@ class DictionaryList {
 	Node* head_;
 	Node* tail_;
 
-	void pushBack(const Data& data) {
-		Node* temp = new Node(data, tail_);
+	void linkBack(Node* temp) {
+		temp->previous_ = tail_;
+		temp->next_ = nullptr;
 		if (tail_) {
 			tail_->next_ = temp;
 			tail_ = tail_->next_;
@@ -29,8 +35,13 @@ class DictionaryList {
 		}
 	}
 
-	void insertBefore(const Data& data, Node* currentNode) {
-		Node* temp = new Node(data, currentNode->previous_, currentNode);
+	void pushBack(const Data& data) {
+		linkBack(new Node(data, tail_));
+	}
+
+	void linkBefore(Node* temp, Node* currentNode) {
+		temp->previous_ = currentNode->previous_;
+		temp->next_ = currentNode;
 		currentNode->previous_ = temp;
 		if (temp->previous_) {
 			temp->previous_->next_ = temp;
@@ -40,6 +51,10 @@ class DictionaryList {
 		}
 	}
 
+	void insertBefore(const Data& data, Node* currentNode) {
+		linkBefore(new Node(data, currentNode->previous_, currentNode), currentNode);
+	}
+
 	Node* SearchFirstNotLessItem(const Data& data) const {
 		Node* currentNode = head_;
 		while (currentNode && (currentNode->data_ < data)) {
@@ -48,10 +63,7 @@ class DictionaryList {
 		return currentNode;
 	}
 
-	void deleteItem(Node* node) {
-		if (!node) {
-			return;
-		}
+	void unlink(Node* node) {
 		if ((!node->previous_) && (!node->next_)) {
 			head_ = nullptr;
 			tail_ = nullptr;
@@ -68,9 +80,32 @@ class DictionaryList {
 			node->previous_->next_ = node->next_;
 			node->next_->previous_ = node->previous_;
 		}
+	}
+
+	void deleteItem(Node* node) {
+		if (!node) {
+			return;
+		}
+		unlink(node);
 		delete node;
 	}
 
+	void spliceTail(DictionaryList& other) {
+		if (!other.head_) {
+			return;
+		}
+		other.head_->previous_ = tail_;
+		if (tail_) {
+			tail_->next_ = other.head_;
+		}
+		else {
+			head_ = other.head_;
+		}
+		tail_ = other.tail_;
+		other.head_ = nullptr;
+		other.tail_ = nullptr;
+	}
+
 	Node* getNextIntersectionNode(Node*& first, Node*& second) {
 		while (first && second) {
 			if (first->data_ == second->data_){
@@ -141,6 +176,106 @@ class DictionaryList {
 		}
 	}
 
+	static const size_t SAMPLES_PER_THREAD = 64;
+
+	static bool inRange(const Node* node, const Data* upper) {
+		return node && (!upper || (node->data_ < *upper));
+	}
+
+	static void combineRange(Node** cursors, size_t count, const Data* upper, bool intersect, DictionaryList& out) {
+		LoserTree<Data> tree(count);
+		std::vector<const Data*> heads(count);
+		for (size_t i = 0; i < count; ++i) {
+			heads[i] = inRange(cursors[i], upper) ? &cursors[i]->data_ : nullptr;
+		}
+		tree.build(heads.data());
+		const Data* last = nullptr;
+		size_t run = 0;
+		while (const Data* top = tree.top()) {
+			if (last && (*last == *top)) {
+				++run;
+			}
+			else {
+				last = top;
+				run = 1;
+				if (!intersect) {
+					out.pushBack(*top);
+				}
+			}
+			if (intersect && (run == count)) {
+				out.pushBack(*top);
+			}
+			size_t winner = tree.winner();
+			cursors[winner] = cursors[winner]->next_;
+			tree.replaceWinner(inRange(cursors[winner], upper) ? &cursors[winner]->data_ : nullptr);
+		}
+	}
+
+	static std::vector<Data> sampleSplitters(const DictionaryList* const* lists, size_t count, size_t threads) {
+		size_t total = 0;
+		for (size_t i = 0; i < count; ++i) {
+			for (Node* currentNode = lists[i]->head_; currentNode; currentNode = currentNode->next_) {
+				++total;
+			}
+		}
+		size_t stride = std::max<size_t>(1, total / (threads * SAMPLES_PER_THREAD));
+		std::vector<Data> samples;
+		for (size_t i = 0; i < count; ++i) {
+			size_t position = 0;
+			for (Node* currentNode = lists[i]->head_; currentNode; currentNode = currentNode->next_) {
+				if (position++ % stride == 0) {
+					samples.push_back(currentNode->data_);
+				}
+			}
+		}
+		std::sort(samples.begin(), samples.end());
+		std::vector<Data> splitters;
+		if (samples.empty()) {
+			return splitters;
+		}
+		for (size_t t = 1; t < threads; ++t) {
+			const Data& candidate = samples[t * samples.size() / threads];
+			if (splitters.empty() || (splitters.back() < candidate)) {
+				splitters.push_back(candidate);
+			}
+		}
+		return splitters;
+	}
+
+	static DictionaryList combineAll(const DictionaryList* const* lists, size_t count, size_t threads, bool intersect) {
+		DictionaryList result;
+		if (count == 0) {
+			return result;
+		}
+		std::vector<Data> splitters;
+		if (threads > 1) {
+			splitters = sampleSplitters(lists, count, threads);
+		}
+		size_t parts = splitters.size() + 1;
+		std::vector<Node*> cursors(parts * count);
+		for (size_t i = 0; i < count; ++i) {
+			Node* currentNode = lists[i]->head_;
+			cursors[i] = currentNode;
+			for (size_t part = 1; part < parts; ++part) {
+				while (currentNode && (currentNode->data_ < splitters[part - 1])) {
+					currentNode = currentNode->next_;
+				}
+				cursors[part * count + i] = currentNode;
+			}
+		}
+		std::vector<DictionaryList> results(parts);
+		ohantsev::parallelForChunks(parts, 1, parts, [&](size_t begin, size_t end, size_t) {
+			for (size_t part = begin; part < end; ++part) {
+				const Data* upper = (part + 1 < parts) ? &splitters[part] : nullptr;
+				combineRange(cursors.data() + part * count, count, upper, intersect, results[part]);
+			}
+		});
+		for (size_t part = 0; part < parts; ++part) {
+			result.spliceTail(results[part]);
+		}
+		return result;
+	}
+
 public:
 	DictionaryList() : head_(nullptr), tail_(nullptr) {}
 
@@ -179,6 +314,7 @@ public:
 		tail_ = other.tail_;
 		other.head_ = nullptr;
 		other.tail_ = nullptr;
+		return *this;
 	}
 
 	bool insertItem(const Data& data) {
@@ -257,6 +393,82 @@ public:
 		finishCopyForMerge(currentOther);
 	}
 
+	EytzingerIndex<Data> freeze() const {
+		size_t size = 0;
+		for (Node* currentNode = head_; currentNode; currentNode = currentNode->next_) {
+			++size;
+		}
+		if (size == 0) {
+			return EytzingerIndex<Data>();
+		}
+		Data* sorted = new Data[size];
+		size_t next = 0;
+		for (Node* currentNode = head_; currentNode; currentNode = currentNode->next_) {
+			sorted[next++] = currentNode->data_;
+		}
+		try {
+			EytzingerIndex<Data> index(sorted, size);
+			delete[] sorted;
+			return index;
+		}
+		catch (...) {
+			delete[] sorted;
+			throw;
+		}
+	}
+
+	void merge(DictionaryList&& other) {
+		if (this == &other) {
+			return;
+		}
+		Node* currentThis = head_;
+		while (currentThis && other.head_) {
+			Node* currentOther = other.head_;
+			if (currentThis->data_ > currentOther->data_) {
+				other.unlink(currentOther);
+				linkBefore(currentOther, currentThis);
+			}
+			else if (currentThis->data_ == currentOther->data_) {
+				other.deleteItem(currentOther);
+				currentThis = currentThis->next_;
+			}
+			else {
+				currentThis = currentThis->next_;
+			}
+		}
+		spliceTail(other);
+	}
+
+	friend DictionaryList spliceIntersection(DictionaryList& first, const DictionaryList& second) {
+		DictionaryList intersection;
+		Node* currentFirst = first.head_;
+		Node* currentSecond = second.head_;
+		while (currentFirst && currentSecond) {
+			if (currentFirst->data_ == currentSecond->data_) {
+				Node* shared = currentFirst;
+				currentFirst = currentFirst->next_;
+				currentSecond = currentSecond->next_;
+				first.unlink(shared);
+				intersection.linkBack(shared);
+			}
+			else if (currentFirst->data_ > currentSecond->data_) {
+				currentSecond = currentSecond->next_;
+			}
+			else {
+				currentFirst = currentFirst->next_;
+			}
+		}
+		return intersection;
+	}
+
+	static DictionaryList mergeAll(const DictionaryList* const* lists, size_t count, size_t threads = 1) {
+		return combineAll(lists, count, threads, false);
+	}
+
+	static DictionaryList intersectAll(const DictionaryList* const* lists, size_t count, size_t threads = 1) {
+		return combineAll(lists, count, threads, true);
+	}
+
 	void deleteItems(DictionaryList& other) {
 		Node* currentThis = head_;
 		Node* currentOther = other.head_;
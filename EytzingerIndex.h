@@ -0,0 +1,217 @@
+#ifndef EYTZINGER_INDEX_H
+#define EYTZINGER_INDEX_H
+#include <cstddef>
+#include <utility>
+
+template <class Data>
+class EytzingerIndex
+{
+public:
+	EytzingerIndex();
+	EytzingerIndex(const Data* sorted, size_t size);
+	EytzingerIndex(EytzingerIndex<Data>&& rhs) noexcept;
+	EytzingerIndex<Data>& operator=(EytzingerIndex<Data>&& rhs) noexcept;
+	~EytzingerIndex();
+	EytzingerIndex(const EytzingerIndex<Data>&) = delete;
+	EytzingerIndex<Data>& operator=(const EytzingerIndex<Data>&) = delete;
+
+	size_t size() const noexcept;
+	bool contains(const Data& data) const;
+	const Data* lowerBound(const Data& data) const;
+	const Data* upperBound(const Data& data) const;
+	size_t countNodesBetween(const Data& low, const Data& high) const;
+
+private:
+	static constexpr size_t PREFETCH_DISTANCE = 16;
+
+	Data* data_;
+	size_t* rank_;
+	size_t size_;
+
+	size_t fill(const Data* sorted, size_t next, size_t k);
+	size_t lowerBoundIndex(const Data& data) const;
+	size_t upperBoundIndex(const Data& data) const;
+	void prefetch(size_t k) const;
+	size_t rank(size_t k) const;
+	static size_t dropRightTurns(size_t k);
+	void swap(EytzingerIndex<Data>& rhs) noexcept;
+};
+
+template <class Data>
+EytzingerIndex<Data>::EytzingerIndex() :
+	data_(nullptr),
+	rank_(nullptr),
+	size_(0)
+{}
+
+template <class Data>
+EytzingerIndex<Data>::EytzingerIndex(const Data* sorted, size_t size) :
+	data_(nullptr),
+	rank_(nullptr),
+	size_(size)
+{
+	if (size_ == 0)
+	{
+		return;
+	}
+	data_ = new Data[size_ + 1];
+	try
+	{
+		rank_ = new size_t[size_ + 1];
+		fill(sorted, 0, 1);
+	}
+	catch (...)
+	{
+		delete[] data_;
+		delete[] rank_;
+		throw;
+	}
+}
+
+template <class Data>
+EytzingerIndex<Data>::EytzingerIndex(EytzingerIndex<Data>&& rhs) noexcept :
+	data_(rhs.data_),
+	rank_(rhs.rank_),
+	size_(rhs.size_)
+{
+	rhs.data_ = nullptr;
+	rhs.rank_ = nullptr;
+	rhs.size_ = 0;
+}
+
+template <class Data>
+EytzingerIndex<Data>& EytzingerIndex<Data>::operator=(EytzingerIndex<Data>&& rhs) noexcept
+{
+	if (this != &rhs)
+	{
+		EytzingerIndex<Data> temp(std::move(rhs));
+		swap(temp);
+	}
+	return *this;
+}
+
+template <class Data>
+EytzingerIndex<Data>::~EytzingerIndex()
+{
+	delete[] data_;
+	delete[] rank_;
+}
+
+template <class Data>
+void EytzingerIndex<Data>::swap(EytzingerIndex<Data>& rhs) noexcept
+{
+	std::swap(data_, rhs.data_);
+	std::swap(rank_, rhs.rank_);
+	std::swap(size_, rhs.size_);
+}
+
+template <class Data>
+size_t EytzingerIndex<Data>::fill(const Data* sorted, size_t next, size_t k)
+{
+	if (k <= size_)
+	{
+		next = fill(sorted, next, 2 * k);
+		data_[k] = sorted[next];
+		rank_[k] = next;
+		++next;
+		next = fill(sorted, next, 2 * k + 1);
+	}
+	return next;
+}
+
+template <class Data>
+size_t EytzingerIndex<Data>::size() const noexcept
+{
+	return size_;
+}
+
+template <class Data>
+void EytzingerIndex<Data>::prefetch(size_t k) const
+{
+#if defined(__GNUC__) || defined(__clang__)
+	size_t descendant = k * PREFETCH_DISTANCE;
+	if (descendant <= size_)
+	{
+		__builtin_prefetch(data_ + descendant);
+	}
+#else
+	(void)k;
+#endif
+}
+
+template <class Data>
+size_t EytzingerIndex<Data>::dropRightTurns(size_t k)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return k >> __builtin_ffsll(static_cast<long long>(~k));
+#else
+	while (k & 1)
+	{
+		k >>= 1;
+	}
+	return k >> 1;
+#endif
+}
+
+template <class Data>
+size_t EytzingerIndex<Data>::lowerBoundIndex(const Data& data) const
+{
+	size_t k = 1;
+	while (k <= size_)
+	{
+		prefetch(k);
+		k = 2 * k + (data_[k] < data);
+	}
+	return dropRightTurns(k);
+}
+
+template <class Data>
+size_t EytzingerIndex<Data>::upperBoundIndex(const Data& data) const
+{
+	size_t k = 1;
+	while (k <= size_)
+	{
+		prefetch(k);
+		k = 2 * k + !(data < data_[k]);
+	}
+	return dropRightTurns(k);
+}
+
+template <class Data>
+size_t EytzingerIndex<Data>::rank(size_t k) const
+{
+	return k ? rank_[k] : size_;
+}
+
+template <class Data>
+bool EytzingerIndex<Data>::contains(const Data& data) const
+{
+	size_t k = lowerBoundIndex(data);
+	return k && !(data < data_[k]);
+}
+
+template <class Data>
+const Data* EytzingerIndex<Data>::lowerBound(const Data& data) const
+{
+	size_t k = lowerBoundIndex(data);
+	return k ? data_ + k : nullptr;
+}
+
+template <class Data>
+const Data* EytzingerIndex<Data>::upperBound(const Data& data) const
+{
+	size_t k = upperBoundIndex(data);
+	return k ? data_ + k : nullptr;
+}
+
+template <class Data>
+size_t EytzingerIndex<Data>::countNodesBetween(const Data& low, const Data& high) const
+{
+	if (high < low)
+	{
+		return 0;
+	}
+	return rank(upperBoundIndex(high)) - rank(lowerBoundIndex(low));
+}
+
+#endif
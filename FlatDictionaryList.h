@@ -0,0 +1,371 @@
+#ifndef FLAT_DICTIONARY_LIST
+#define FLAT_DICTIONARY_LIST
+#include <algorithm>
+#include <iostream>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+template <class Data>
+class FlatDictionaryList {
+	static const size_t GALLOP_RATIO = 32;
+
+	Data* data_;
+	size_t size_;
+	size_t capacity_;
+
+	static constexpr bool simdKeys() {
+#if defined(__SSE2__)
+		return std::is_integral<Data>::value && (sizeof(Data) == 4);
+#else
+		return false;
+#endif
+	}
+
+	static size_t gallop(const Data* array, size_t position, size_t size, const Data& data) {
+		size_t low = position;
+		size_t high = position;
+		size_t step = 1;
+		while ((high < size) && (array[high] < data)) {
+			low = high + 1;
+			high = position + step;
+			step *= 2;
+		}
+		return std::lower_bound(array + low, array + std::min(high, size), data) - array;
+	}
+
+	static size_t intersectGalloping(const Data* small, size_t smallSize, const Data* large, size_t largeSize, Data* out) {
+		size_t count = 0;
+		size_t position = 0;
+		for (size_t i = 0; (i < smallSize) && (position < largeSize); ++i) {
+			position = gallop(large, position, largeSize, small[i]);
+			if ((position < largeSize) && (large[position] == small[i])) {
+				out[count++] = small[i];
+				++position;
+			}
+		}
+		return count;
+	}
+
+	static size_t intersectScalar(const Data* first, size_t i, size_t firstSize, const Data* second, size_t j, size_t secondSize, Data* out, size_t count) {
+		while ((i < firstSize) && (j < secondSize)) {
+			if (first[i] < second[j]) {
+				++i;
+			}
+			else if (second[j] < first[i]) {
+				++j;
+			}
+			else {
+				out[count++] = first[i];
+				++i;
+				++j;
+			}
+		}
+		return count;
+	}
+
+#if defined(__SSE2__)
+	static int blockMatches(const Data* first, const Data* second) {
+		__m128i firstBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		__m128i secondBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second));
+		__m128i matches = _mm_cmpeq_epi32(firstBlock, secondBlock);
+		secondBlock = _mm_shuffle_epi32(secondBlock, _MM_SHUFFLE(0, 3, 2, 1));
+		matches = _mm_or_si128(matches, _mm_cmpeq_epi32(firstBlock, secondBlock));
+		secondBlock = _mm_shuffle_epi32(secondBlock, _MM_SHUFFLE(0, 3, 2, 1));
+		matches = _mm_or_si128(matches, _mm_cmpeq_epi32(firstBlock, secondBlock));
+		secondBlock = _mm_shuffle_epi32(secondBlock, _MM_SHUFFLE(0, 3, 2, 1));
+		matches = _mm_or_si128(matches, _mm_cmpeq_epi32(firstBlock, secondBlock));
+		return _mm_movemask_ps(_mm_castsi128_ps(matches));
+	}
+#endif
+
+	static size_t intersect(const Data* first, size_t firstSize, const Data* second, size_t secondSize, Data* out) {
+		if (firstSize > secondSize * GALLOP_RATIO) {
+			return intersectGalloping(second, secondSize, first, firstSize, out);
+		}
+		if (secondSize > firstSize * GALLOP_RATIO) {
+			return intersectGalloping(first, firstSize, second, secondSize, out);
+		}
+		size_t i = 0;
+		size_t j = 0;
+		size_t count = 0;
+#if defined(__SSE2__)
+		if constexpr (simdKeys()) {
+			while ((i + 4 <= firstSize) && (j + 4 <= secondSize)) {
+				int mask = blockMatches(first + i, second + j);
+				for (size_t k = 0; k < 4; ++k) {
+					if (mask & (1 << k)) {
+						out[count++] = first[i + k];
+					}
+				}
+				Data firstMax = first[i + 3];
+				Data secondMax = second[j + 3];
+				if (!(secondMax < firstMax)) {
+					i += 4;
+				}
+				if (!(firstMax < secondMax)) {
+					j += 4;
+				}
+			}
+		}
+#endif
+		return intersectScalar(first, i, firstSize, second, j, secondSize, out, count);
+	}
+
+	static size_t subtractGalloping(const Data* first, size_t firstSize, const Data* second, size_t secondSize, Data* out) {
+		size_t count = 0;
+		if (firstSize > secondSize) {
+			size_t i = 0;
+			for (size_t j = 0; (j < secondSize) && (i < firstSize); ++j) {
+				size_t position = gallop(first, i, firstSize, second[j]);
+				out = std::copy(first + i, first + position, out);
+				count += position - i;
+				i = ((position < firstSize) && (first[position] == second[j])) ? position + 1 : position;
+			}
+			std::copy(first + i, first + firstSize, out);
+			return count + (firstSize - i);
+		}
+		size_t j = 0;
+		for (size_t i = 0; i < firstSize; ++i) {
+			j = gallop(second, j, secondSize, first[i]);
+			if ((j >= secondSize) || !(second[j] == first[i])) {
+				out[count++] = first[i];
+			}
+		}
+		return count;
+	}
+
+	static size_t subtract(const Data* first, size_t firstSize, const Data* second, size_t secondSize, Data* out) {
+		if ((firstSize > secondSize * GALLOP_RATIO) || (secondSize > firstSize * GALLOP_RATIO)) {
+			return subtractGalloping(first, firstSize, second, secondSize, out);
+		}
+		size_t i = 0;
+		size_t j = 0;
+		size_t count = 0;
+		int found = 0;
+#if defined(__SSE2__)
+		if constexpr (simdKeys()) {
+			while ((i + 4 <= firstSize) && (j + 4 <= secondSize)) {
+				found |= blockMatches(first + i, second + j);
+				Data firstMax = first[i + 3];
+				Data secondMax = second[j + 3];
+				if (!(secondMax < firstMax)) {
+					for (size_t k = 0; k < 4; ++k) {
+						if (!(found & (1 << k))) {
+							out[count++] = first[i + k];
+						}
+					}
+					found = 0;
+					i += 4;
+				}
+				if (!(firstMax < secondMax)) {
+					j += 4;
+				}
+			}
+		}
+#endif
+		for (size_t k = 0; i < firstSize; ++i, ++k) {
+			if ((k < 4) && (found & (1 << k))) {
+				continue;
+			}
+			while ((j < secondSize) && (second[j] < first[i])) {
+				++j;
+			}
+			if ((j >= secondSize) || !(second[j] == first[i])) {
+				out[count++] = first[i];
+			}
+		}
+		return count;
+	}
+
+	static size_t unite(const Data* first, size_t firstSize, const Data* second, size_t secondSize, Data* out) {
+		if (secondSize > firstSize) {
+			std::swap(first, second);
+			std::swap(firstSize, secondSize);
+		}
+		size_t i = 0;
+		size_t count = 0;
+		bool skewed = firstSize > secondSize * GALLOP_RATIO;
+		for (size_t j = 0; j < secondSize; ++j) {
+			size_t position = skewed ? gallop(first, i, firstSize, second[j]) : i;
+			while (!skewed && (position < firstSize) && (first[position] < second[j])) {
+				++position;
+			}
+			std::copy(first + i, first + position, out + count);
+			count += position - i;
+			i = position;
+			out[count++] = second[j];
+			if ((i < firstSize) && (first[i] == second[j])) {
+				++i;
+			}
+		}
+		std::copy(first + i, first + firstSize, out + count);
+		return count + (firstSize - i);
+	}
+
+	void reserve(size_t capacity) {
+		if (capacity <= capacity_) {
+			return;
+		}
+		Data* temp = new Data[capacity];
+		try {
+			std::copy(data_, data_ + size_, temp);
+		}
+		catch (...) {
+			delete[] temp;
+			throw;
+		}
+		delete[] data_;
+		data_ = temp;
+		capacity_ = capacity;
+	}
+
+	void adopt(Data* data, size_t size, size_t capacity) {
+		delete[] data_;
+		data_ = data;
+		size_ = size;
+		capacity_ = capacity;
+	}
+
+	size_t lowerBound(const Data& data) const {
+		return std::lower_bound(data_, data_ + size_, data) - data_;
+	}
+
+	void swap(FlatDictionaryList& other) noexcept {
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+	}
+
+public:
+	FlatDictionaryList() : data_(nullptr), size_(0), capacity_(0) {}
+
+	~FlatDictionaryList() {
+		delete[] data_;
+	}
+
+	FlatDictionaryList(const FlatDictionaryList& other) : FlatDictionaryList() {
+		reserve(other.size_);
+		std::copy(other.data_, other.data_ + other.size_, data_);
+		size_ = other.size_;
+	}
+
+	FlatDictionaryList& operator=(const FlatDictionaryList& other) {
+		if (this != &other) {
+			FlatDictionaryList temp(other);
+			swap(temp);
+		}
+		return *this;
+	}
+
+	FlatDictionaryList(FlatDictionaryList&& other) noexcept : FlatDictionaryList() {
+		swap(other);
+	}
+
+	FlatDictionaryList& operator=(FlatDictionaryList&& other) noexcept {
+		if (this != &other) {
+			FlatDictionaryList temp(std::move(other));
+			swap(temp);
+		}
+		return *this;
+	}
+
+	size_t size() const noexcept {
+		return size_;
+	}
+
+	bool insertItem(const Data& data) {
+		size_t position = lowerBound(data);
+		if ((position < size_) && (data_[position] == data)) {
+			return false;
+		}
+		if (size_ == capacity_) {
+			reserve(capacity_ ? capacity_ * 2 : 8);
+		}
+		std::move_backward(data_ + position, data_ + size_, data_ + size_ + 1);
+		data_[position] = data;
+		++size_;
+		return true;
+	}
+
+	bool searchItem(const Data& data) const {
+		size_t position = lowerBound(data);
+		return (position < size_) && (data_[position] == data);
+	}
+
+	bool deleteItem(const Data& data) {
+		size_t position = lowerBound(data);
+		if ((position >= size_) || (data_[position] != data)) {
+			return false;
+		}
+		std::move(data_ + position + 1, data_ + size_, data_ + position);
+		--size_;
+		return true;
+	}
+
+	void clear() {
+		adopt(nullptr, 0, 0);
+	}
+
+	friend std::ostream& operator <<(std::ostream& out, const FlatDictionaryList& list) {
+		if (list.size_) {
+			out << list.data_[0];
+		}
+		for (size_t i = 1; i < list.size_; ++i) {
+			out << ' ' << list.data_[i];
+		}
+		return out;
+	}
+
+	void reversePrint(std::ostream& out) const {
+		if (!size_) {
+			return;
+		}
+		out << data_[size_ - 1];
+		for (size_t i = size_ - 1; i-- > 0;) {
+			out << ' ' << data_[i];
+		}
+	}
+
+	friend FlatDictionaryList getIntersection(const FlatDictionaryList& first, const FlatDictionaryList& second) {
+		FlatDictionaryList intersection;
+		size_t capacity = std::min(first.size_, second.size_);
+		if (capacity) {
+			intersection.reserve(capacity);
+			intersection.size_ = intersect(first.data_, first.size_, second.data_, second.size_, intersection.data_);
+		}
+		return intersection;
+	}
+
+	void merge(FlatDictionaryList& other) {
+		if (!other.size_) {
+			return;
+		}
+		size_t capacity = size_ + other.size_;
+		Data* temp = new Data[capacity];
+		try {
+			size_t size = unite(data_, size_, other.data_, other.size_, temp);
+			adopt(temp, size, capacity);
+		}
+		catch (...) {
+			delete[] temp;
+			throw;
+		}
+	}
+
+	void deleteItems(FlatDictionaryList& other) {
+		if (!size_ || !other.size_) {
+			return;
+		}
+		Data* temp = new Data[size_];
+		try {
+			size_t size = subtract(data_, size_, other.data_, other.size_, temp);
+			adopt(temp, size, size_);
+		}
+		catch (...) {
+			delete[] temp;
+			throw;
+		}
+	}
+};
+#endif
@@ -2,6 +2,7 @@
 #define HASH_ITERATOR_H
 #include <iterator>
 #include <cassert>
+#include "bucket_bitmap.h"
 template <class T>
 struct FwdListNode;
 
@@ -20,9 +21,10 @@ public:
   HashIterator() noexcept;
   explicit HashIterator
   (
-    const node_t* const* currentBucket,
+    const node_t* const* buckets,
+    std::size_t bucket,
     const node_t* current,
-    const node_t* const* end
+    const ohantsev::BucketBitmap* occupied
   ) noexcept;
   HashIterator(const this_t& rhs) noexcept = default;
   this_t& operator=(const this_t& rhs) noexcept = default;
@@ -34,28 +36,32 @@ public:
   bool operator!=(const this_t& rhs) const noexcept;
 
 private:
-  const node_t* const* currentBucket_;
+  const node_t* const* buckets_;
+  std::size_t bucket_;
   const node_t* current_;
-  const node_t* const* end_;
+  const ohantsev::BucketBitmap* occupied_;
 };
 
 template <class T>
 HashIterator<T>::HashIterator() noexcept:
-  currentBucket_(nullptr),
+  buckets_(nullptr),
+  bucket_(0),
   current_(nullptr),
-  end_(nullptr)
+  occupied_(nullptr)
 {}
 
 template <class T>
 HashIterator<T>::HashIterator
 (
-  const node_t* const* currentBucket,
+  const node_t* const* buckets,
+  std::size_t bucket,
   const node_t* current,
-  const node_t* const* end
+  const ohantsev::BucketBitmap* occupied
 ) noexcept:
-  currentBucket_(currentBucket),
+  buckets_(buckets),
+  bucket_(bucket),
   current_(current),
-  end_(end)
+  occupied_(occupied)
 {}
 
 template <class T>
@@ -67,14 +73,10 @@ auto HashIterator<T>::operator++() -> this_t&
     current_ = current_->next_;
     return *this;
   }
-  ++currentBucket_;
-  while ((currentBucket_ != end_) && (*currentBucket_ == nullptr))
+  bucket_ = occupied_->findNext(bucket_ + 1);
+  if (bucket_ < occupied_->size())
   {
-    ++currentBucket_;
-  }
-  if (currentBucket_ != end_)
-  {
-    current_ = *currentBucket_;
+    current_ = buckets_[bucket_];
   }
   else
   {
@@ -0,0 +1,128 @@
+#ifndef LOSER_TREE_H
+#define LOSER_TREE_H
+#include <cstddef>
+#include <utility>
+template <class Data>
+class LoserTree
+{
+public:
+	explicit LoserTree(size_t count);
+	~LoserTree();
+	LoserTree(const LoserTree<Data>&) = delete;
+	LoserTree<Data>& operator=(const LoserTree<Data>&) = delete;
+
+	void build(const Data* const* heads);
+	size_t winner() const noexcept;
+	const Data* top() const noexcept;
+	void replaceWinner(const Data* next);
+
+private:
+	const Data** current_;
+	size_t* tree_;
+	size_t count_;
+
+	bool less(size_t first, size_t second) const;
+	size_t build(size_t node);
+};
+
+template <class Data>
+LoserTree<Data>::LoserTree(size_t count) :
+	current_(new const Data*[count ? count : 1]()),
+	tree_(nullptr),
+	count_(count)
+{
+	try
+	{
+		tree_ = new size_t[count ? count : 1]();
+	}
+	catch (...)
+	{
+		delete[] current_;
+		throw;
+	}
+}
+
+template <class Data>
+LoserTree<Data>::~LoserTree()
+{
+	delete[] current_;
+	delete[] tree_;
+}
+
+template <class Data>
+bool LoserTree<Data>::less(size_t first, size_t second) const
+{
+	if (!current_[second])
+	{
+		return current_[first] || (first < second);
+	}
+	if (!current_[first])
+	{
+		return false;
+	}
+	if (*current_[first] < *current_[second])
+	{
+		return true;
+	}
+	return !(*current_[second] < *current_[first]) && (first < second);
+}
+
+template <class Data>
+size_t LoserTree<Data>::build(size_t node)
+{
+	if (node >= count_)
+	{
+		return node - count_;
+	}
+	size_t left = build(2 * node);
+	size_t right = build(2 * node + 1);
+	if (less(right, left))
+	{
+		tree_[node] = left;
+		return right;
+	}
+	tree_[node] = right;
+	return left;
+}
+
+template <class Data>
+void LoserTree<Data>::build(const Data* const* heads)
+{
+	if (count_ == 0)
+	{
+		return;
+	}
+	for (size_t i = 0; i < count_; ++i)
+	{
+		current_[i] = heads[i];
+	}
+	tree_[0] = build(1);
+}
+
+template <class Data>
+size_t LoserTree<Data>::winner() const noexcept
+{
+	return tree_[0];
+}
+
+template <class Data>
+const Data* LoserTree<Data>::top() const noexcept
+{
+	return count_ ? current_[tree_[0]] : nullptr;
+}
+
+template <class Data>
+void LoserTree<Data>::replaceWinner(const Data* next)
+{
+	size_t winner = tree_[0];
+	current_[winner] = next;
+	for (size_t node = (winner + count_) / 2; node > 0; node /= 2)
+	{
+		if (less(tree_[node], winner))
+		{
+			std::swap(tree_[node], winner);
+		}
+	}
+	tree_[0] = winner;
+}
+#endif
@@ -0,0 +1,312 @@
+#ifndef SKIP_DICTIONARY_LIST
+#define SKIP_DICTIONARY_LIST
+#include <cstdint>
+#include <iostream>
+template <class Data>
+class SkipDictionaryList {
+	static const size_t MAX_LEVEL = 16;
+
+	struct Link {
+		Link** forward_;
+		Link* previous_;
+		size_t height_;
+	};
+
+	struct Node : Link {
+		Data data_;
+		Node(const Data& data, size_t height) :
+			Link{ nullptr, nullptr, height },
+			data_(data)
+		{
+			this->forward_ = new Link*[height]();
+		}
+		~Node() {
+			delete[] this->forward_;
+		}
+	};
+
+	Link* headForward_[MAX_LEVEL];
+	Link head_;
+	Link* tail_;
+	size_t level_;
+	uint32_t seed_;
+
+	static const Data& dataOf(const Link* link) {
+		return static_cast<const Node*>(link)->data_;
+	}
+
+	Link* headLink() const {
+		return const_cast<Link*>(&head_);
+	}
+
+	void resetHead() {
+		for (size_t i = 0; i < MAX_LEVEL; ++i) {
+			headForward_[i] = nullptr;
+		}
+		tail_ = nullptr;
+		level_ = 1;
+	}
+
+	void resetFinger(Link** update) const {
+		for (size_t i = 0; i < MAX_LEVEL; ++i) {
+			update[i] = headLink();
+		}
+	}
+
+	size_t randomHeight() {
+		seed_ ^= seed_ << 13;
+		seed_ ^= seed_ >> 17;
+		seed_ ^= seed_ << 5;
+		uint32_t bits = seed_;
+		size_t height = 1;
+		while ((height < MAX_LEVEL) && ((bits & 3) == 0)) {
+			++height;
+			bits >>= 2;
+		}
+		return height;
+	}
+
+	bool isBefore(const Link* first, const Link* second) const {
+		if (second == &head_) {
+			return false;
+		}
+		return (first == &head_) || (dataOf(first) < dataOf(second));
+	}
+
+	Link* advanceFinger(Link** update, const Data& data) const {
+		Link* current = headLink();
+		for (size_t i = level_; i-- > 0;) {
+			if (isBefore(current, update[i])) {
+				current = update[i];
+			}
+			while (current->forward_[i] && (dataOf(current->forward_[i]) < data)) {
+				current = current->forward_[i];
+			}
+			update[i] = current;
+		}
+		return current->forward_[0];
+	}
+
+	Node* insertAfter(Link** update, const Data& data) {
+		size_t height = randomHeight();
+		Node* temp = new Node(data, height);
+		if (height > level_) {
+			for (size_t i = level_; i < height; ++i) {
+				update[i] = headLink();
+			}
+			level_ = height;
+		}
+		temp->previous_ = (update[0] == &head_) ? nullptr : update[0];
+		for (size_t i = 0; i < height; ++i) {
+			temp->forward_[i] = update[i]->forward_[i];
+			update[i]->forward_[i] = temp;
+			update[i] = temp;
+		}
+		if (temp->forward_[0]) {
+			temp->forward_[0]->previous_ = temp;
+		}
+		else {
+			tail_ = temp;
+		}
+		return temp;
+	}
+
+	void unlink(Link** update, Link* node) {
+		for (size_t i = 0; i < node->height_; ++i) {
+			if (update[i]->forward_[i] == node) {
+				update[i]->forward_[i] = node->forward_[i];
+			}
+		}
+		if (node->forward_[0]) {
+			node->forward_[0]->previous_ = node->previous_;
+		}
+		else {
+			tail_ = node->previous_;
+		}
+		while ((level_ > 1) && !headForward_[level_ - 1]) {
+			--level_;
+		}
+		delete static_cast<Node*>(node);
+	}
+
+	void pushBack(Link** update, const Data& data) {
+		insertAfter(update, data);
+	}
+
+	void swap(SkipDictionaryList& other) noexcept {
+		for (size_t i = 0; i < MAX_LEVEL; ++i) {
+			std::swap(headForward_[i], other.headForward_[i]);
+		}
+		std::swap(tail_, other.tail_);
+		std::swap(level_, other.level_);
+		std::swap(seed_, other.seed_);
+	}
+
+public:
+	SkipDictionaryList() :
+		head_{ headForward_, nullptr, MAX_LEVEL },
+		tail_(nullptr),
+		level_(1),
+		seed_(2463534242u)
+	{
+		resetHead();
+	}
+
+	~SkipDictionaryList() {
+		clear();
+	}
+
+	SkipDictionaryList(const SkipDictionaryList& other) :
+		SkipDictionaryList()
+	{
+		*this = other;
+	}
+
+	SkipDictionaryList& operator=(const SkipDictionaryList& other) {
+		if (this != &other) {
+			SkipDictionaryList temp;
+			Link* update[MAX_LEVEL];
+			temp.resetFinger(update);
+			for (Link* current = other.headForward_[0]; current; current = current->forward_[0]) {
+				temp.pushBack(update, dataOf(current));
+			}
+			swap(temp);
+		}
+		return *this;
+	}
+
+	SkipDictionaryList(SkipDictionaryList&& other) noexcept :
+		SkipDictionaryList()
+	{
+		swap(other);
+	}
+
+	SkipDictionaryList& operator=(SkipDictionaryList&& other) noexcept {
+		if (this != &other) {
+			clear();
+			swap(other);
+		}
+		return *this;
+	}
+
+	bool insertItem(const Data& data) {
+		Link* update[MAX_LEVEL];
+		resetFinger(update);
+		Link* firstNotLessItem = advanceFinger(update, data);
+		if (firstNotLessItem && (dataOf(firstNotLessItem) == data)) {
+			return false;
+		}
+		insertAfter(update, data);
+		return true;
+	}
+
+	bool searchItem(const Data& data) const {
+		Link* current = headLink();
+		for (size_t i = level_; i-- > 0;) {
+			while (current->forward_[i] && (dataOf(current->forward_[i]) < data)) {
+				current = current->forward_[i];
+			}
+		}
+		Link* firstNotLessItem = current->forward_[0];
+		return (firstNotLessItem && dataOf(firstNotLessItem) == data);
+	}
+
+	bool deleteItem(const Data& data) {
+		Link* update[MAX_LEVEL];
+		resetFinger(update);
+		Link* node = advanceFinger(update, data);
+		if ((!node) || (dataOf(node) != data)) {
+			return false;
+		}
+		unlink(update, node);
+		return true;
+	}
+
+	void clear() {
+		Link* current = headForward_[0];
+		while (current) {
+			Link* nextNode = current->forward_[0];
+			delete static_cast<Node*>(current);
+			current = nextNode;
+		}
+		resetHead();
+	}
+
+	friend std::ostream& operator <<(std::ostream& out, const SkipDictionaryList& list) {
+		Link* currentNode = list.headForward_[0];
+		if (currentNode) {
+			out << dataOf(currentNode);
+			currentNode = currentNode->forward_[0];
+		}
+		while (currentNode) {
+			out << ' ' << dataOf(currentNode);
+			currentNode = currentNode->forward_[0];
+		}
+		return out;
+	}
+
+	void reversePrint(std::ostream& out) const {
+		Link* currentNode = tail_;
+		if (currentNode) {
+			out << dataOf(currentNode);
+			currentNode = currentNode->previous_;
+		}
+		while (currentNode) {
+			out << ' ' << dataOf(currentNode);
+			currentNode = currentNode->previous_;
+		}
+	}
+
+	friend SkipDictionaryList getIntersection(const SkipDictionaryList& first, const SkipDictionaryList& second) {
+		SkipDictionaryList intersection;
+		Link* update[MAX_LEVEL];
+		Link* firstFinger[MAX_LEVEL];
+		Link* secondFinger[MAX_LEVEL];
+		intersection.resetFinger(update);
+		first.resetFinger(firstFinger);
+		second.resetFinger(secondFinger);
+		Link* currentFirst = first.headForward_[0];
+		Link* currentSecond = second.headForward_[0];
+		while (currentFirst && currentSecond) {
+			if (dataOf(currentFirst) == dataOf(currentSecond)) {
+				intersection.pushBack(update, dataOf(currentFirst));
+				currentFirst = currentFirst->forward_[0];
+				currentSecond = currentSecond->forward_[0];
+			}
+			else if (dataOf(currentFirst) < dataOf(currentSecond)) {
+				currentFirst = first.advanceFinger(firstFinger, dataOf(currentSecond));
+			}
+			else {
+				currentSecond = second.advanceFinger(secondFinger, dataOf(currentFirst));
+			}
+		}
+		return intersection;
+	}
+
+	void merge(SkipDictionaryList& other) {
+		Link* update[MAX_LEVEL];
+		resetFinger(update);
+		for (Link* currentOther = other.headForward_[0]; currentOther; currentOther = currentOther->forward_[0]) {
+			Link* currentThis = advanceFinger(update, dataOf(currentOther));
+			if (!currentThis || (dataOf(currentThis) != dataOf(currentOther))) {
+				insertAfter(update, dataOf(currentOther));
+			}
+		}
+	}
+
+	void deleteItems(SkipDictionaryList& other) {
+		if (&other == this) {
+			clear();
+			return;
+		}
+		Link* update[MAX_LEVEL];
+		resetFinger(update);
+		for (Link* currentOther = other.headForward_[0]; currentOther; currentOther = currentOther->forward_[0]) {
+			Link* currentThis = advanceFinger(update, dataOf(currentOther));
+			if (currentThis && (dataOf(currentThis) == dataOf(currentOther))) {
+				unlink(update, currentThis);
+			}
+		}
+	}
+};
+#endif
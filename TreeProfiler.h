@@ -0,0 +1,120 @@
+#ifndef TREE_PROFILER_H
+#define TREE_PROFILER_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+struct TreeProfile
+{
+	static const size_t HISTOGRAM_SIZE = 64;
+
+	size_t searches = 0;
+	size_t searchPathTotal = 0;
+	size_t maxSearchPath = 0;
+	size_t searchPathHistogram[HISTOGRAM_SIZE] = {};
+	size_t depthHistogram[HISTOGRAM_SIZE] = {};
+	size_t inserts = 0;
+	size_t removes = 0;
+
+	static size_t histogramSlot(size_t length)
+	{
+		return std::min(length, HISTOGRAM_SIZE - 1);
+	}
+};
+
+class NoTreeProfiler
+{
+public:
+	void onSearch(size_t) const {}
+	void onInsert() const {}
+	void onRemove() const {}
+	TreeProfile profile() const
+	{
+		return TreeProfile();
+	}
+};
+
+class TreeProfiler
+{
+public:
+	TreeProfiler() = default;
+
+	TreeProfiler(TreeProfiler&& rhs) noexcept
+	{
+		take(rhs);
+	}
+
+	TreeProfiler& operator=(TreeProfiler&& rhs) noexcept
+	{
+		if (this != &rhs)
+		{
+			take(rhs);
+		}
+		return *this;
+	}
+
+	void onSearch(size_t pathLength) const
+	{
+		searches_.fetch_add(1, std::memory_order_relaxed);
+		searchPathTotal_.fetch_add(pathLength, std::memory_order_relaxed);
+		size_t current = maxSearchPath_.load(std::memory_order_relaxed);
+		while (current < pathLength && !maxSearchPath_.compare_exchange_weak(current, pathLength, std::memory_order_relaxed))
+		{}
+		searchPathHistogram_[TreeProfile::histogramSlot(pathLength)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void onInsert() const
+	{
+		inserts_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void onRemove() const
+	{
+		removes_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	TreeProfile profile() const
+	{
+		TreeProfile result;
+		result.searches = searches_.load(std::memory_order_relaxed);
+		result.searchPathTotal = searchPathTotal_.load(std::memory_order_relaxed);
+		result.maxSearchPath = maxSearchPath_.load(std::memory_order_relaxed);
+		for (size_t slot = 0; slot < TreeProfile::HISTOGRAM_SIZE; ++slot)
+		{
+			result.searchPathHistogram[slot] = searchPathHistogram_[slot].load(std::memory_order_relaxed);
+		}
+		result.inserts = inserts_.load(std::memory_order_relaxed);
+		result.removes = removes_.load(std::memory_order_relaxed);
+		return result;
+	}
+
+private:
+	typedef std::atomic<size_t> counter_t;
+
+	mutable counter_t searches_{ 0 };
+	mutable counter_t searchPathTotal_{ 0 };
+	mutable counter_t maxSearchPath_{ 0 };
+	mutable counter_t searchPathHistogram_[TreeProfile::HISTOGRAM_SIZE]{};
+	mutable counter_t inserts_{ 0 };
+	mutable counter_t removes_{ 0 };
+
+	static void take(counter_t& counter, counter_t& source)
+	{
+		counter.store(source.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	void take(TreeProfiler& rhs)
+	{
+		take(searches_, rhs.searches_);
+		take(searchPathTotal_, rhs.searchPathTotal_);
+		take(maxSearchPath_, rhs.maxSearchPath_);
+		for (size_t slot = 0; slot < TreeProfile::HISTOGRAM_SIZE; ++slot)
+		{
+			take(searchPathHistogram_[slot], rhs.searchPathHistogram_[slot]);
+		}
+		take(inserts_, rhs.inserts_);
+		take(removes_, rhs.removes_);
+	}
+};
+
+#endif
@@ -0,0 +1,434 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <set>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "BinarySearchTree.h"
+#include "DictionaryList.h"
+#include "Queue.h"
+#include "Stack.h"
+#include "hashSet.h"
+#include "hash_map.h"
+
+namespace
+{
+  constexpr std::int64_t MIN_SIZE = 100;
+  constexpr std::int64_t MAX_SIZE = 10'000'000;
+  constexpr std::int64_t MAX_LINEAR_SIZE = 10'000;
+
+  std::uint64_t mix(std::uint64_t x)
+  {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+  }
+
+  template< class Key >
+  Key makeKey(std::uint64_t index);
+
+  template<>
+  int makeKey< int >(std::uint64_t index)
+  {
+    return static_cast< int >(index);
+  }
+
+  template<>
+  std::uint64_t makeKey< std::uint64_t >(std::uint64_t index)
+  {
+    return mix(index);
+  }
+
+  template<>
+  std::string makeKey< std::string >(std::uint64_t index)
+  {
+    return "key:" + std::to_string(mix(index));
+  }
+
+  template< class Key >
+  std::vector< Key > makeKeys(std::size_t count, bool hits)
+  {
+    std::vector< Key > keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      keys.push_back(makeKey< Key >(2 * i + (hits ? 0 : 1)));
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64{ 42 });
+    return keys;
+  }
+
+  template< class Key >
+  struct HashMapAdapter
+  {
+    using container_type = ohantsev::HashMap< Key, int >;
+    static void insert(container_type& c, const Key& key) { c.emplace(key, 0); }
+    static bool find(const container_type& c, const Key& key) { return c.find(key) != c.end(); }
+    static void erase(container_type& c, const Key& key) { c.erase(key); }
+    template< class F >
+    static void iterate(const container_type& c, F f) { for (const auto& pair: c) { f(pair.first); } }
+  };
+
+  template< class Key >
+  struct UnorderedMapAdapter
+  {
+    using container_type = std::unordered_map< Key, int >;
+    static void insert(container_type& c, const Key& key) { c.emplace(key, 0); }
+    static bool find(const container_type& c, const Key& key) { return c.find(key) != c.end(); }
+    static void erase(container_type& c, const Key& key) { c.erase(key); }
+    template< class F >
+    static void iterate(const container_type& c, F f) { for (const auto& pair: c) { f(pair.first); } }
+  };
+
+  template< class Key >
+  struct HashSetAdapter
+  {
+    using container_type = HashSet< Key >;
+    static void insert(container_type& c, const Key& key) { c.insert(key); }
+    static bool find(const container_type& c, const Key& key) { return c.find(key) != c.end(); }
+    static void erase(container_type& c, const Key& key) { c.remove(key); }
+    template< class F >
+    static void iterate(const container_type& c, F f) { for (const auto& key: c) { f(key); } }
+  };
+
+  template< class Key >
+  struct UnorderedSetAdapter
+  {
+    using container_type = std::unordered_set< Key >;
+    static void insert(container_type& c, const Key& key) { c.insert(key); }
+    static bool find(const container_type& c, const Key& key) { return c.find(key) != c.end(); }
+    static void erase(container_type& c, const Key& key) { c.erase(key); }
+    template< class F >
+    static void iterate(const container_type& c, F f) { for (const auto& key: c) { f(key); } }
+  };
+
+  template< class Key >
+  struct BinarySearchTreeAdapter
+  {
+    using container_type = BinarySearchTree< Key >;
+    static void insert(container_type& c, const Key& key) { c.insert(key); }
+    static bool find(const container_type& c, const Key& key) { return c.searchIterative(key); }
+    static void erase(container_type& c, const Key& key) { c.remove(key); }
+    template< class F >
+    static void iterate(const container_type& c, F f) { c.inorderWalkIterative(f); }
+  };
+
+  template< class Key >
+  struct DictionaryListAdapter
+  {
+    using container_type = DictionaryList< Key >;
+    static void insert(container_type& c, const Key& key) { c.insertItem(key); }
+    static bool find(const container_type& c, const Key& key) { return c.searchItem(key); }
+    static void erase(container_type& c, const Key& key) { c.deleteItem(key); }
+  };
+
+  template< class Key >
+  struct OrderedSetAdapter
+  {
+    using container_type = std::set< Key >;
+    static void insert(container_type& c, const Key& key) { c.insert(key); }
+    static bool find(const container_type& c, const Key& key) { return c.find(key) != c.end(); }
+    static void erase(container_type& c, const Key& key) { c.erase(key); }
+    template< class F >
+    static void iterate(const container_type& c, F f) { for (const auto& key: c) { f(key); } }
+  };
+
+  template< class Key >
+  struct QueueArrayAdapter
+  {
+    using container_type = QueueArray< Key >;
+    static container_type make(std::size_t count) { return container_type(count); }
+    static void push(container_type& c, const Key& key) { c.enQueue(key); }
+    static Key pop(container_type& c) { return c.deQueue(); }
+  };
+
+  template< class Key >
+  struct DequeAdapter
+  {
+    using container_type = std::deque< Key >;
+    static container_type make(std::size_t) { return container_type(); }
+    static void push(container_type& c, const Key& key) { c.push_back(key); }
+    static Key pop(container_type& c)
+    {
+      Key key = std::move(c.front());
+      c.pop_front();
+      return key;
+    }
+  };
+
+  template< class Key >
+  struct StackListAdapter
+  {
+    using container_type = StackList< Key >;
+    static container_type make(std::size_t) { return container_type(); }
+    static void push(container_type& c, const Key& key) { c.push(key); }
+    static Key pop(container_type& c) { return c.pop(); }
+  };
+
+  template< class Key >
+  struct StdStackAdapter
+  {
+    using container_type = std::stack< Key >;
+    static container_type make(std::size_t) { return container_type(); }
+    static void push(container_type& c, const Key& key) { c.push(key); }
+    static Key pop(container_type& c)
+    {
+      Key key = std::move(c.top());
+      c.pop();
+      return key;
+    }
+  };
+
+  template< class Adapter, class Key >
+  typename Adapter::container_type build(const std::vector< Key >& keys)
+  {
+    typename Adapter::container_type c;
+    for (const Key& key: keys)
+    {
+      Adapter::insert(c, key);
+    }
+    return c;
+  }
+
+  template< class Adapter, class Key >
+  void insertBenchmark(benchmark::State& state)
+  {
+    const auto keys = makeKeys< Key >(state.range(0), true);
+    for (auto _: state)
+    {
+      auto c = build< Adapter >(keys);
+      benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+  }
+
+  template< class Adapter, class Key >
+  void findBenchmark(benchmark::State& state, bool hits)
+  {
+    const auto keys = makeKeys< Key >(state.range(0), true);
+    const auto probes = makeKeys< Key >(state.range(0), hits);
+    const auto c = build< Adapter >(keys);
+    for (auto _: state)
+    {
+      std::size_t found = 0;
+      for (const Key& key: probes)
+      {
+        found += Adapter::find(c, key);
+      }
+      benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+  }
+
+  template< class Adapter, class Key >
+  void findHitBenchmark(benchmark::State& state)
+  {
+    findBenchmark< Adapter, Key >(state, true);
+  }
+
+  template< class Adapter, class Key >
+  void findMissBenchmark(benchmark::State& state)
+  {
+    findBenchmark< Adapter, Key >(state, false);
+  }
+
+  template< class Adapter, class Key >
+  void eraseBenchmark(benchmark::State& state)
+  {
+    const auto keys = makeKeys< Key >(state.range(0), true);
+    for (auto _: state)
+    {
+      state.PauseTiming();
+      auto c = build< Adapter >(keys);
+      state.ResumeTiming();
+      for (const Key& key: keys)
+      {
+        Adapter::erase(c, key);
+      }
+      benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+  }
+
+  template< class Adapter, class Key >
+  void iterateBenchmark(benchmark::State& state)
+  {
+    const auto keys = makeKeys< Key >(state.range(0), true);
+    const auto c = build< Adapter >(keys);
+    for (auto _: state)
+    {
+      std::size_t visited = 0;
+      Adapter::iterate(c, [&visited](const Key&) { ++visited; });
+      benchmark::DoNotOptimize(visited);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+  }
+
+  template< class Adapter, class Key >
+  void copyBenchmark(benchmark::State& state)
+  {
+    const auto keys = makeKeys< Key >(state.range(0), true);
+    const auto c = build< Adapter >(keys);
+    for (auto _: state)
+    {
+      auto copy(c);
+      benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+  }
+
+  template< class Adapter, class Key >
+  void moveBenchmark(benchmark::State& state)
+  {
+    const auto keys = makeKeys< Key >(state.range(0), true);
+    auto c = build< Adapter >(keys);
+    for (auto _: state)
+    {
+      auto moved(std::move(c));
+      c = std::move(moved);
+      benchmark::DoNotOptimize(c);
+    }
+  }
+
+  template< class Adapter, class Key >
+  void pushPopBenchmark(benchmark::State& state)
+  {
+    const auto keys = makeKeys< Key >(state.range(0), true);
+    for (auto _: state)
+    {
+      auto c = Adapter::make(keys.size());
+      for (const Key& key: keys)
+      {
+        Adapter::push(c, key);
+      }
+      for (std::size_t i = 0; i < keys.size(); ++i)
+      {
+        benchmark::DoNotOptimize(Adapter::pop(c));
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size() * 2);
+  }
+
+  template< class Adapter, class Key >
+  void sequenceCopyBenchmark(benchmark::State& state)
+  {
+    const auto keys = makeKeys< Key >(state.range(0), true);
+    auto c = Adapter::make(keys.size());
+    for (const Key& key: keys)
+    {
+      Adapter::push(c, key);
+    }
+    for (auto _: state)
+    {
+      auto copy(c);
+      benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+  }
+
+  template< class Adapter, class Key >
+  void sequenceMoveBenchmark(benchmark::State& state)
+  {
+    const auto keys = makeKeys< Key >(state.range(0), true);
+    auto c = Adapter::make(keys.size());
+    for (const Key& key: keys)
+    {
+      Adapter::push(c, key);
+    }
+    for (auto _: state)
+    {
+      auto moved(std::move(c));
+      c = std::move(moved);
+      benchmark::DoNotOptimize(c);
+    }
+  }
+
+  void sizes(benchmark::internal::Benchmark* bench, std::int64_t maxSize)
+  {
+    bench->RangeMultiplier(10)->Range(MIN_SIZE, maxSize)->Unit(benchmark::kMicrosecond);
+  }
+
+  std::string benchName(const std::string& container, const char* key, const char* operation)
+  {
+    return container + "<" + key + ">/" + operation;
+  }
+
+  template< class Adapter, class Key >
+  void registerLookup(const std::string& name, const char* key, std::int64_t maxSize)
+  {
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "insert").c_str(), insertBenchmark< Adapter, Key >), maxSize);
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "find_hit").c_str(), findHitBenchmark< Adapter, Key >), maxSize);
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "find_miss").c_str(), findMissBenchmark< Adapter, Key >), maxSize);
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "erase").c_str(), eraseBenchmark< Adapter, Key >), maxSize);
+  }
+
+  template< class Adapter, class Key >
+  void registerIterate(const std::string& name, const char* key, std::int64_t maxSize)
+  {
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "iterate").c_str(), iterateBenchmark< Adapter, Key >), maxSize);
+  }
+
+  template< class Adapter, class Key >
+  void registerCopyMove(const std::string& name, const char* key, std::int64_t maxSize)
+  {
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "copy").c_str(), copyBenchmark< Adapter, Key >), maxSize);
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "move").c_str(), moveBenchmark< Adapter, Key >), maxSize);
+  }
+
+  template< class Adapter, class Key >
+  void registerSequence(const std::string& name, const char* key)
+  {
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "push_pop").c_str(), pushPopBenchmark< Adapter, Key >), MAX_SIZE);
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "copy").c_str(), sequenceCopyBenchmark< Adapter, Key >), MAX_SIZE);
+    sizes(benchmark::RegisterBenchmark(benchName(name, key, "move").c_str(), sequenceMoveBenchmark< Adapter, Key >), MAX_SIZE);
+  }
+
+  template< class Key >
+  void registerKey(const char* key)
+  {
+    registerLookup< HashMapAdapter< Key >, Key >("HashMap", key, MAX_SIZE);
+    registerIterate< HashMapAdapter< Key >, Key >("HashMap", key, MAX_SIZE);
+    registerCopyMove< HashMapAdapter< Key >, Key >("HashMap", key, MAX_SIZE);
+    registerLookup< HashSetAdapter< Key >, Key >("HashSet", key, MAX_SIZE);
+    registerIterate< HashSetAdapter< Key >, Key >("HashSet", key, MAX_SIZE);
+    registerCopyMove< HashSetAdapter< Key >, Key >("HashSet", key, MAX_SIZE);
+    registerLookup< BinarySearchTreeAdapter< Key >, Key >("BinarySearchTree", key, MAX_SIZE);
+    registerIterate< BinarySearchTreeAdapter< Key >, Key >("BinarySearchTree", key, MAX_SIZE);
+    sizes(benchmark::RegisterBenchmark(benchName("BinarySearchTree", key, "move").c_str(),
+      moveBenchmark< BinarySearchTreeAdapter< Key >, Key >), MAX_SIZE);
+    registerLookup< DictionaryListAdapter< Key >, Key >("DictionaryList", key, MAX_LINEAR_SIZE);
+    registerCopyMove< DictionaryListAdapter< Key >, Key >("DictionaryList", key, MAX_LINEAR_SIZE);
+    registerSequence< QueueArrayAdapter< Key >, Key >("QueueArray", key);
+    registerSequence< StackListAdapter< Key >, Key >("StackList", key);
+#ifdef CONTAINERS_BENCHMARK_COMPARE
+    registerLookup< UnorderedMapAdapter< Key >, Key >("std::unordered_map", key, MAX_SIZE);
+    registerIterate< UnorderedMapAdapter< Key >, Key >("std::unordered_map", key, MAX_SIZE);
+    registerCopyMove< UnorderedMapAdapter< Key >, Key >("std::unordered_map", key, MAX_SIZE);
+    registerLookup< UnorderedSetAdapter< Key >, Key >("std::unordered_set", key, MAX_SIZE);
+    registerIterate< UnorderedSetAdapter< Key >, Key >("std::unordered_set", key, MAX_SIZE);
+    registerCopyMove< UnorderedSetAdapter< Key >, Key >("std::unordered_set", key, MAX_SIZE);
+    registerLookup< OrderedSetAdapter< Key >, Key >("std::set", key, MAX_SIZE);
+    registerIterate< OrderedSetAdapter< Key >, Key >("std::set", key, MAX_SIZE);
+    registerCopyMove< OrderedSetAdapter< Key >, Key >("std::set", key, MAX_SIZE);
+    registerSequence< DequeAdapter< Key >, Key >("std::deque", key);
+    registerSequence< StdStackAdapter< Key >, Key >("std::stack", key);
+#endif
+  }
+
+  [[maybe_unused]] const bool registered = []()
+  {
+    registerKey< int >("int");
+    registerKey< std::uint64_t >("uint64_t");
+    registerKey< std::string >("string");
+    return true;
+  }();
+}
@@ -0,0 +1,480 @@
+#ifndef BOUNDED_CACHE_H
+#define BOUNDED_CACHE_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "chain_table.h"
+#include "ebo_storage.h"
+#include "unique_ptr.h"
+
+namespace ohantsev
+{
+  struct CacheLinks
+  {
+    CacheLinks* prev_{ this };
+    CacheLinks* next_{ this };
+    bool referenced_{ false };
+
+    void linkBefore(CacheLinks* position) noexcept
+    {
+      prev_ = position->prev_;
+      next_ = position;
+      prev_->next_ = this;
+      position->prev_ = this;
+    }
+
+    void unlink() noexcept
+    {
+      prev_->next_ = next_;
+      next_->prev_ = prev_;
+      prev_ = next_ = this;
+    }
+  };
+
+  class LruPolicy
+  {
+  public:
+    void onInsert(CacheLinks& head, CacheLinks* node) noexcept
+    {
+      node->linkBefore(head.next_);
+    }
+
+    void onHit(CacheLinks& head, CacheLinks* node) noexcept
+    {
+      node->unlink();
+      node->linkBefore(head.next_);
+    }
+
+    CacheLinks* victim(CacheLinks& head) noexcept
+    {
+      return head.prev_;
+    }
+
+    void onRemove(CacheLinks&, CacheLinks*) noexcept {}
+  };
+
+  class ClockPolicy
+  {
+  public:
+    void onInsert(CacheLinks& head, CacheLinks* node) noexcept
+    {
+      node->linkBefore(hand_ ? hand_ : &head);
+    }
+
+    void onHit(CacheLinks&, CacheLinks* node) noexcept
+    {
+      node->referenced_ = true;
+    }
+
+    CacheLinks* victim(CacheLinks& head) noexcept
+    {
+      if (!hand_ || hand_ == &head)
+      {
+        hand_ = head.next_;
+      }
+      while (hand_->referenced_)
+      {
+        hand_->referenced_ = false;
+        advance(head);
+      }
+      return hand_;
+    }
+
+    void onRemove(CacheLinks&, CacheLinks* node) noexcept
+    {
+      if (hand_ == node)
+      {
+        hand_ = node->next_;
+      }
+    }
+
+  private:
+    CacheLinks* hand_{ nullptr };
+
+    void advance(CacheLinks& head) noexcept
+    {
+      hand_ = hand_->next_;
+      if (hand_ == &head)
+      {
+        hand_ = head.next_;
+      }
+    }
+  };
+
+  struct NoEviction
+  {
+    template< class Key, class Value >
+    void operator()(const Key&, Value&) const noexcept {}
+  };
+
+  template< class Key, class Value, class Policy,
+    class Hash = std::hash< Key >,
+    class KeyEqual = std::equal_to< Key >,
+    class OnEvict = NoEviction >
+  class BoundedCache: private EboStorage< OnEvict >, private EboStorage< Hash, HasherTag >,
+    private EboStorage< KeyEqual, KeyEqualTag >
+  {
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair< const Key, Value >;
+    using size_type = std::size_t;
+    using this_t = BoundedCache;
+
+    static constexpr double MAX_LOAD_FACTOR{ 0.7 };
+
+    explicit BoundedCache(size_type capacity, const OnEvict& onEvict = OnEvict(), const Hash& hasher = Hash(),
+      const KeyEqual& equal = KeyEqual());
+    ~BoundedCache();
+    BoundedCache(const this_t&) = delete;
+    this_t& operator=(const this_t&) = delete;
+    size_type size() const noexcept;
+    size_type capacity() const noexcept;
+    bool empty() const noexcept;
+    bool contains(const Key& key) const;
+    mapped_type* get(const Key& key);
+    const mapped_type* peek(const Key& key) const;
+    template< class K, class V >
+    bool put(K&& key, V&& value);
+    bool erase(const Key& key);
+    void clear() noexcept;
+    OnEvict& evictionCallback() noexcept;
+    const Hash& hashFunction() const noexcept;
+    const KeyEqual& keyEqual() const noexcept;
+
+  private:
+    using hasher_base_t = EboStorage< Hash, HasherTag >;
+    using key_equal_base_t = EboStorage< KeyEqual, KeyEqualTag >;
+
+    struct Node: CacheLinks
+    {
+      value_type data_;
+      Node* chain_;
+
+      template< class K, class V >
+      Node(K&& key, V&& value, Node* chain):
+        data_(std::forward< K >(key), std::forward< V >(value)),
+        chain_(chain)
+      {}
+    };
+
+    size_type size_{ 0 };
+    size_type capacity_;
+    ChainTable< Node > table_;
+    CacheLinks head_;
+    Policy policy_;
+
+    Node** findLink(const Key& key) const;
+    void evict();
+    void remove(Node** link) noexcept;
+  };
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::BoundedCache(const size_type capacity,
+    const OnEvict& onEvict, const Hash& hasher, const KeyEqual& equal):
+    EboStorage< OnEvict >(onEvict),
+    hasher_base_t(hasher),
+    key_equal_base_t(equal),
+    capacity_(capacity),
+    table_(static_cast< size_type >(capacity / MAX_LOAD_FACTOR) + 1)
+  {
+    if (capacity == 0)
+    {
+      throw std::invalid_argument("Invalid capacity");
+    }
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::~BoundedCache()
+  {
+    clear();
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  auto BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::size() const noexcept -> size_type
+  {
+    return size_;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  auto BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::capacity() const noexcept -> size_type
+  {
+    return capacity_;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  bool BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::empty() const noexcept
+  {
+    return size_ == 0;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  auto BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::findLink(const Key& key) const -> Node**
+  {
+    return table_.findLink(key, hashFunction(), keyEqual());
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  bool BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::contains(const Key& key) const
+  {
+    return *findLink(key) != nullptr;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  auto BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::get(const Key& key) -> mapped_type*
+  {
+    Node* node = *findLink(key);
+    if (!node)
+    {
+      return nullptr;
+    }
+    policy_.onHit(head_, node);
+    return &node->data_.second;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  auto BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::peek(const Key& key) const -> const mapped_type*
+  {
+    const Node* node = *findLink(key);
+    return node ? &node->data_.second : nullptr;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  template< class K, class V >
+  bool BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::put(K&& key, V&& value)
+  {
+    Node** link = findLink(key);
+    if (*link)
+    {
+      (*link)->data_.second = std::forward< V >(value);
+      policy_.onHit(head_, *link);
+      return false;
+    }
+    if (size_ == capacity_)
+    {
+      evict();
+      link = findLink(key);
+    }
+    Node* node = new Node(std::forward< K >(key), std::forward< V >(value), nullptr);
+    *link = node;
+    policy_.onInsert(head_, node);
+    ++size_;
+    return true;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  bool BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::erase(const Key& key)
+  {
+    Node** link = findLink(key);
+    if (!*link)
+    {
+      return false;
+    }
+    remove(link);
+    return true;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  void BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::evict()
+  {
+    Node* victim = static_cast< Node* >(policy_.victim(head_));
+    evictionCallback()(victim->data_.first, victim->data_.second);
+    remove(findLink(victim->data_.first));
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  void BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::remove(Node** link) noexcept
+  {
+    Node* node = *link;
+    *link = node->chain_;
+    policy_.onRemove(head_, node);
+    node->unlink();
+    delete node;
+    --size_;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  void BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::clear() noexcept
+  {
+    table_.clear([this](Node* node)
+    {
+      policy_.onRemove(head_, node);
+      node->unlink();
+      delete node;
+    });
+    size_ = 0;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  OnEvict& BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::evictionCallback() noexcept
+  {
+    return this->EboStorage< OnEvict >::get();
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  const Hash& BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::hashFunction() const noexcept
+  {
+    return this->hasher_base_t::get();
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  const KeyEqual& BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::keyEqual() const noexcept
+  {
+    return this->key_equal_base_t::get();
+  }
+
+  template< class Key, class Value,
+    class Hash = std::hash< Key >,
+    class KeyEqual = std::equal_to< Key >,
+    class OnEvict = NoEviction >
+  using LruCache = BoundedCache< Key, Value, LruPolicy, Hash, KeyEqual, OnEvict >;
+
+  template< class Key, class Value,
+    class Hash = std::hash< Key >,
+    class KeyEqual = std::equal_to< Key >,
+    class OnEvict = NoEviction >
+  using ClockCache = BoundedCache< Key, Value, ClockPolicy, Hash, KeyEqual, OnEvict >;
+
+  template< class Key, class Value, class Policy = LruPolicy,
+    class Hash = std::hash< Key >,
+    class KeyEqual = std::equal_to< Key >,
+    class OnEvict = NoEviction >
+  class ShardedCache: private EboStorage< Hash, HasherTag >
+  {
+  public:
+    using cache_t = BoundedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >;
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+
+    static constexpr size_type DEFAULT_SHARDS{ 16 };
+
+    explicit ShardedCache(size_type capacity, size_type shards = DEFAULT_SHARDS, const OnEvict& onEvict = OnEvict(),
+      const Hash& hasher = Hash(), const KeyEqual& equal = KeyEqual());
+    size_type size() const;
+    size_type shardCount() const noexcept;
+    bool contains(const Key& key) const;
+    std::optional< Value > get(const Key& key);
+    template< class K, class V >
+    bool put(K&& key, V&& value);
+    bool erase(const Key& key);
+    void clear();
+    const Hash& hashFunction() const noexcept;
+
+  private:
+    using hasher_base_t = EboStorage< Hash, HasherTag >;
+
+    struct alignas(64) Shard
+    {
+      mutable std::mutex mutex_;
+      cache_t cache_;
+
+      Shard(size_type capacity, const OnEvict& onEvict, const Hash& hasher, const KeyEqual& equal):
+        cache_(capacity, onEvict, hasher, equal)
+      {}
+    };
+
+    std::vector< UniquePtr< Shard > > shards_;
+
+    Shard& shardOf(const Key& key) const;
+  };
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::ShardedCache(const size_type capacity,
+    const size_type shards, const OnEvict& onEvict, const Hash& hasher, const KeyEqual& equal):
+    hasher_base_t(hasher)
+  {
+    if (shards == 0 || capacity < shards)
+    {
+      throw std::invalid_argument("Invalid capacity");
+    }
+    shards_.reserve(shards);
+    for (size_type shard = 0; shard < shards; ++shard)
+    {
+      const size_type share = capacity / shards + (shard < capacity % shards);
+      shards_.push_back(makeUnique< Shard >(share, onEvict, hasher, equal));
+    }
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  auto ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::shardOf(const Key& key) const -> Shard&
+  {
+    const std::uint64_t mixed = static_cast< std::uint64_t >(hashFunction()(key)) * 0x9E3779B97F4A7C15ull;
+    return *shards_[((mixed >> 32) * shards_.size()) >> 32];
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  auto ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::size() const -> size_type
+  {
+    size_type result = 0;
+    for (const UniquePtr< Shard >& shard: shards_)
+    {
+      std::lock_guard< std::mutex > lock(shard->mutex_);
+      result += shard->cache_.size();
+    }
+    return result;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  auto ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::shardCount() const noexcept -> size_type
+  {
+    return shards_.size();
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  bool ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::contains(const Key& key) const
+  {
+    Shard& shard = shardOf(key);
+    std::lock_guard< std::mutex > lock(shard.mutex_);
+    return shard.cache_.contains(key);
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  std::optional< Value > ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::get(const Key& key)
+  {
+    Shard& shard = shardOf(key);
+    std::lock_guard< std::mutex > lock(shard.mutex_);
+    const Value* value = shard.cache_.get(key);
+    return value ? std::optional< Value >(*value) : std::nullopt;
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  template< class K, class V >
+  bool ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::put(K&& key, V&& value)
+  {
+    Shard& shard = shardOf(key);
+    std::lock_guard< std::mutex > lock(shard.mutex_);
+    return shard.cache_.put(std::forward< K >(key), std::forward< V >(value));
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  bool ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::erase(const Key& key)
+  {
+    Shard& shard = shardOf(key);
+    std::lock_guard< std::mutex > lock(shard.mutex_);
+    return shard.cache_.erase(key);
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  void ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::clear()
+  {
+    for (UniquePtr< Shard >& shard: shards_)
+    {
+      std::lock_guard< std::mutex > lock(shard->mutex_);
+      shard->cache_.clear();
+    }
+  }
+
+  template< class Key, class Value, class Policy, class Hash, class KeyEqual, class OnEvict >
+  const Hash& ShardedCache< Key, Value, Policy, Hash, KeyEqual, OnEvict >::hashFunction() const noexcept
+  {
+    return this->hasher_base_t::get();
+  }
+}
+#endif
@@ -0,0 +1,251 @@
+#ifndef BUCKET_BITMAP_H
+#define BUCKET_BITMAP_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace ohantsev
+{
+  class BucketBitmap
+  {
+  public:
+    static constexpr std::size_t WORD_BITS{ 64 };
+    static constexpr std::size_t GROUP_BUCKETS{ WORD_BITS * WORD_BITS };
+
+    BucketBitmap() = default;
+    explicit BucketBitmap(std::size_t bucketCount);
+    ~BucketBitmap();
+    BucketBitmap(const BucketBitmap&) = delete;
+    BucketBitmap& operator=(const BucketBitmap&) = delete;
+    BucketBitmap(BucketBitmap&& rhs) noexcept;
+    BucketBitmap& operator=(BucketBitmap&& rhs) noexcept;
+    void swap(BucketBitmap& rhs) noexcept;
+    std::size_t size() const noexcept;
+    std::size_t count() const noexcept;
+    bool test(std::size_t bucket) const noexcept;
+    void set(std::size_t bucket) noexcept;
+    void setNoHint(std::size_t bucket) noexcept;
+    void resetHint() noexcept;
+    void reset(std::size_t bucket) noexcept;
+    void clear() noexcept;
+    std::size_t findFirst() const noexcept;
+    std::size_t findNext(std::size_t bucket) const noexcept;
+
+  private:
+    std::uint64_t* words_{ nullptr };
+    std::uint64_t* summary_{ nullptr };
+    std::size_t size_{ 0 };
+    std::size_t firstHint_{ 0 };
+    std::uint64_t local_[2]{};
+
+    bool isLocal() const noexcept;
+    std::size_t wordCount() const noexcept;
+    std::size_t summaryCount() const noexcept;
+    std::size_t findNextWord(std::size_t word) const noexcept;
+    static std::size_t countTrailingZeros(std::uint64_t word) noexcept;
+    static std::size_t popCount(std::uint64_t word) noexcept;
+  };
+
+  inline BucketBitmap::BucketBitmap(const std::size_t bucketCount):
+    size_(bucketCount),
+    firstHint_(bucketCount)
+  {
+    words_ = (wordCount() + summaryCount() <= 2) ? local_ : new std::uint64_t[wordCount() + summaryCount()]();
+    summary_ = words_ + wordCount();
+  }
+
+  inline BucketBitmap::~BucketBitmap()
+  {
+    if (!isLocal())
+    {
+      delete[] words_;
+    }
+  }
+
+  inline bool BucketBitmap::isLocal() const noexcept
+  {
+    return words_ == local_;
+  }
+
+  inline BucketBitmap::BucketBitmap(BucketBitmap&& rhs) noexcept
+  {
+    swap(rhs);
+  }
+
+  inline BucketBitmap& BucketBitmap::operator=(BucketBitmap&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      BucketBitmap tmp(std::move(rhs));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  inline void BucketBitmap::swap(BucketBitmap& rhs) noexcept
+  {
+    const bool local = isLocal();
+    const bool rhsLocal = rhs.isLocal();
+    std::swap(words_, rhs.words_);
+    std::swap(summary_, rhs.summary_);
+    std::swap(size_, rhs.size_);
+    std::swap(firstHint_, rhs.firstHint_);
+    std::swap(local_, rhs.local_);
+    if (rhsLocal)
+    {
+      words_ = local_;
+      summary_ = local_ + wordCount();
+    }
+    if (local)
+    {
+      rhs.words_ = rhs.local_;
+      rhs.summary_ = rhs.local_ + rhs.wordCount();
+    }
+  }
+
+  inline std::size_t BucketBitmap::size() const noexcept
+  {
+    return size_;
+  }
+
+  inline std::size_t BucketBitmap::wordCount() const noexcept
+  {
+    return (size_ + WORD_BITS - 1) / WORD_BITS;
+  }
+
+  inline std::size_t BucketBitmap::summaryCount() const noexcept
+  {
+    return (wordCount() + WORD_BITS - 1) / WORD_BITS;
+  }
+
+  inline std::size_t BucketBitmap::countTrailingZeros(const std::uint64_t word) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast< std::size_t >(__builtin_ctzll(word));
+#else
+    std::size_t count = 0;
+    while (!(word & (std::uint64_t{ 1 } << count)))
+    {
+      ++count;
+    }
+    return count;
+#endif
+  }
+
+  inline std::size_t BucketBitmap::popCount(std::uint64_t word) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast< std::size_t >(__builtin_popcountll(word));
+#else
+    std::size_t count = 0;
+    for (; word; word &= word - 1)
+    {
+      ++count;
+    }
+    return count;
+#endif
+  }
+
+  inline std::size_t BucketBitmap::count() const noexcept
+  {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < wordCount(); ++i)
+    {
+      result += popCount(words_[i]);
+    }
+    return result;
+  }
+
+  inline bool BucketBitmap::test(const std::size_t bucket) const noexcept
+  {
+    return (words_[bucket / WORD_BITS] >> (bucket % WORD_BITS)) & 1;
+  }
+
+  inline void BucketBitmap::set(const std::size_t bucket) noexcept
+  {
+    const std::size_t word = bucket / WORD_BITS;
+    words_[word] |= std::uint64_t{ 1 } << (bucket % WORD_BITS);
+    summary_[word / WORD_BITS] |= std::uint64_t{ 1 } << (word % WORD_BITS);
+    firstHint_ = std::min(firstHint_, bucket);
+  }
+
+  inline void BucketBitmap::setNoHint(const std::size_t bucket) noexcept
+  {
+    const std::size_t word = bucket / WORD_BITS;
+    words_[word] |= std::uint64_t{ 1 } << (bucket % WORD_BITS);
+    summary_[word / WORD_BITS] |= std::uint64_t{ 1 } << (word % WORD_BITS);
+  }
+
+  inline void BucketBitmap::resetHint() noexcept
+  {
+    firstHint_ = findNext(0);
+  }
+
+  inline void BucketBitmap::reset(const std::size_t bucket) noexcept
+  {
+    const std::size_t word = bucket / WORD_BITS;
+    words_[word] &= ~(std::uint64_t{ 1 } << (bucket % WORD_BITS));
+    if (!words_[word])
+    {
+      summary_[word / WORD_BITS] &= ~(std::uint64_t{ 1 } << (word % WORD_BITS));
+    }
+    if (bucket == firstHint_)
+    {
+      firstHint_ = findNext(bucket + 1);
+    }
+  }
+
+  inline void BucketBitmap::clear() noexcept
+  {
+    std::fill(words_, words_ + wordCount() + summaryCount(), std::uint64_t{ 0 });
+    firstHint_ = size_;
+  }
+
+  inline std::size_t BucketBitmap::findFirst() const noexcept
+  {
+    return firstHint_;
+  }
+
+  inline std::size_t BucketBitmap::findNext(const std::size_t bucket) const noexcept
+  {
+    if (bucket >= size_)
+    {
+      return size_;
+    }
+    std::size_t word = bucket / WORD_BITS;
+    std::uint64_t bits = words_[word] & (~std::uint64_t{ 0 } << (bucket % WORD_BITS));
+    if (!bits)
+    {
+      word = findNextWord(word + 1);
+      if (word >= wordCount())
+      {
+        return size_;
+      }
+      bits = words_[word];
+    }
+    return word * WORD_BITS + countTrailingZeros(bits);
+  }
+
+  inline std::size_t BucketBitmap::findNextWord(const std::size_t word) const noexcept
+  {
+    const std::size_t words = wordCount();
+    if (word >= words)
+    {
+      return words;
+    }
+    std::size_t group = word / WORD_BITS;
+    std::uint64_t bits = summary_[group] & (~std::uint64_t{ 0 } << (word % WORD_BITS));
+    const std::size_t groups = summaryCount();
+    while (!bits)
+    {
+      if (++group >= groups)
+      {
+        return words;
+      }
+      bits = summary_[group];
+    }
+    return group * WORD_BITS + countTrailingZeros(bits);
+  }
+}
+#endif
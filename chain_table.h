@@ -0,0 +1,107 @@
+#ifndef CHAIN_TABLE_H
+#define CHAIN_TABLE_H
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+namespace ohantsev
+{
+  template< class Node >
+  class ChainTable
+  {
+  public:
+    using size_type = std::size_t;
+
+    explicit ChainTable(size_type bucketCount);
+    ~ChainTable();
+    ChainTable(const ChainTable&) = delete;
+    ChainTable& operator=(const ChainTable&) = delete;
+    size_type bucketCount() const noexcept;
+    template< class Key, class Hash, class KeyEqual >
+    Node** findLink(const Key& key, const Hash& hasher, const KeyEqual& equal) const;
+    template< class Hash >
+    void resize(size_type bucketCount, const Hash& hasher);
+    template< class Destroy >
+    void clear(Destroy destroy) noexcept;
+
+  private:
+    size_type bucketCount_;
+    Node** buckets_;
+  };
+
+  template< class Node >
+  ChainTable< Node >::ChainTable(const size_type bucketCount):
+    bucketCount_(bucketCount),
+    buckets_(nullptr)
+  {
+    if (bucketCount == 0)
+    {
+      throw std::invalid_argument("Invalid bucket count");
+    }
+    buckets_ = new Node*[bucketCount_]();
+  }
+
+  template< class Node >
+  ChainTable< Node >::~ChainTable()
+  {
+    delete[] buckets_;
+  }
+
+  template< class Node >
+  auto ChainTable< Node >::bucketCount() const noexcept -> size_type
+  {
+    return bucketCount_;
+  }
+
+  template< class Node >
+  template< class Key, class Hash, class KeyEqual >
+  Node** ChainTable< Node >::findLink(const Key& key, const Hash& hasher, const KeyEqual& equal) const
+  {
+    Node** link = &buckets_[hasher(key) % bucketCount_];
+    while (*link && !equal((*link)->data_.first, key))
+    {
+      link = &(*link)->chain_;
+    }
+    return link;
+  }
+
+  template< class Node >
+  template< class Hash >
+  void ChainTable< Node >::resize(const size_type bucketCount, const Hash& hasher)
+  {
+    Node** buckets = new Node*[bucketCount]();
+    for (size_type bucket = 0; bucket < bucketCount_; ++bucket)
+    {
+      Node* node = buckets_[bucket];
+      while (node)
+      {
+        Node* next = node->chain_;
+        Node*& head = buckets[hasher(node->data_.first) % bucketCount];
+        node->chain_ = head;
+        head = node;
+        node = next;
+      }
+    }
+    delete[] buckets_;
+    buckets_ = buckets;
+    bucketCount_ = bucketCount;
+  }
+
+  template< class Node >
+  template< class Destroy >
+  void ChainTable< Node >::clear(Destroy destroy) noexcept
+  {
+    for (size_type bucket = 0; bucket < bucketCount_; ++bucket)
+    {
+      Node* node = buckets_[bucket];
+      while (node)
+      {
+        Node* next = node->chain_;
+        destroy(node);
+        node = next;
+      }
+    }
+    std::fill(buckets_, buckets_ + bucketCount_, nullptr);
+  }
+}
+#endif
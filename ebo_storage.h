@@ -0,0 +1,52 @@
+#ifndef EBO_STORAGE_H
+#define EBO_STORAGE_H
+#include <type_traits>
+#include <utility>
+
+namespace ohantsev
+{
+  struct HasherTag;
+  struct KeyEqualTag;
+
+  template< class T, class Tag = void, bool Empty = std::is_empty< T >::value && !std::is_final< T >::value >
+  class EboStorage: private T
+  {
+  public:
+    EboStorage() = default;
+    template< class U >
+    explicit EboStorage(U&& value):
+      T(std::forward< U >(value))
+    {}
+    T& get() noexcept
+    {
+      return *this;
+    }
+    const T& get() const noexcept
+    {
+      return *this;
+    }
+  };
+
+  template< class T, class Tag >
+  class EboStorage< T, Tag, false >
+  {
+  public:
+    EboStorage() = default;
+    template< class U >
+    explicit EboStorage(U&& value):
+      value_(std::forward< U >(value))
+    {}
+    T& get() noexcept
+    {
+      return value_;
+    }
+    const T& get() const noexcept
+    {
+      return value_;
+    }
+
+  private:
+    T value_{};
+  };
+}
+#endif
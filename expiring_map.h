@@ -0,0 +1,476 @@
+#ifndef EXPIRING_MAP_H
+#define EXPIRING_MAP_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include "chain_table.h"
+#include "ebo_storage.h"
+
+namespace ohantsev
+{
+  struct TimerLinks
+  {
+    TimerLinks* prev_{ this };
+    TimerLinks* next_{ this };
+
+    bool empty() const noexcept
+    {
+      return next_ == this;
+    }
+
+    void linkBefore(TimerLinks* position) noexcept
+    {
+      prev_ = position->prev_;
+      next_ = position;
+      prev_->next_ = this;
+      position->prev_ = this;
+    }
+
+    void unlink() noexcept
+    {
+      prev_->next_ = next_;
+      next_->prev_ = prev_;
+      prev_ = next_ = this;
+    }
+  };
+
+  struct NoExpireCallback
+  {
+    template< class Key, class Value >
+    void operator()(const Key&, Value&) const noexcept {}
+  };
+
+  template< class Key, class Value,
+    class Hash = std::hash< Key >,
+    class KeyEqual = std::equal_to< Key > >
+  class ExpiringMap: private EboStorage< Hash, HasherTag >, private EboStorage< KeyEqual, KeyEqualTag >
+  {
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair< const Key, Value >;
+    using size_type = std::size_t;
+    using time_type = std::uint64_t;
+    using this_t = ExpiringMap;
+
+    static constexpr double MAX_LOAD_FACTOR{ 0.7 };
+    static constexpr double EXPANSION_COEFFICIENT{ 2.0 };
+    static constexpr std::size_t SLOT_BITS{ 6 };
+    static constexpr std::size_t SLOTS{ std::size_t{ 1 } << SLOT_BITS };
+    static constexpr std::size_t LEVELS{ 6 };
+
+    explicit ExpiringMap(time_type start = 0, size_type capacity = 10, const Hash& hasher = Hash(),
+      const KeyEqual& equal = KeyEqual());
+    ~ExpiringMap();
+    ExpiringMap(const this_t&) = delete;
+    this_t& operator=(const this_t&) = delete;
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+    time_type now() const noexcept;
+    template< class K, class V >
+    bool put(K&& key, V&& value, time_type deadline);
+    bool expireAt(const Key& key, time_type deadline);
+    mapped_type* find(const Key& key);
+    mapped_type* find(const Key& key, time_type now);
+    const mapped_type* find(const Key& key) const;
+    const mapped_type* find(const Key& key, time_type now) const;
+    const time_type* deadline(const Key& key) const;
+    bool erase(const Key& key);
+    void clear() noexcept;
+    size_type advance(time_type now);
+    template< class OnExpire >
+    size_type advance(time_type now, OnExpire onExpire);
+    const Hash& hashFunction() const noexcept;
+    const KeyEqual& keyEqual() const noexcept;
+
+  private:
+    using hasher_base_t = EboStorage< Hash, HasherTag >;
+    using key_equal_base_t = EboStorage< KeyEqual, KeyEqualTag >;
+
+    struct Node: TimerLinks
+    {
+      value_type data_;
+      Node* chain_;
+      time_type deadline_;
+
+      template< class K, class V >
+      Node(K&& key, V&& value, time_type deadline):
+        data_(std::forward< K >(key), std::forward< V >(value)),
+        chain_(nullptr),
+        deadline_(deadline)
+      {}
+    };
+
+    size_type size_{ 0 };
+    ChainTable< Node > table_;
+    time_type current_;
+    TimerLinks wheel_[LEVELS][SLOTS];
+    std::uint64_t occupied_[LEVELS]{};
+    TimerLinks overflow_;
+    TimerLinks due_;
+
+    Node** findLink(const Key& key) const;
+    Node* findLive(const Key& key, time_type now) const;
+    void schedule(Node* node) noexcept;
+    void unschedule(Node* node) noexcept;
+    bool nextEvent(time_type& event, std::size_t& level) const noexcept;
+    void cascade(TimerLinks& list) noexcept;
+    template< class OnExpire >
+    size_type expireDue(OnExpire& onExpire);
+    void remove(Node* node) noexcept;
+    static std::size_t slotOf(time_type time, std::size_t level) noexcept;
+    static std::size_t highestBit(std::uint64_t value) noexcept;
+    static std::size_t lowestBit(std::uint64_t value) noexcept;
+  };
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  ExpiringMap< Key, Value, Hash, KeyEqual >::ExpiringMap(const time_type start, const size_type capacity,
+    const Hash& hasher, const KeyEqual& equal):
+    hasher_base_t(hasher),
+    key_equal_base_t(equal),
+    table_(static_cast< size_type >(capacity / MAX_LOAD_FACTOR) + 1),
+    current_(start)
+  {
+    if (capacity == 0)
+    {
+      throw std::invalid_argument("Invalid capacity");
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  ExpiringMap< Key, Value, Hash, KeyEqual >::~ExpiringMap()
+  {
+    clear();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::size() const noexcept -> size_type
+  {
+    return size_;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  bool ExpiringMap< Key, Value, Hash, KeyEqual >::empty() const noexcept
+  {
+    return size_ == 0;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::now() const noexcept -> time_type
+  {
+    return current_;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::findLink(const Key& key) const -> Node**
+  {
+    return table_.findLink(key, hashFunction(), keyEqual());
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::findLive(const Key& key, const time_type now) const -> Node*
+  {
+    Node* node = *findLink(key);
+    return (node && node->deadline_ > now) ? node : nullptr;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class K, class V >
+  bool ExpiringMap< Key, Value, Hash, KeyEqual >::put(K&& key, V&& value, const time_type deadline)
+  {
+    Node** link = findLink(key);
+    if (*link)
+    {
+      (*link)->data_.second = std::forward< V >(value);
+      unschedule(*link);
+      (*link)->deadline_ = deadline;
+      schedule(*link);
+      return false;
+    }
+    if (static_cast< double >(size_ + 1) / table_.bucketCount() >= MAX_LOAD_FACTOR)
+    {
+      const size_type capacity = static_cast< size_type >(size_ * EXPANSION_COEFFICIENT) + 1;
+      table_.resize(static_cast< size_type >(capacity / MAX_LOAD_FACTOR) + 1, hashFunction());
+      link = findLink(key);
+    }
+    Node* node = new Node(std::forward< K >(key), std::forward< V >(value), deadline);
+    *link = node;
+    schedule(node);
+    ++size_;
+    return true;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  bool ExpiringMap< Key, Value, Hash, KeyEqual >::expireAt(const Key& key, const time_type deadline)
+  {
+    Node* node = *findLink(key);
+    if (!node)
+    {
+      return false;
+    }
+    unschedule(node);
+    node->deadline_ = deadline;
+    schedule(node);
+    return true;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::find(const Key& key) -> mapped_type*
+  {
+    return find(key, current_);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::find(const Key& key, const time_type now) -> mapped_type*
+  {
+    Node* node = findLive(key, now);
+    return node ? &node->data_.second : nullptr;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::find(const Key& key) const -> const mapped_type*
+  {
+    return find(key, current_);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::find(const Key& key, const time_type now) const
+    -> const mapped_type*
+  {
+    const Node* node = findLive(key, now);
+    return node ? &node->data_.second : nullptr;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::deadline(const Key& key) const -> const time_type*
+  {
+    const Node* node = *findLink(key);
+    return node ? &node->deadline_ : nullptr;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  bool ExpiringMap< Key, Value, Hash, KeyEqual >::erase(const Key& key)
+  {
+    Node* node = *findLink(key);
+    if (!node)
+    {
+      return false;
+    }
+    remove(node);
+    return true;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  void ExpiringMap< Key, Value, Hash, KeyEqual >::remove(Node* node) noexcept
+  {
+    Node** link = findLink(node->data_.first);
+    *link = node->chain_;
+    unschedule(node);
+    delete node;
+    --size_;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  void ExpiringMap< Key, Value, Hash, KeyEqual >::clear() noexcept
+  {
+    table_.clear([](Node* node)
+    {
+      node->unlink();
+      delete node;
+    });
+    std::fill(occupied_, occupied_ + LEVELS, std::uint64_t{ 0 });
+    size_ = 0;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  std::size_t ExpiringMap< Key, Value, Hash, KeyEqual >::slotOf(const time_type time, const std::size_t level) noexcept
+  {
+    return static_cast< std::size_t >(time >> (level * SLOT_BITS)) & (SLOTS - 1);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  std::size_t ExpiringMap< Key, Value, Hash, KeyEqual >::highestBit(const std::uint64_t value) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - static_cast< std::size_t >(__builtin_clzll(value));
+#else
+    std::size_t bit = 0;
+    while (value >> (bit + 1))
+    {
+      ++bit;
+    }
+    return bit;
+#endif
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  std::size_t ExpiringMap< Key, Value, Hash, KeyEqual >::lowestBit(const std::uint64_t value) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast< std::size_t >(__builtin_ctzll(value));
+#else
+    std::size_t bit = 0;
+    while (!((value >> bit) & 1))
+    {
+      ++bit;
+    }
+    return bit;
+#endif
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  void ExpiringMap< Key, Value, Hash, KeyEqual >::schedule(Node* node) noexcept
+  {
+    if (node->deadline_ <= current_)
+    {
+      node->linkBefore(&due_);
+      return;
+    }
+    const std::size_t level = highestBit(node->deadline_ ^ current_) / SLOT_BITS;
+    if (level >= LEVELS)
+    {
+      node->linkBefore(&overflow_);
+      return;
+    }
+    const std::size_t slot = slotOf(node->deadline_, level);
+    node->linkBefore(&wheel_[level][slot]);
+    occupied_[level] |= std::uint64_t{ 1 } << slot;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  void ExpiringMap< Key, Value, Hash, KeyEqual >::unschedule(Node* node) noexcept
+  {
+    TimerLinks* next = node->next_;
+    node->unlink();
+    if (!next->empty() || next == &due_ || next == &overflow_)
+    {
+      return;
+    }
+    for (std::size_t level = 0; level < LEVELS; ++level)
+    {
+      const std::less< const TimerLinks* > before;
+      if (!before(next, wheel_[level]) && before(next, wheel_[level] + SLOTS))
+      {
+        occupied_[level] &= ~(std::uint64_t{ 1 } << (next - wheel_[level]));
+        return;
+      }
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  bool ExpiringMap< Key, Value, Hash, KeyEqual >::nextEvent(time_type& event, std::size_t& level) const noexcept
+  {
+    bool found = false;
+    for (std::size_t candidate = 0; candidate < LEVELS; ++candidate)
+    {
+      const std::size_t shift = candidate * SLOT_BITS;
+      const std::size_t digit = slotOf(current_, candidate);
+      const std::uint64_t later = (digit + 1 < SLOTS) ? occupied_[candidate] & (~std::uint64_t{ 0 } << (digit + 1)) : 0;
+      if (!later)
+      {
+        continue;
+      }
+      const time_type block = (shift + SLOT_BITS < 64) ? (current_ >> (shift + SLOT_BITS)) << (shift + SLOT_BITS) : 0;
+      const time_type time = block | (static_cast< time_type >(lowestBit(later)) << shift);
+      if (!found || time < event)
+      {
+        event = time;
+        level = candidate;
+        found = true;
+      }
+    }
+    if (!overflow_.empty())
+    {
+      const std::size_t shift = LEVELS * SLOT_BITS;
+      const time_type time = ((current_ >> shift) + 1) << shift;
+      if (!found || time < event)
+      {
+        event = time;
+        level = LEVELS;
+        found = true;
+      }
+    }
+    return found;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  void ExpiringMap< Key, Value, Hash, KeyEqual >::cascade(TimerLinks& list) noexcept
+  {
+    TimerLinks pending;
+    while (!list.empty())
+    {
+      TimerLinks* node = list.next_;
+      node->unlink();
+      node->linkBefore(&pending);
+    }
+    while (!pending.empty())
+    {
+      Node* node = static_cast< Node* >(pending.next_);
+      node->unlink();
+      schedule(node);
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class OnExpire >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::expireDue(OnExpire& onExpire) -> size_type
+  {
+    size_type expired = 0;
+    while (!due_.empty())
+    {
+      Node* node = static_cast< Node* >(due_.next_);
+      onExpire(static_cast< const Key& >(node->data_.first), node->data_.second);
+      remove(node);
+      ++expired;
+    }
+    return expired;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::advance(const time_type now) -> size_type
+  {
+    return advance(now, NoExpireCallback());
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class OnExpire >
+  auto ExpiringMap< Key, Value, Hash, KeyEqual >::advance(const time_type now, OnExpire onExpire) -> size_type
+  {
+    size_type expired = expireDue(onExpire);
+    time_type event = 0;
+    std::size_t level = 0;
+    while (current_ < now && nextEvent(event, level) && event <= now)
+    {
+      current_ = event;
+      if (level == LEVELS)
+      {
+        cascade(overflow_);
+      }
+      else
+      {
+        const std::size_t slot = slotOf(event, level);
+        occupied_[level] &= ~(std::uint64_t{ 1 } << slot);
+        cascade(wheel_[level][slot]);
+      }
+      expired += expireDue(onExpire);
+    }
+    current_ = std::max(current_, now);
+    return expired;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  const Hash& ExpiringMap< Key, Value, Hash, KeyEqual >::hashFunction() const noexcept
+  {
+    return this->hasher_base_t::get();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  const KeyEqual& ExpiringMap< Key, Value, Hash, KeyEqual >::keyEqual() const noexcept
+  {
+    return this->key_equal_base_t::get();
+  }
+}
+#endif
@@ -0,0 +1,47 @@
+#ifndef FWD_LIST_H
+#define FWD_LIST_H
+#include <utility>
+#include "unique_ptr.h"
+
+namespace ohantsev
+{
+  template< class T >
+  struct FwdListNode
+  {
+    T data_;
+    UniquePtr< FwdListNode > next_;
+
+    template< class U >
+    FwdListNode(U&& data, UniquePtr< FwdListNode >&& next);
+    template< class... Args >
+    explicit FwdListNode(std::in_place_t, Args&&... args);
+    FwdListNode(FwdListNode&&) = default;
+    FwdListNode& operator=(FwdListNode&&) = default;
+    ~FwdListNode();
+  };
+
+  template< class T >
+  template< class U >
+  FwdListNode< T >::FwdListNode(U&& data, UniquePtr< FwdListNode >&& next):
+    data_(std::forward< U >(data)),
+    next_(std::move(next))
+  {}
+
+  template< class T >
+  template< class... Args >
+  FwdListNode< T >::FwdListNode(std::in_place_t, Args&&... args):
+    data_(std::forward< Args >(args)...),
+    next_()
+  {}
+
+  template< class T >
+  FwdListNode< T >::~FwdListNode()
+  {
+    while (next_)
+    {
+      UniquePtr< FwdListNode > rest = std::move(next_->next_);
+      next_ = std::move(rest);
+    }
+  }
+}
+#endif
@@ -5,7 +5,18 @@
 #include <iostream>
 #include <cassert>
 #include <algorithm>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <thread>
+#include <vector>
 #include "HashIterator.h"
+#include "ebo_storage.h"
+#include "hash_stats.h"
+#include "inline_pool.h"
+#include "parallel_for.h"
+#include "perfect_hash.h"
+#include "seeded_hash.h"
 
 template <class T>
 struct FwdListNode;
@@ -14,9 +25,12 @@ template
 <
   class Key,
   class Hash = std::hash<Key>,
-  class KeyEqual = std::equal_to<Key>
+  class KeyEqual = std::equal_to<Key>,
+  class Stats = ohantsev::NoHashStats
 >
-class HashSet
+class HashSet : private Stats,
+  private ohantsev::EboStorage<Hash, ohantsev::HasherTag>,
+  private ohantsev::EboStorage<KeyEqual, ohantsev::KeyEqualTag>
 {
 public:
   using iterator = HashIterator<Key>;
@@ -24,7 +38,13 @@ public:
   using node_t = FwdListNode<Key>;
   using this_t = HashSet;
 
-  explicit HashSet(std::size_t capacity = 100);
+  static constexpr std::size_t SMALL_SIZE{ 8 };
+  static constexpr std::size_t SMALL_CAPACITY{ std::is_nothrow_move_constructible<Key>::value ? SMALL_SIZE : 0 };
+  static constexpr std::size_t MAX_CHAIN_LENGTH{ 16 };
+
+  HashSet() = default;
+  explicit HashSet(std::size_t capacity, const Hash& hasher = Hash(), const KeyEqual& equal = KeyEqual());
+  explicit HashSet(const Hash& hasher, const KeyEqual& equal = KeyEqual());
   ~HashSet();
   HashSet(const this_t& rhs);
   this_t& operator=(const this_t& rhs);
@@ -34,6 +54,7 @@ public:
   double loadFactor() const noexcept;
   void rehash();
   void reserve(std::size_t capacity);
+  void shrinkToFit();
   bool insert(const Key& key);
   bool remove(const Key& key);
   iterator find(const Key& key) const;
@@ -42,18 +63,50 @@ public:
   iterator begin() const noexcept;
   iterator end() const noexcept;
   void clear() noexcept;
+  ohantsev::HashStatsSnapshot stats() const;
+  const Hash& hashFunction() const noexcept;
+  const KeyEqual& keyEqual() const noexcept;
+  ohantsev::FrozenHashSet<Key, Hash, KeyEqual> freeze() const;
+  template <class Op>
+  void parallelForEach(Op op, std::size_t threads = std::thread::hardware_concurrency()) const;
+  template <class Pred>
+  std::size_t parallelEraseIf(Pred pred, std::size_t threads = std::thread::hardware_concurrency());
+  template <class T, class Transform, class Combine>
+  T parallelReduce(T init, Transform transform, Combine combine,
+    std::size_t threads = std::thread::hardware_concurrency()) const;
 
 private:
+  using hasher_base_t = ohantsev::EboStorage<Hash, ohantsev::HasherTag>;
+  using key_equal_base_t = ohantsev::EboStorage<KeyEqual, ohantsev::KeyEqualTag>;
+
   std::size_t size_{ 0 };
-  std::size_t bucket_count_;
-  node_t** set_;
+  std::size_t bucket_count_{ 1 };
+  node_t* inline_{ nullptr };
+  node_t** set_{ &inline_ };
+  ohantsev::InlinePool<node_t, SMALL_CAPACITY> small_;
+  ohantsev::BucketBitmap occupied_{ 1 };
+  std::size_t lastReseedSize_{ 0 };
+  std::size_t reserved_{ 0 };
   static constexpr double MAX_LOAD_FACTOR{ 0.7 };
+  static constexpr double MIN_LOAD_FACTOR{ 0.1 };
   static constexpr double EXPANSION_COEFFICIENT{ 2.0 };
+  static constexpr std::size_t PARALLEL_CHUNK{ 1024 };
 
+  bool isSmall() const noexcept;
   void swap(this_t& rhs) noexcept;
+  template <class K>
+  node_t* createNode(K&& key, node_t* next);
+  void destroyNode(node_t* node) noexcept;
+  void relinkInline() noexcept;
   std::size_t hash(const Key& key) const;
   void copyFrom(const this_t& source, std::size_t newSize_);
+  void relink(std::size_t capacity);
+  std::size_t targetCapacity() const noexcept;
+  void shrinkIfSparse();
+  void watchChain(std::size_t bucket);
   void removeContainer() noexcept;
+  const Stats& statsPolicy() const noexcept;
+  void resyncOccupied() noexcept;
 };
 
 template <class T>
@@ -65,70 +118,131 @@ struct FwdListNode
     data_(data),
     next_(next)
   {}
+  FwdListNode(T&& data, FwdListNode* next = nullptr) :
+    data_(std::move(data)),
+    next_(next)
+  {}
 };
 
-template <class Key, class Hash, class KeyEqual>
-std::size_t HashSet<Key, Hash, KeyEqual>::size() const noexcept
+template <class Key, class Hash, class KeyEqual, class Stats>
+std::size_t HashSet<Key, Hash, KeyEqual, Stats>::size() const noexcept
 {
   return size_;
 }
 
-template <class Key, class Hash, class KeyEqual>
-HashSet<Key, Hash, KeyEqual>::HashSet(std::size_t capacity)
+template <class Key, class Hash, class KeyEqual, class Stats>
+HashSet<Key, Hash, KeyEqual, Stats>::HashSet(std::size_t capacity, const Hash& hasher, const KeyEqual& equal):
+  hasher_base_t(hasher),
+  key_equal_base_t(equal)
 {
   if (capacity == 0)
   {
     throw std::invalid_argument("Invalid capacyty_");
   }
   bucket_count_ = static_cast<std::size_t>(capacity / MAX_LOAD_FACTOR) + 1;
-  set_ = new node_t*[bucket_count_] {};  
+  ohantsev::BucketBitmap occupied(bucket_count_);
+  set_ = new node_t*[bucket_count_] {};
+  occupied_.swap(occupied);
+  reserved_ = capacity;
+  statsPolicy().onAllocate();
 }
 
-template <class Key, class Hash, class KeyEqual>
-void HashSet<Key, Hash, KeyEqual>::clear() noexcept
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::clear() noexcept
 {
-  for (std::size_t i = 0; i < bucket_count_; ++i)
+  for (std::size_t i = occupied_.findFirst(); i < bucket_count_; i = occupied_.findNext(i + 1))
   {
     node_t* cur = set_[i];
     while (cur)
     {
       node_t* next = cur->next_;
-      delete cur;
+      destroyNode(cur);
       cur = next;
     }
     set_[i] = nullptr;
   }
+  occupied_.clear();
   size_ = 0;
+  statsPolicy().onClear();
 }
 
-template <class Key, class Hash, class KeyEqual>
-void HashSet<Key, Hash, KeyEqual>::removeContainer() noexcept
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::removeContainer() noexcept
 {
   clear();
-  delete[] set_;
-  set_ = nullptr;
-  bucket_count_ = 0;
+  if (!isSmall())
+  {
+    delete[] set_;
+  }
+  set_ = &inline_;
+  occupied_ = ohantsev::BucketBitmap(1);
+  bucket_count_ = 1;
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+bool HashSet<Key, Hash, KeyEqual, Stats>::isSmall() const noexcept
+{
+  return set_ == &inline_;
 }
 
-template <class Key, class Hash, class KeyEqual>
-HashSet<Key, Hash, KeyEqual>::~HashSet()
+template <class Key, class Hash, class KeyEqual, class Stats>
+template <class K>
+auto HashSet<Key, Hash, KeyEqual, Stats>::createNode(K&& key, node_t* next) -> node_t*
+{
+  if (isSmall())
+  {
+    return small_.create(std::forward<K>(key), next);
+  }
+  return new node_t(std::forward<K>(key), next);
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::destroyNode(node_t* node) noexcept
+{
+  if (small_.owns(node))
+  {
+    small_.destroy(node);
+  }
+  else
+  {
+    delete node;
+  }
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::relinkInline() noexcept
+{
+  inline_ = nullptr;
+  for (std::size_t slot = small_.findFirst(); slot < SMALL_CAPACITY; slot = small_.findNext(slot + 1))
+  {
+    node_t* node = small_.at(slot);
+    node->next_ = inline_;
+    inline_ = node;
+  }
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+HashSet<Key, Hash, KeyEqual, Stats>::~HashSet()
 {
   removeContainer();
 }
 
-template <class Key, class Hash, class KeyEqual>
-HashSet<Key, Hash, KeyEqual>::HashSet(this_t&& rhs) noexcept:
-  size_(rhs.size_),
-  bucket_count_(rhs.bucket_count_),
-  set_(rhs.set_)
+template <class Key, class Hash, class KeyEqual, class Stats>
+HashSet<Key, Hash, KeyEqual, Stats>::HashSet(const Hash& hasher, const KeyEqual& equal):
+  hasher_base_t(hasher),
+  key_equal_base_t(equal)
+{}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+HashSet<Key, Hash, KeyEqual, Stats>::HashSet(this_t&& rhs) noexcept:
+  hasher_base_t(rhs.hashFunction()),
+  key_equal_base_t(rhs.keyEqual())
 {
-  rhs.set_ = nullptr;
-  rhs.bucket_count_ = 0;
-  rhs.size_ = 0;
+  swap(rhs);
 }
 
-template <class Key, class Hash, class KeyEqual>
-auto HashSet<Key, Hash, KeyEqual>::operator=(this_t&& rhs) noexcept -> this_t&
+template <class Key, class Hash, class KeyEqual, class Stats>
+auto HashSet<Key, Hash, KeyEqual, Stats>::operator=(this_t&& rhs) noexcept -> this_t&
 {
   if (this != &rhs)
   {
@@ -139,37 +253,69 @@ auto HashSet<Key, Hash, KeyEqual>::operator=(this_t&& rhs) noexcept -> this_t&
   return (*this);
 }
 
-template <class Key, class Hash, class KeyEqual>
-void HashSet<Key, Hash, KeyEqual>::copyFrom(const this_t& source, std::size_t newSize_)
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::copyFrom(const this_t& source, std::size_t newSize_)
 {
-  this_t tmp(newSize_);
+  auto start = statsPolicy().resizeStarted();
+  this_t tmp = (newSize_ <= SMALL_CAPACITY) ? this_t(source.hashFunction(), source.keyEqual())
+    : this_t(newSize_, source.hashFunction(), source.keyEqual());
+  std::size_t occupied = 0;
   for (const auto& x: source)
   {
     auto bucket = tmp.hash(x);
-    tmp.set_[bucket] = new node_t(x, tmp.set_[bucket]);
+    if (!tmp.set_[bucket])
+    {
+      ++occupied;
+      tmp.occupied_.set(bucket);
+    }
+    tmp.set_[bucket] = tmp.createNode(x, tmp.set_[bucket]);
     ++tmp.size_;
   }
+  tmp.reserved_ = source.reserved_;
+  if (!tmp.isSmall())
+  {
+    statsPolicy().onAllocate(tmp.size_ + 1);
+  }
   (*this) = std::move(tmp);
+  statsPolicy().resizeFinished(start, occupied);
 }
 
-template <class Key, class Hash, class KeyEqual>
-HashSet<Key, Hash, KeyEqual>::HashSet(const this_t& rhs):
-  set_(nullptr),
-  bucket_count_(0)
+template <class Key, class Hash, class KeyEqual, class Stats>
+HashSet<Key, Hash, KeyEqual, Stats>::HashSet(const this_t& rhs):
+  hasher_base_t(rhs.hashFunction()),
+  key_equal_base_t(rhs.keyEqual())
 {
   copyFrom(rhs, rhs.size_);
 }
 
-template <class Key, class Hash, class KeyEqual>
-void HashSet<Key, Hash, KeyEqual>::swap(this_t& rhs) noexcept
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::swap(this_t& rhs) noexcept
 {
+  const bool small = isSmall();
+  const bool rhsSmall = rhs.isSmall();
   std::swap(size_, rhs.size_);
   std::swap(bucket_count_, rhs.bucket_count_);
   std::swap(set_, rhs.set_);
+  small_.swap(rhs.small_);
+  occupied_.swap(rhs.occupied_);
+  std::swap(this->hasher_base_t::get(), rhs.hasher_base_t::get());
+  std::swap(this->key_equal_base_t::get(), rhs.key_equal_base_t::get());
+  std::swap(lastReseedSize_, rhs.lastReseedSize_);
+  std::swap(reserved_, rhs.reserved_);
+  if (rhsSmall)
+  {
+    set_ = &inline_;
+  }
+  if (small)
+  {
+    rhs.set_ = &rhs.inline_;
+  }
+  relinkInline();
+  rhs.relinkInline();
 }
 
-template <class Key, class Hash, class KeyEqual>
-auto HashSet<Key, Hash, KeyEqual>::operator=(const this_t& rhs) -> this_t&
+template <class Key, class Hash, class KeyEqual, class Stats>
+auto HashSet<Key, Hash, KeyEqual, Stats>::operator=(const this_t& rhs) -> this_t&
 {
   if (this != &rhs)
   {
@@ -179,35 +325,139 @@ auto HashSet<Key, Hash, KeyEqual>::operator=(const this_t& rhs) -> this_t&
   return *this;
 }
 
-template <class Key, class Hash, class KeyEqual>
-double HashSet<Key, Hash, KeyEqual>::loadFactor() const noexcept
+template <class Key, class Hash, class KeyEqual, class Stats>
+double HashSet<Key, Hash, KeyEqual, Stats>::loadFactor() const noexcept
 {
   assert(bucket_count_ != 0);
   return static_cast<double>(size_) / bucket_count_;
 }
 
-template <class Key, class Hash, class KeyEqual>
-void HashSet<Key, Hash, KeyEqual>::rehash()
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::rehash()
 {
-  copyFrom(*this, static_cast<std::size_t>(bucket_count_ * MAX_LOAD_FACTOR));
+  relink(targetCapacity());
 }
 
-template <class Key, class Hash, class KeyEqual>
-void HashSet<Key, Hash, KeyEqual>::reserve(std::size_t capacity)
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::reserve(std::size_t capacity)
 {
+  reserved_ = std::max(reserved_, capacity);
   if (capacity > size_)
   {
-    copyFrom(*this, capacity);
+    relink(capacity);
   }
 }
 
-template <class Key, class Hash, class KeyEqual>
-bool HashSet<Key, Hash, KeyEqual>::insert(const Key& key)
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::relink(std::size_t capacity)
+{
+  assert(capacity >= size_);
+  if (isSmall() && capacity <= SMALL_CAPACITY)
+  {
+    return;
+  }
+  auto start = statsPolicy().resizeStarted();
+  this_t tmp = (capacity <= SMALL_CAPACITY) ? this_t(hashFunction(), keyEqual())
+    : this_t(capacity, hashFunction(), keyEqual());
+  std::size_t occupied = 0;
+  std::size_t migrated = 0;
+  try
+  {
+    for (std::size_t i = occupied_.findFirst(); i < bucket_count_; i = occupied_.findNext(i + 1))
+    {
+      while (set_[i])
+      {
+        node_t* current = set_[i];
+        node_t* moved = current;
+        auto bucket = tmp.hash(current->data_);
+        if constexpr (SMALL_CAPACITY > 0)
+        {
+          if (tmp.isSmall() || isSmall())
+          {
+            moved = tmp.createNode(std::move(current->data_), nullptr);
+            migrated += !tmp.isSmall();
+          }
+        }
+        set_[i] = current->next_;
+        if (moved != current)
+        {
+          destroyNode(current);
+        }
+        if (!tmp.set_[bucket])
+        {
+          ++occupied;
+          tmp.occupied_.set(bucket);
+        }
+        moved->next_ = tmp.set_[bucket];
+        tmp.set_[bucket] = moved;
+      }
+    }
+  }
+  catch (...)
+  {
+    if constexpr (SMALL_CAPACITY > 0)
+    {
+      for (std::size_t i = tmp.occupied_.findFirst(); isSmall() && i < tmp.bucket_count_;
+        i = tmp.occupied_.findNext(i + 1))
+      {
+        for (node_t* current = tmp.set_[i]; current; current = current->next_)
+        {
+          inline_ = small_.create(std::move(current->data_), inline_);
+        }
+      }
+    }
+    throw;
+  }
+  tmp.size_ = size_;
+  tmp.reserved_ = reserved_;
+  if (!tmp.isSmall())
+  {
+    statsPolicy().onAllocate(migrated + 1);
+  }
+  removeContainer();
+  swap(tmp);
+  statsPolicy().resizeFinished(start, occupied);
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+std::size_t HashSet<Key, Hash, KeyEqual, Stats>::targetCapacity() const noexcept
+{
+  return std::max(size_ * static_cast<std::size_t>(EXPANSION_COEFFICIENT), reserved_);
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::shrinkIfSparse()
+{
+  if (isSmall() || loadFactor() >= MIN_LOAD_FACTOR)
+  {
+    return;
+  }
+  const std::size_t capacity = std::max(targetCapacity(), SMALL_CAPACITY + 1);
+  if (static_cast<std::size_t>(capacity / MAX_LOAD_FACTOR) + 1 >= bucket_count_)
+  {
+    return;
+  }
+  try
+  {
+    relink(capacity);
+  }
+  catch (const std::bad_alloc&)
+  {}
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::shrinkToFit()
+{
+  reserved_ = 0;
+  relink(size_);
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+bool HashSet<Key, Hash, KeyEqual, Stats>::insert(const Key& key)
 { 
   auto bucket = hash(key);
   auto current = set_[bucket];
-  KeyEqual keyEqual;
-  while (current && !keyEqual(current->data_, key))
+  while (current && !keyEqual()(current->data_, key))
   {
     current = current->next_;
   }
@@ -215,96 +465,314 @@ bool HashSet<Key, Hash, KeyEqual>::insert(const Key& key)
   {
     return false;
   }
-  if (loadFactor() >= MAX_LOAD_FACTOR)
+  if (isSmall() ? size_ >= SMALL_CAPACITY : loadFactor() >= MAX_LOAD_FACTOR)
   {
-    copyFrom(*this, size_ * static_cast<std::size_t>(EXPANSION_COEFFICIENT));
+    relink(std::max(targetCapacity(), SMALL_CAPACITY + 1));
     bucket = hash(key);
   }
-  set_[bucket] = new node_t(key, set_[bucket]);
+  if (!set_[bucket])
+  {
+    occupied_.set(bucket);
+    statsPolicy().onBucketFilled();
+  }
+  set_[bucket] = createNode(key, set_[bucket]);
+  if (!isSmall())
+  {
+    statsPolicy().onAllocate();
+  }
   ++size_;
+  watchChain(bucket);
   return true;
 }
 
-template <class Key, class Hash, class KeyEqual>
-auto HashSet<Key, Hash, KeyEqual>::cbegin() const noexcept -> const_iterator
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::watchChain(std::size_t bucket)
 {
-  auto firstNode = set_;
-  while ((firstNode != set_ + bucket_count_) && !(*firstNode))
+  if constexpr (ohantsev::IsReseedable<Hash>::value)
   {
-    ++firstNode;
+    if (isSmall() || size_ < 2 * lastReseedSize_)
+    {
+      return;
+    }
+    std::size_t length = 0;
+    for (node_t* current = set_[bucket]; current; current = current->next_)
+    {
+      ++length;
+    }
+    if (length <= MAX_CHAIN_LENGTH)
+    {
+      return;
+    }
+    const Hash previous = hashFunction();
+    this->hasher_base_t::get().reseed();
+    try
+    {
+      relink(targetCapacity());
+    }
+    catch (const std::bad_alloc&)
+    {
+      this->hasher_base_t::get() = previous;
+      return;
+    }
+    lastReseedSize_ = size_;
   }
-  if (firstNode == set_ + bucket_count_)
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+auto HashSet<Key, Hash, KeyEqual, Stats>::cbegin() const noexcept -> const_iterator
+{
+  const std::size_t bucket = occupied_.findFirst();
+  if (bucket == bucket_count_)
   {
-    return const_iterator(firstNode, nullptr, set_ + bucket_count_);
+    return cend();
   }
-  return const_iterator(firstNode, *firstNode, set_ + bucket_count_);
+  return const_iterator(set_, bucket, set_[bucket], &occupied_);
 }
 
-template <class Key, class Hash, class KeyEqual>
-auto HashSet<Key, Hash, KeyEqual>::cend() const noexcept -> const_iterator
+template <class Key, class Hash, class KeyEqual, class Stats>
+auto HashSet<Key, Hash, KeyEqual, Stats>::cend() const noexcept -> const_iterator
 {
-  return const_iterator(set_ + bucket_count_, nullptr, set_ + bucket_count_);
+  return const_iterator(set_, bucket_count_, nullptr, &occupied_);
 }
 
-template <class Key, class Hash, class KeyEqual>
-auto HashSet<Key, Hash, KeyEqual>::begin() const noexcept -> iterator
+template <class Key, class Hash, class KeyEqual, class Stats>
+auto HashSet<Key, Hash, KeyEqual, Stats>::begin() const noexcept -> iterator
 {
   return cbegin();
 }
 
-template <class Key, class Hash, class KeyEqual>
-auto HashSet<Key, Hash, KeyEqual>::end() const noexcept -> iterator
+template <class Key, class Hash, class KeyEqual, class Stats>
+auto HashSet<Key, Hash, KeyEqual, Stats>::end() const noexcept -> iterator
 {
   return cend();
 }
 
-template <class Key, class Hash, class KeyEqual>
-auto HashSet<Key, Hash, KeyEqual>::find(const Key& key)  const -> iterator
+template <class Key, class Hash, class KeyEqual, class Stats>
+auto HashSet<Key, Hash, KeyEqual, Stats>::find(const Key& key)  const -> iterator
 {
   auto bucket = hash(key);
   auto current = set_[bucket];
-  KeyEqual keyEqual;
-  while (current && !keyEqual(current->data_, key))
+  std::size_t probes = current != nullptr;
+  while (current && !keyEqual()(current->data_, key))
   {
     current = current->next_;
+    probes += current != nullptr;
   }
+  statsPolicy().onFind(probes);
   if (current)
   {
-    return iterator(set_ + bucket, current, set_ + bucket_count_);
+    return iterator(set_, bucket, current, &occupied_);
   }
   return end();
 }
 
-template <class Key, class Hash, class KeyEqual>
-std::size_t HashSet<Key, Hash, KeyEqual>::hash(const Key& key) const
+template <class Key, class Hash, class KeyEqual, class Stats>
+std::size_t HashSet<Key, Hash, KeyEqual, Stats>::hash(const Key& key) const
 {
-  return Hash{}(key) % bucket_count_;
+  if (isSmall())
+  {
+    return 0;
+  }
+  return hashFunction()(key) % bucket_count_;
 }
 
-template <class Key, class Hash, class KeyEqual>
-bool HashSet<Key, Hash, KeyEqual>::remove(const Key& key)
+template <class Key, class Hash, class KeyEqual, class Stats>
+bool HashSet<Key, Hash, KeyEqual, Stats>::remove(const Key& key)
 {
   auto bucket = hash(key);
   auto current = set_[bucket];
-  if (current && KeyEqual{}(current->data_, key))
+  if (current && keyEqual()(current->data_, key))
   {
     set_[bucket] = current->next_;
-    delete current;
+    destroyNode(current);
     --size_;
+    if (!set_[bucket])
+    {
+      occupied_.reset(bucket);
+      statsPolicy().onBucketEmptied();
+    }
+    shrinkIfSparse();
     return true;
   }
-  while (current && current->data_ != key)
+  while (current)
   {
     auto next = current->next_;
-    if (next && next->data_ == key)
+    if (next && keyEqual()(next->data_, key))
     {
       current->next_ = next->next_;
-      delete next;
+      destroyNode(next);
       --size_;
+      shrinkIfSparse();
       return true;
     }
     current = next;
   }
   return false;
 }
+template <class Key, class Hash, class KeyEqual, class Stats>
+ohantsev::HashStatsSnapshot HashSet<Key, Hash, KeyEqual, Stats>::stats() const
+{
+  ohantsev::HashStatsSnapshot snapshot = statsPolicy().snapshot();
+  snapshot.chainHistogram[0] = bucket_count_ - occupied_.count();
+  for (std::size_t i = occupied_.findFirst(); i < bucket_count_; i = occupied_.findNext(i + 1))
+  {
+    std::size_t length = 0;
+    for (node_t* current = set_[i]; current; current = current->next_)
+    {
+      ++length;
+    }
+    ++snapshot.chainHistogram[ohantsev::HashStatsSnapshot::histogramSlot(length)];
+  }
+  return snapshot;
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+ohantsev::FrozenHashSet<Key, Hash, KeyEqual> HashSet<Key, Hash, KeyEqual, Stats>::freeze() const
+{
+  return ohantsev::FrozenHashSet<Key, Hash, KeyEqual>(cbegin(), cend(), hashFunction(), keyEqual());
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+const Hash& HashSet<Key, Hash, KeyEqual, Stats>::hashFunction() const noexcept
+{
+  return this->hasher_base_t::get();
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+const KeyEqual& HashSet<Key, Hash, KeyEqual, Stats>::keyEqual() const noexcept
+{
+  return this->key_equal_base_t::get();
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+const Stats& HashSet<Key, Hash, KeyEqual, Stats>::statsPolicy() const noexcept
+{
+  return *this;
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+template <class Op>
+void HashSet<Key, Hash, KeyEqual, Stats>::parallelForEach(Op op, std::size_t threads) const
+{
+  ohantsev::parallelForChunks(bucket_count_, PARALLEL_CHUNK, threads,
+    [&](std::size_t first, std::size_t last, std::size_t)
+    {
+      for (std::size_t i = occupied_.findNext(first); i < last; i = occupied_.findNext(i + 1))
+      {
+        for (const node_t* current = set_[i]; current; current = current->next_)
+        {
+          op(current->data_);
+        }
+      }
+    });
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+template <class Pred>
+std::size_t HashSet<Key, Hash, KeyEqual, Stats>::parallelEraseIf(Pred pred, std::size_t threads)
+{
+  const std::size_t workers = ohantsev::parallelWorkers(threads, ohantsev::parallelChunks(bucket_count_, PARALLEL_CHUNK));
+  std::vector<std::size_t> erased(workers);
+  std::vector<std::vector<std::size_t>> emptied(workers);
+  try
+  {
+    ohantsev::parallelForChunks(bucket_count_, PARALLEL_CHUNK, workers,
+      [&](std::size_t first, std::size_t last, std::size_t worker)
+      {
+        for (std::size_t i = occupied_.findNext(first); i < last; i = occupied_.findNext(i + 1))
+        {
+          node_t** link = &set_[i];
+          while (*link)
+          {
+            node_t* current = *link;
+            if (pred(static_cast<const Key&>(current->data_)))
+            {
+              *link = current->next_;
+              destroyNode(current);
+              ++erased[worker];
+            }
+            else
+            {
+              link = &current->next_;
+            }
+          }
+          if (!set_[i])
+          {
+            emptied[worker].push_back(i);
+          }
+        }
+      });
+  }
+  catch (...)
+  {
+    for (std::size_t count: erased)
+    {
+      size_ -= count;
+    }
+    resyncOccupied();
+    throw;
+  }
+  std::size_t total = 0;
+  for (std::size_t worker = 0; worker < workers; ++worker)
+  {
+    total += erased[worker];
+    for (std::size_t i: emptied[worker])
+    {
+      occupied_.reset(i);
+      statsPolicy().onBucketEmptied();
+    }
+  }
+  size_ -= total;
+  shrinkIfSparse();
+  return total;
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+template <class T, class Transform, class Combine>
+T HashSet<Key, Hash, KeyEqual, Stats>::parallelReduce(T init, Transform transform, Combine combine,
+  std::size_t threads) const
+{
+  const std::size_t workers = ohantsev::parallelWorkers(threads, ohantsev::parallelChunks(bucket_count_, PARALLEL_CHUNK));
+  std::vector<std::optional<T>> partial(workers);
+  ohantsev::parallelForChunks(bucket_count_, PARALLEL_CHUNK, workers,
+    [&](std::size_t first, std::size_t last, std::size_t worker)
+    {
+      std::optional<T>& result = partial[worker];
+      for (std::size_t i = occupied_.findNext(first); i < last; i = occupied_.findNext(i + 1))
+      {
+        for (const node_t* current = set_[i]; current; current = current->next_)
+        {
+          if (result)
+          {
+            result = combine(std::move(*result), transform(current->data_));
+          }
+          else
+          {
+            result.emplace(transform(current->data_));
+          }
+        }
+      }
+    });
+  for (std::optional<T>& result: partial)
+  {
+    if (result)
+    {
+      init = combine(std::move(init), std::move(*result));
+    }
+  }
+  return init;
+}
+
+template <class Key, class Hash, class KeyEqual, class Stats>
+void HashSet<Key, Hash, KeyEqual, Stats>::resyncOccupied() noexcept
+{
+  for (std::size_t i = occupied_.findFirst(); i < bucket_count_; i = occupied_.findNext(i + 1))
+  {
+    if (!set_[i])
+    {
+      occupied_.reset(i);
+      statsPolicy().onBucketEmptied();
+    }
+  }
+}
 #endif
@@ -1,17 +1,33 @@
 #ifndef HASH_MAP_H
 #define HASH_MAP_H
+#include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <new>
+#include <optional>
 #include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "bucket_bitmap.h"
+#include "ebo_storage.h"
 #include "fwd_list.h"
+#include "hash_stats.h"
+#include "inline_pool.h"
+#include "parallel_for.h"
+#include "perfect_hash.h"
+#include "seeded_hash.h"
 #include "unique_ptr.h"
 
 namespace ohantsev
 {
   template< class Key, class Value,
     class Hash = std::hash< Key >,
-    class KeyEqual = std::equal_to< Key > >
-  class HashMap
+    class KeyEqual = std::equal_to< Key >,
+    class Stats = NoHashStats >
+  class HashMap: private Stats, private EboStorage< Hash, HasherTag >, private EboStorage< KeyEqual, KeyEqualTag >
   {
   public:
     using key_type = Key;
@@ -26,10 +42,24 @@ namespace ohantsev
     using iterator = HashMapIterator< false >;
     using const_iterator = HashMapIterator< true >;
 
+    class NodeHandle;
+    using node_type = NodeHandle;
+
     static constexpr double MAX_LOAD_FACTOR{ 0.7 };
+    static constexpr double MIN_LOAD_FACTOR{ 0.1 };
     static constexpr double EXPANSION_COEFFICIENT{ 2.0 };
+    static constexpr size_type PARALLEL_CHUNK{ 1024 };
+    static constexpr size_type SMALL_SIZE{ 8 };
+    static constexpr size_type SMALL_CAPACITY{ std::is_nothrow_move_constructible< value_type >::value ? SMALL_SIZE : 0 };
+    static constexpr size_type MAX_CHAIN_LENGTH{ 16 };
 
-    explicit HashMap(size_type = 10);
+    HashMap() = default;
+    explicit HashMap(size_type capacity, const Hash& hasher = Hash(), const KeyEqual& equal = KeyEqual());
+    explicit HashMap(const Hash& hasher, const KeyEqual& equal = KeyEqual());
+    template< class ForwardIt, class = std::enable_if_t< std::is_base_of< std::forward_iterator_tag,
+      typename std::iterator_traits< ForwardIt >::iterator_category >::value > >
+    HashMap(ForwardIt first, ForwardIt last, size_type threads = 1,
+      const Hash& hasher = Hash(), const KeyEqual& equal = KeyEqual());
     ~HashMap();
     HashMap(const this_t& rhs);
     this_t& operator=(const this_t& rhs);
@@ -39,14 +69,31 @@ namespace ohantsev
     bool empty() const noexcept;
     double loadFactor() const noexcept;
     void rehash();
+    void parallelRehash(size_type threads = std::thread::hardware_concurrency());
     void reserve(std::size_t capacity);
+    void shrinkToFit();
     template< class Pair >
     std::pair< iterator, bool > insert(Pair&& pair);
+    std::pair< iterator, bool > insert(node_type&& node);
     template< class K, class V >
     std::pair< iterator, bool > emplace(K&& key, V&& value);
+    template< class... Args >
+    std::pair< iterator, bool > tryEmplace(const Key& key, Args&&... args);
+    template< class... Args >
+    std::pair< iterator, bool > tryEmplace(Key&& key, Args&&... args);
+    template< class M >
+    std::pair< iterator, bool > insertOrAssign(const Key& key, M&& obj);
+    template< class M >
+    std::pair< iterator, bool > insertOrAssign(Key&& key, M&& obj);
     bool erase(const Key& key);
     bool erase(const iterator& iter);
     bool erase(const const_iterator& iter);
+    template< class Pred >
+    size_type eraseIf(Pred pred);
+    node_type extract(const Key& key);
+    node_type extract(const iterator& iter);
+    node_type extract(const const_iterator& iter);
+    void merge(this_t& source);
     void clear() noexcept;
     const mapped_type& operator[](const Key& key) const;
     const mapped_type& at(const Key& key) const;
@@ -60,24 +107,74 @@ namespace ohantsev
     iterator end() noexcept;
     const_iterator begin() const noexcept;
     const_iterator end() const noexcept;
+    const Hash& hashFunction() const noexcept;
+    const KeyEqual& keyEqual() const noexcept;
+    HashStatsSnapshot stats() const;
+    FrozenHashMap< Key, Value, Hash, KeyEqual > freeze() const;
+    template< class Op >
+    void parallelForEach(Op op, size_type threads = std::thread::hardware_concurrency());
+    template< class Op >
+    void parallelForEach(Op op, size_type threads = std::thread::hardware_concurrency()) const;
+    template< class Pred >
+    size_type parallelEraseIf(Pred pred, size_type threads = std::thread::hardware_concurrency());
+    template< class T, class Transform, class Combine >
+    T parallelReduce(T init, Transform transform, Combine combine,
+      size_type threads = std::thread::hardware_concurrency()) const;
 
   private:
     using node_t = FwdListNode< value_type >;
+    using hasher_base_t = EboStorage< Hash, HasherTag >;
+    using key_equal_base_t = EboStorage< KeyEqual, KeyEqualTag >;
+
+    struct BulkEntry
+    {
+      node_t* node;
+      size_type bucket;
+      UniquePtr< node_t >* owner;
+    };
+    using bulk_parts_t = std::vector< std::vector< BulkEntry > >;
 
     size_type size_{ 0 };
-    size_type bucketCount_{ 0 };
+    size_type bucketCount_{ 1 };
     UniquePtr< node_t >* map_{ nullptr };
+    InlinePool< node_t, SMALL_CAPACITY > small_;
+    BucketBitmap occupied_{ 1 };
+    size_type lastReseedSize_{ 0 };
+    size_type reserved_{ 0 };
 
+    bool isSmall() const noexcept;
+    node_t* smallAt(size_type slot) const noexcept;
     void swap(this_t& rhs) noexcept;
     size_type hash(const Key& key) const;
     size_type hash(const value_type& value) const;
-    void resize(size_type newSize_);
+    void relink(size_type capacity);
+    size_type targetCapacity() const noexcept;
+    void shrinkIfSparse();
+    bool growIfNeeded();
+    node_t* findNode(size_type bucket, const Key& key) const;
+    template< class K, class... Args >
+    std::pair< iterator, bool > emplaceUnique(K&& key, Args&&... args);
+    template< class K, class M >
+    std::pair< iterator, bool > assignUnique(K&& key, M&& obj);
+    template< class... Args >
+    iterator createNode(size_type bucket, Args&&... args);
+    iterator adoptNode(size_type bucket, UniquePtr< node_t >&& node) noexcept;
+    iterator linkNode(size_type bucket, UniquePtr< node_t >&& node) noexcept;
+    node_type extractNode(size_type bucket, node_t* node);
+    iterator watchChain(iterator iter);
+    UniquePtr< node_t >& linkOf(size_type bucket, const node_t* node) noexcept;
+    UniquePtr< node_t > unlink(size_type bucket, UniquePtr< node_t >& link) noexcept;
     void removeContainer() noexcept;
+    const Stats& statsPolicy() const noexcept;
+    void resyncOccupied() noexcept;
+    size_type bulkRangeGrain(size_type threads) const noexcept;
+    template< bool Unique >
+    size_type bulkLink(bulk_parts_t& parts, size_type slices, size_type rangeGrain, size_type threads);
   };
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< bool IsConst >
-  class HashMap< Key, Value, Hash, KeyEqual >::HashMapIterator
+  class HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMapIterator
   {
   public:
     using iterator_category = std::forward_iterator_tag;
@@ -111,61 +208,107 @@ namespace ohantsev
     HashMapIterator(node_type* node, size_type bucket, const HashMap* owner) noexcept;
   };
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  class HashMap< Key, Value, Hash, KeyEqual, Stats >::NodeHandle
+  {
+  public:
+    NodeHandle() = default;
+    bool empty() const noexcept;
+    explicit operator bool() const noexcept;
+    const key_type& key() const;
+    mapped_type& mapped() const;
+
+  private:
+    friend class HashMap;
+
+    UniquePtr< node_t > node_;
+
+    explicit NodeHandle(UniquePtr< node_t >&& node) noexcept;
+  };
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  HashMap< Key, Value, Hash, KeyEqual, Stats >::NodeHandle::NodeHandle(UniquePtr< node_t >&& node) noexcept:
+    node_(std::move(node))
+  {}
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  bool HashMap< Key, Value, Hash, KeyEqual, Stats >::NodeHandle::empty() const noexcept
+  {
+    return !node_;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  HashMap< Key, Value, Hash, KeyEqual, Stats >::NodeHandle::operator bool() const noexcept
+  {
+    return !empty();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::NodeHandle::key() const -> const key_type&
+  {
+    assert(!empty());
+    return node_->data_.first;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::NodeHandle::mapped() const -> mapped_type&
+  {
+    assert(!empty());
+    return node_->data_.second;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< bool IsConst >
-  auto HashMap< Key, Value, Hash, KeyEqual >::HashMapIterator< IsConst >::operator*() const -> reference
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMapIterator< IsConst >::operator*() const -> reference
   {
     assert(current_ != nullptr);
     return reinterpret_cast< reference >(current_->data_);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< bool IsConst >
-  auto HashMap< Key, Value, Hash, KeyEqual >::HashMapIterator< IsConst >::operator->() const -> pointer
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMapIterator< IsConst >::operator->() const -> pointer
   {
     assert(current_ != nullptr);
     return reinterpret_cast< pointer >(&current_->data_);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< bool IsConst >
-  auto HashMap< Key, Value, Hash, KeyEqual >::HashMapIterator< IsConst >::operator++() -> HashMapIterator&
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMapIterator< IsConst >::operator++() -> HashMapIterator&
   {
     if (!current_)
     {
       return *this;
     }
-    if (current_->next_.get())
+    if (owner_->isSmall())
     {
-      current_ = current_->next_.get();
+      bucket_ = owner_->small_.findNext(owner_->small_.indexOf(current_) + 1);
+      current_ = (bucket_ < SMALL_CAPACITY) ? owner_->smallAt(bucket_) : nullptr;
       return *this;
     }
-    current_ = nullptr;
-    ++bucket_;
-    while (bucket_ < owner_->bucketCount_)
+    if (current_->next_.get())
     {
-      if (owner_->map_[bucket_])
-      {
-        current_ = owner_->map_[bucket_].get();
-        break;
-      }
-      ++bucket_;
+      current_ = current_->next_.get();
+      return *this;
     }
+    bucket_ = owner_->occupied_.findNext(bucket_ + 1);
+    current_ = (bucket_ < owner_->bucketCount_) ? owner_->map_[bucket_].get() : nullptr;
     return *this;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< bool IsConst >
-  auto HashMap< Key, Value, Hash, KeyEqual >::HashMapIterator< IsConst >::operator++(int) -> HashMapIterator
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMapIterator< IsConst >::operator++(int) -> HashMapIterator
   {
     HashMapIterator tmp = *this;
     ++(*this);
     return tmp;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< bool IsConst >
-  bool HashMap< Key, Value, Hash, KeyEqual >::HashMapIterator< IsConst >::
+  bool HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMapIterator< IsConst >::
   operator==(const HashMapIterator& rhs) const noexcept
   {
     assert(owner_ != nullptr);
@@ -173,80 +316,165 @@ namespace ohantsev
     return current_ == rhs.current_;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< bool IsConst >
-  bool HashMap< Key, Value, Hash, KeyEqual >::HashMapIterator< IsConst >::
+  bool HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMapIterator< IsConst >::
   operator!=(const HashMapIterator& rhs) const noexcept
   {
     return !(*this == rhs);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< bool IsConst >
-  HashMap< Key, Value, Hash, KeyEqual >::HashMapIterator< IsConst >::
+  HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMapIterator< IsConst >::
   HashMapIterator(node_type* node, size_type bucket, const HashMap* owner) noexcept:
     current_(node),
     bucket_(bucket),
     owner_(owner)
   {}
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::size() const noexcept -> size_type
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::size() const noexcept -> size_type
   {
     return size_;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  bool HashMap< Key, Value, Hash, KeyEqual >::empty() const noexcept
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  bool HashMap< Key, Value, Hash, KeyEqual, Stats >::empty() const noexcept
   {
     return size_ == 0;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  HashMap< Key, Value, Hash, KeyEqual >::HashMap(const size_type capacity)
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMap(const size_type capacity, const Hash& hasher,
+    const KeyEqual& equal):
+    hasher_base_t(hasher),
+    key_equal_base_t(equal)
   {
     if (capacity == 0)
     {
       throw std::invalid_argument("Invalid capacity");
     }
     const size_type tmp = static_cast< size_type >(capacity / MAX_LOAD_FACTOR) + 1;
+    BucketBitmap occupied(tmp);
     map_ = new UniquePtr< node_t >[tmp]();
     bucketCount_ = tmp;
+    occupied_.swap(occupied);
+    reserved_ = capacity;
+    statsPolicy().onAllocate();
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  void HashMap< Key, Value, Hash, KeyEqual >::clear() noexcept
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMap(const Hash& hasher, const KeyEqual& equal):
+    hasher_base_t(hasher),
+    key_equal_base_t(equal)
+  {}
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class ForwardIt, class >
+  HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMap(ForwardIt first, ForwardIt last, const size_type threads,
+    const Hash& hasher, const KeyEqual& equal):
+    HashMap(std::max< size_type >(std::distance(first, last), 1), hasher, equal)
   {
-    for (size_type i = 0; i < bucketCount_; i++)
+    const size_type count = std::distance(first, last);
+    const size_type slices = parallelWorkers(threads, parallelChunks(count, PARALLEL_CHUNK));
+    const size_type sliceSize = std::max< size_type >(parallelChunks(count, slices), 1);
+    const size_type rangeGrain = bulkRangeGrain(threads);
+    const size_type ranges = parallelChunks(bucketCount_, rangeGrain);
+    std::vector< ForwardIt > starts;
+    starts.reserve(slices);
+    for (size_type slice = 0; slice < slices; ++slice)
+    {
+      starts.push_back(first);
+      std::advance(first, std::min(sliceSize, count - std::min(count, slice * sliceSize)));
+    }
+    bulk_parts_t parts(slices * ranges);
+    try
+    {
+      parallelForChunks(count, sliceSize, slices,
+        [&](const size_type begin, const size_type end, size_type)
+        {
+          const size_type slice = begin / sliceSize;
+          ForwardIt iter = starts[slice];
+          for (size_type i = begin; i < end; ++i, ++iter)
+          {
+            const size_type bucket = hash(iter->first);
+            std::vector< BulkEntry >& part = parts[slice * ranges + bucket / rangeGrain];
+            part.push_back(BulkEntry{ nullptr, bucket, nullptr });
+            part.back().node = makeUnique< node_t >(*iter, UniquePtr< node_t >()).release();
+          }
+        });
+      statsPolicy().onAllocate(count);
+      bulkLink< true >(parts, slices, rangeGrain, threads);
+    }
+    catch (...)
+    {
+      for (std::vector< BulkEntry >& part: parts)
+      {
+        for (BulkEntry& entry: part)
+        {
+          delete entry.node;
+        }
+      }
+      throw;
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::clear() noexcept
+  {
+    for (size_type i = occupied_.findFirst(); i < bucketCount_; i = occupied_.findNext(i + 1))
     {
       map_[i].reset();
     }
+    small_.clear();
+    occupied_.clear();
     size_ = 0;
+    statsPolicy().onClear();
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  void HashMap< Key, Value, Hash, KeyEqual >::removeContainer() noexcept
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::removeContainer() noexcept
   {
-    delete[] map_;
+    clear();
+    if (!isSmall())
+    {
+      delete[] map_;
+    }
     map_ = nullptr;
-    bucketCount_ = 0;
+    occupied_ = BucketBitmap(1);
+    bucketCount_ = 1;
     size_ = 0;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  HashMap< Key, Value, Hash, KeyEqual >::~HashMap()
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  bool HashMap< Key, Value, Hash, KeyEqual, Stats >::isSmall() const noexcept
   {
-    delete[] map_;
+    return map_ == nullptr;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  HashMap< Key, Value, Hash, KeyEqual >::HashMap(this_t&& rhs) noexcept
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::smallAt(const size_type slot) const noexcept -> node_t*
+  {
+    return const_cast< node_t* >(small_.at(slot));
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  HashMap< Key, Value, Hash, KeyEqual, Stats >::~HashMap()
+  {
+    removeContainer();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMap(this_t&& rhs) noexcept:
+    hasher_base_t(rhs.hashFunction()),
+    key_equal_base_t(rhs.keyEqual())
   {
     swap(rhs);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::operator=(this_t&& rhs) noexcept -> this_t&
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::operator=(this_t&& rhs) noexcept -> this_t&
   {
     if (this != &rhs)
     {
@@ -256,45 +484,155 @@ namespace ohantsev
     return (*this);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  void HashMap< Key, Value, Hash, KeyEqual >::resize(size_type newSize_)
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::relink(const size_type capacity)
   {
-    this_t tmp(newSize_);
-    for (auto& pair: *this)
+    assert(capacity >= size_);
+    if (isSmall() && capacity <= SMALL_CAPACITY)
     {
-      auto bucket = tmp.hash(pair.first);
-      tmp.map_[bucket] = makeUnique< node_t >(std::move(pair), std::move(tmp.map_[bucket]));
-      ++tmp.size_;
+      return;
+    }
+    auto start = statsPolicy().resizeStarted();
+    this_t tmp = (capacity <= SMALL_CAPACITY) ? this_t(hashFunction(), keyEqual())
+      : this_t(capacity, hashFunction(), keyEqual());
+    size_type occupied = 0;
+    for (size_type bucket = occupied_.findFirst(); bucket < bucketCount_; bucket = occupied_.findNext(bucket + 1))
+    {
+      while (map_[bucket])
+      {
+        UniquePtr< node_t > node = std::move(map_[bucket]);
+        map_[bucket] = std::move(node->next_);
+        const size_type target = tmp.hash(node->data_.first);
+        if constexpr (SMALL_CAPACITY > 0)
+        {
+          if (tmp.isSmall())
+          {
+            tmp.small_.create(std::move(node->data_), UniquePtr< node_t >());
+            continue;
+          }
+        }
+        if (!tmp.map_[target])
+        {
+          ++occupied;
+          tmp.occupied_.set(target);
+        }
+        node->next_ = std::move(tmp.map_[target]);
+        tmp.map_[target] = std::move(node);
+      }
+    }
+    if constexpr (SMALL_CAPACITY > 0)
+    {
+      if (isSmall())
+      {
+        try
+        {
+          for (size_type slot = small_.findFirst(); slot < SMALL_CAPACITY; slot = small_.findNext(slot + 1))
+          {
+            node_t* entry = small_.at(slot);
+            const size_type target = tmp.hash(entry->data_.first);
+            UniquePtr< node_t > node = makeUnique< node_t >(std::move(entry->data_), UniquePtr< node_t >());
+            small_.destroy(entry);
+            if (!tmp.map_[target])
+            {
+              ++occupied;
+              tmp.occupied_.set(target);
+            }
+            node->next_ = std::move(tmp.map_[target]);
+            tmp.map_[target] = std::move(node);
+          }
+        }
+        catch (...)
+        {
+          for (size_type bucket = tmp.occupied_.findFirst(); bucket < tmp.bucketCount_;
+            bucket = tmp.occupied_.findNext(bucket + 1))
+          {
+            for (auto node = tmp.map_[bucket].get(); node != nullptr; node = node->next_.get())
+            {
+              small_.create(std::move(node->data_), UniquePtr< node_t >());
+            }
+          }
+          throw;
+        }
+        statsPolicy().onAllocate(size_);
+      }
+    }
+    tmp.size_ = size_;
+    tmp.reserved_ = reserved_;
+    if (!tmp.isSmall())
+    {
+      statsPolicy().onAllocate();
     }
     removeContainer();
     swap(tmp);
+    statsPolicy().resizeFinished(start, occupied);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::targetCapacity() const noexcept -> size_type
+  {
+    return std::max(static_cast< size_type >(size_ * EXPANSION_COEFFICIENT), reserved_);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::shrinkIfSparse()
+  {
+    if (isSmall() || loadFactor() >= MIN_LOAD_FACTOR)
+    {
+      return;
+    }
+    const size_type capacity = std::max(targetCapacity(), SMALL_CAPACITY + 1);
+    if (static_cast< size_type >(capacity / MAX_LOAD_FACTOR) + 1 >= bucketCount_)
+    {
+      return;
+    }
+    try
+    {
+      relink(capacity);
+    }
+    catch (const std::bad_alloc&)
+    {}
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::shrinkToFit()
+  {
+    reserved_ = 0;
+    relink(size_);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  HashMap< Key, Value, Hash, KeyEqual >::HashMap(const this_t& rhs)
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  HashMap< Key, Value, Hash, KeyEqual, Stats >::HashMap(const this_t& rhs):
+    hasher_base_t(rhs.hashFunction()),
+    key_equal_base_t(rhs.keyEqual())
   {
     static_assert(std::is_copy_constructible< Key >::value && std::is_copy_constructible< Value >::value);
-    this_t tmp(rhs.size());
+    this_t tmp = (rhs.size() <= SMALL_CAPACITY) ? this_t(rhs.hashFunction(), rhs.keyEqual())
+      : this_t(rhs.size(), rhs.hashFunction(), rhs.keyEqual());
     for (const auto& pair: rhs)
     {
-      auto bucket = tmp.hash(pair.first);
-      tmp.map_[bucket] = makeUnique< node_t >(pair, std::move(tmp.map_[bucket]));
-      ++tmp.size_;
+      tmp.createNode(tmp.hash(pair.first), pair, UniquePtr< node_t >());
     }
+    tmp.reserved_ = rhs.reserved_;
     removeContainer();
     swap(tmp);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  void HashMap< Key, Value, Hash, KeyEqual >::swap(this_t& rhs) noexcept
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::swap(this_t& rhs) noexcept
   {
     std::swap(size_, rhs.size_);
     std::swap(bucketCount_, rhs.bucketCount_);
     std::swap(map_, rhs.map_);
+    small_.swap(rhs.small_);
+    occupied_.swap(rhs.occupied_);
+    std::swap(this->hasher_base_t::get(), rhs.hasher_base_t::get());
+    std::swap(this->key_equal_base_t::get(), rhs.key_equal_base_t::get());
+    std::swap(lastReseedSize_, rhs.lastReseedSize_);
+    std::swap(reserved_, rhs.reserved_);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::operator=(const this_t& rhs) -> this_t&
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::operator=(const this_t& rhs) -> this_t&
   {
     if (this != &rhs)
     {
@@ -304,206 +642,889 @@ namespace ohantsev
     return *this;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  double HashMap< Key, Value, Hash, KeyEqual >::loadFactor() const noexcept
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  double HashMap< Key, Value, Hash, KeyEqual, Stats >::loadFactor() const noexcept
   {
     assert(bucketCount_ != 0);
     return static_cast< double >(size_) / bucketCount_;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  void HashMap< Key, Value, Hash, KeyEqual >::rehash()
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::rehash()
+  {
+    relink(targetCapacity());
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::parallelRehash(const size_type threads)
   {
-    resize(static_cast< size_type >(size_ * EXPANSION_COEFFICIENT));
+    if (isSmall())
+    {
+      rehash();
+      return;
+    }
+    auto start = statsPolicy().resizeStarted();
+    this_t tmp(std::max< size_type >(targetCapacity(), 1), hashFunction(), keyEqual());
+    tmp.reserved_ = reserved_;
+    const size_type slices = parallelWorkers(threads, parallelChunks(bucketCount_, PARALLEL_CHUNK));
+    const size_type sliceSize = parallelChunks(parallelChunks(bucketCount_, slices), BucketBitmap::WORD_BITS)
+      * BucketBitmap::WORD_BITS;
+    const size_type rangeGrain = tmp.bulkRangeGrain(threads);
+    const size_type ranges = parallelChunks(tmp.bucketCount_, rangeGrain);
+    bulk_parts_t parts(slices * ranges);
+    parallelForChunks(bucketCount_, sliceSize, slices,
+      [&](const size_type first, const size_type last, size_type)
+      {
+        const size_type slice = first / sliceSize;
+        for (size_type bucket = occupied_.findNext(first); bucket < last; bucket = occupied_.findNext(bucket + 1))
+        {
+          UniquePtr< node_t >* owner = &map_[bucket];
+          for (auto node = map_[bucket].get(); node != nullptr; node = node->next_.get())
+          {
+            const size_type target = tmp.hash(node->data_.first);
+            parts[slice * ranges + target / rangeGrain].push_back(BulkEntry{ node, target, owner });
+            owner = nullptr;
+          }
+        }
+      });
+    const size_type occupied = tmp.template bulkLink< false >(parts, slices, rangeGrain, threads);
+    statsPolicy().onAllocate();
+    removeContainer();
+    swap(tmp);
+    statsPolicy().resizeFinished(start, occupied);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::bulkRangeGrain(const size_type threads) const noexcept -> size_type
+  {
+    const size_type groups = parallelChunks(bucketCount_, BucketBitmap::GROUP_BUCKETS);
+    return parallelChunks(groups, parallelWorkers(threads, groups)) * BucketBitmap::GROUP_BUCKETS;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< bool Unique >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::bulkLink(bulk_parts_t& parts, const size_type slices,
+    const size_type rangeGrain, const size_type threads) -> size_type
+  {
+    const size_type ranges = parallelChunks(bucketCount_, rangeGrain);
+    std::vector< size_type > linked(ranges);
+    std::vector< size_type > filled(ranges);
+    auto settle = [&]()
+    {
+      occupied_.resetHint();
+      size_type occupied = 0;
+      for (size_type range = 0; range < ranges; ++range)
+      {
+        size_ += linked[range];
+        occupied += filled[range];
+      }
+      return occupied;
+    };
+    try
+    {
+      parallelForChunks(ranges, 1, threads,
+        [&](const size_type range, size_type, size_type)
+        {
+          for (size_type slice = 0; slice < slices; ++slice)
+          {
+            for (BulkEntry& entry: parts[slice * ranges + range])
+            {
+              UniquePtr< node_t >& head = map_[entry.bucket];
+              if constexpr (Unique)
+              {
+                bool duplicate = false;
+                for (auto node = head.get(); node != nullptr && !duplicate; node = node->next_.get())
+                {
+                  duplicate = keyEqual()(node->data_.first, entry.node->data_.first);
+                }
+                if (duplicate)
+                {
+                  delete entry.node;
+                  entry.node = nullptr;
+                  continue;
+                }
+              }
+              if (entry.owner)
+              {
+                entry.owner->release();
+              }
+              entry.node->next_.release();
+              if (!head)
+              {
+                occupied_.setNoHint(entry.bucket);
+                ++filled[range];
+              }
+              entry.node->next_ = std::move(head);
+              head.reset(entry.node);
+              entry.node = nullptr;
+              ++linked[range];
+            }
+          }
+        });
+    }
+    catch (...)
+    {
+      settle();
+      throw;
+    }
+    return settle();
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  void HashMap< Key, Value, Hash, KeyEqual >::reserve(const size_type capacity)
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::reserve(const size_type capacity)
   {
+    reserved_ = std::max(reserved_, capacity);
     if (capacity > size_)
     {
-      resize(capacity);
+      relink(capacity);
     }
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< class Pair >
-  auto HashMap< Key, Value, Hash, KeyEqual >::
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
   insert(Pair&& pair) -> std::pair< iterator, bool >
   {
-    auto iter = find(pair.first);
-    if (iter != end())
+    auto bucket = hash(pair.first);
+    if (node_t* existing = findNode(bucket, pair.first))
     {
-      return std::make_pair(iter, false);
+      return std::make_pair(iterator{ existing, bucket, this }, false);
     }
-    if (loadFactor() >= MAX_LOAD_FACTOR)
+    if (growIfNeeded())
     {
-      rehash();
+      bucket = hash(pair.first);
     }
-    auto bucket = hash(pair.first);
-    map_[bucket] = makeUnique< node_t >(std::forward< Pair >(pair), std::move(map_[bucket]));
+    return std::make_pair(watchChain(createNode(bucket, std::forward< Pair >(pair), UniquePtr< node_t >())), true);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::insert(node_type&& node) -> std::pair< iterator, bool >
+  {
+    if (node.empty())
+    {
+      return std::make_pair(end(), false);
+    }
+    auto bucket = hash(node.key());
+    if (node_t* existing = findNode(bucket, node.key()))
+    {
+      return std::make_pair(iterator{ existing, bucket, this }, false);
+    }
+    if (growIfNeeded())
+    {
+      bucket = hash(node.key());
+    }
+    return std::make_pair(watchChain(adoptNode(bucket, std::move(node.node_))), true);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  bool HashMap< Key, Value, Hash, KeyEqual, Stats >::growIfNeeded()
+  {
+    if (isSmall() ? size_ >= SMALL_CAPACITY : loadFactor() >= MAX_LOAD_FACTOR)
+    {
+      relink(std::max(targetCapacity(), SMALL_CAPACITY + 1));
+      return true;
+    }
+    return false;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class... Args >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  tryEmplace(const Key& key, Args&&... args) -> std::pair< iterator, bool >
+  {
+    return emplaceUnique(key, std::forward< Args >(args)...);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class... Args >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  tryEmplace(Key&& key, Args&&... args) -> std::pair< iterator, bool >
+  {
+    return emplaceUnique(std::move(key), std::forward< Args >(args)...);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class M >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  insertOrAssign(const Key& key, M&& obj) -> std::pair< iterator, bool >
+  {
+    return assignUnique(key, std::forward< M >(obj));
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class M >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  insertOrAssign(Key&& key, M&& obj) -> std::pair< iterator, bool >
+  {
+    return assignUnique(std::move(key), std::forward< M >(obj));
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class K, class... Args >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  emplaceUnique(K&& key, Args&&... args) -> std::pair< iterator, bool >
+  {
+    auto bucket = hash(key);
+    if (node_t* existing = findNode(bucket, key))
+    {
+      return std::make_pair(iterator{ existing, bucket, this }, false);
+    }
+    if (growIfNeeded())
+    {
+      bucket = hash(key);
+    }
+    return std::make_pair(watchChain(createNode(bucket, std::in_place, std::piecewise_construct,
+      std::forward_as_tuple(std::forward< K >(key)), std::forward_as_tuple(std::forward< Args >(args)...))), true);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class K, class M >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  assignUnique(K&& key, M&& obj) -> std::pair< iterator, bool >
+  {
+    auto bucket = hash(key);
+    if (node_t* existing = findNode(bucket, key))
+    {
+      existing->data_.second = std::forward< M >(obj);
+      return std::make_pair(iterator{ existing, bucket, this }, false);
+    }
+    if (growIfNeeded())
+    {
+      bucket = hash(key);
+    }
+    return std::make_pair(watchChain(createNode(bucket, std::in_place, std::forward< K >(key),
+      std::forward< M >(obj))), true);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class... Args >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::createNode(const size_type bucket, Args&&... args) -> iterator
+  {
+    if (isSmall())
+    {
+      node_t* node = small_.create(std::forward< Args >(args)...);
+      ++size_;
+      return iterator{ node, small_.indexOf(node), this };
+    }
+    auto node = makeUnique< node_t >(std::forward< Args >(args)...);
+    statsPolicy().onAllocate();
+    return linkNode(bucket, std::move(node));
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  adoptNode(const size_type bucket, UniquePtr< node_t >&& node) noexcept -> iterator
+  {
+    if constexpr (SMALL_CAPACITY > 0)
+    {
+      if (isSmall())
+      {
+        return createNode(bucket, std::move(node->data_), UniquePtr< node_t >());
+      }
+    }
+    return linkNode(bucket, std::move(node));
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  linkNode(const size_type bucket, UniquePtr< node_t >&& node) noexcept -> iterator
+  {
+    if (!map_[bucket])
+    {
+      occupied_.set(bucket);
+      statsPolicy().onBucketFilled();
+    }
+    node->next_ = std::move(map_[bucket]);
+    map_[bucket] = std::move(node);
     ++size_;
-    return std::make_pair(iterator{ map_[bucket].get(), bucket, this }, true);
+    return iterator{ map_[bucket].get(), bucket, this };
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::watchChain(const iterator iter) -> iterator
+  {
+    if constexpr (IsReseedable< Hash >::value)
+    {
+      if (isSmall() || size_ < 2 * lastReseedSize_)
+      {
+        return iter;
+      }
+      size_type length = 0;
+      for (auto node = map_[iter.bucket_].get(); node != nullptr; node = node->next_.get())
+      {
+        ++length;
+      }
+      if (length <= MAX_CHAIN_LENGTH)
+      {
+        return iter;
+      }
+      const Hash previous = hashFunction();
+      this->hasher_base_t::get().reseed();
+      try
+      {
+        relink(targetCapacity());
+      }
+      catch (const std::bad_alloc&)
+      {
+        this->hasher_base_t::get() = previous;
+        return iter;
+      }
+      lastReseedSize_ = size_;
+      return iterator{ iter.current_, hash(iter.current_->data_.first), this };
+    }
+    return iter;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  linkOf(const size_type bucket, const node_t* node) noexcept -> UniquePtr< node_t >&
+  {
+    UniquePtr< node_t >* link = &map_[bucket];
+    while (link->get() != node)
+    {
+      link = &(*link)->next_;
+    }
+    return *link;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
+  unlink(const size_type bucket, UniquePtr< node_t >& link) noexcept -> UniquePtr< node_t >
+  {
+    UniquePtr< node_t > node = std::move(link);
+    link = std::move(node->next_);
+    --size_;
+    if (!map_[bucket])
+    {
+      occupied_.reset(bucket);
+      statsPolicy().onBucketEmptied();
+    }
+    return node;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
   template< class K, class V >
-  auto HashMap< Key, Value, Hash, KeyEqual >::
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::
   emplace(K&& key, V&& value) -> std::pair< iterator, bool >
   {
     return insert(value_type(std::forward< K >(key), std::forward< V >(value)));
   }
 
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::hash(const Key& key) const -> size_type
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::hash(const Key& key) const -> size_type
   {
     assert(bucketCount_ != 0);
-    return Hash{}(key) % bucketCount_;
+    if (isSmall())
+    {
+      return 0;
+    }
+    return hashFunction()(key) % bucketCount_;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::hash(const value_type& value) const -> size_type
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::hash(const value_type& value) const -> size_type
   {
     return hash(value.first);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  bool HashMap< Key, Value, Hash, KeyEqual >::erase(const Key& key)
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  bool HashMap< Key, Value, Hash, KeyEqual, Stats >::erase(const Key& key)
   {
+    if (isSmall())
     {
-      size_type bucket = hash(key);
-      if (!map_[bucket])
+      for (size_type slot = small_.findFirst(); slot < SMALL_CAPACITY; slot = small_.findNext(slot + 1))
       {
-        return false;
+        if (keyEqual()(small_.at(slot)->data_.first, key))
+        {
+          small_.destroy(small_.at(slot));
+          --size_;
+          return true;
+        }
       }
-      node_t* cur = map_[bucket].get();
-      if (KeyEqual{}(cur->data_.first, key))
+      return false;
+    }
+    const size_type bucket = hash(key);
+    for (UniquePtr< node_t >* link = &map_[bucket]; *link; link = &(*link)->next_)
+    {
+      if (keyEqual()((*link)->data_.first, key))
       {
-        map_[bucket] = std::move(cur->next_);
-        --size_;
+        unlink(bucket, *link);
+        shrinkIfSparse();
         return true;
       }
-      while (cur->next_)
+    }
+    return false;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  bool HashMap< Key, Value, Hash, KeyEqual, Stats >::erase(const iterator& iter)
+  {
+    if (isSmall() && iter != end())
+    {
+      small_.destroy(iter.current_);
+      --size_;
+      return true;
+    }
+    return !extract(iter).empty();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  bool HashMap< Key, Value, Hash, KeyEqual, Stats >::erase(const const_iterator& iter)
+  {
+    if (isSmall() && iter != cend())
+    {
+      small_.destroy(iter.current_);
+      --size_;
+      return true;
+    }
+    return !extract(iter).empty();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class Pred >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::eraseIf(Pred pred) -> size_type
+  {
+    size_type erased = 0;
+    for (size_type slot = small_.findFirst(); slot < SMALL_CAPACITY; slot = small_.findNext(slot + 1))
+    {
+      if (pred(std::as_const(small_.at(slot)->data_)))
+      {
+        small_.destroy(small_.at(slot));
+        --size_;
+        ++erased;
+      }
+    }
+    for (size_type bucket = occupied_.findFirst(); bucket < bucketCount_; bucket = occupied_.findNext(bucket + 1))
+    {
+      UniquePtr< node_t >* link = &map_[bucket];
+      while (*link)
       {
-        if (KeyEqual{}(cur->next_->data_.first, key))
+        if (pred(std::as_const((*link)->data_)))
         {
-          cur->next_ = std::move(cur->next_->next_);
-          --size_;
-          return true;
+          unlink(bucket, *link);
+          ++erased;
+        }
+        else
+        {
+          link = &(*link)->next_;
         }
-        cur = cur->next_.get();
       }
-      return false;
     }
+    shrinkIfSparse();
+    return erased;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::extract(const Key& key) -> node_type
+  {
+    node_type node = extract(find(key));
+    shrinkIfSparse();
+    return node;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  bool HashMap< Key, Value, Hash, KeyEqual >::erase(const iterator& iter)
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::extract(const iterator& iter) -> node_type
   {
     if (iter == end())
     {
-      return false;
+      return node_type();
     }
-    return erase(iter->first);
+    return extractNode(iter.bucket_, iter.current_);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  bool HashMap< Key, Value, Hash, KeyEqual >::erase(const const_iterator& iter)
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::extract(const const_iterator& iter) -> node_type
   {
     if (iter == cend())
     {
-      return false;
+      return node_type();
     }
-    return erase(iter->first);
+    return extractNode(iter.bucket_, iter.current_);
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::cbegin() const noexcept -> const_iterator
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::extractNode(const size_type bucket, node_t* node) -> node_type
   {
-    for (size_type bucket = 0; bucket < bucketCount_; ++bucket)
+    if constexpr (SMALL_CAPACITY > 0)
     {
-      if (map_[bucket])
+      if (isSmall())
       {
-        return const_iterator{ map_[bucket].get(), bucket, this };
+        UniquePtr< node_t > moved = makeUnique< node_t >(std::move(node->data_), UniquePtr< node_t >());
+        statsPolicy().onAllocate();
+        small_.destroy(node);
+        --size_;
+        return node_type(std::move(moved));
       }
     }
+    return node_type(unlink(bucket, linkOf(bucket, node)));
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::merge(this_t& source)
+  {
+    if (this == &source)
+    {
+      return;
+    }
+    if constexpr (SMALL_CAPACITY > 0)
+    {
+      for (size_type slot = source.small_.findFirst(); slot < SMALL_CAPACITY; slot = source.small_.findNext(slot + 1))
+      {
+        node_t* entry = source.small_.at(slot);
+        size_type target = hash(entry->data_.first);
+        if (findNode(target, entry->data_.first))
+        {
+          continue;
+        }
+        if (growIfNeeded())
+        {
+          target = hash(entry->data_.first);
+        }
+        watchChain(createNode(target, std::move(entry->data_), UniquePtr< node_t >()));
+        source.small_.destroy(entry);
+        --source.size_;
+      }
+    }
+    for (size_type bucket = source.occupied_.findFirst(); bucket < source.bucketCount_;
+      bucket = source.occupied_.findNext(bucket + 1))
+    {
+      UniquePtr< node_t >* link = &source.map_[bucket];
+      while (*link)
+      {
+        const Key& key = (*link)->data_.first;
+        size_type target = hash(key);
+        if (findNode(target, key))
+        {
+          link = &(*link)->next_;
+          continue;
+        }
+        if (growIfNeeded())
+        {
+          target = hash(key);
+        }
+        watchChain(adoptNode(target, source.unlink(bucket, *link)));
+      }
+    }
+    source.shrinkIfSparse();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::cbegin() const noexcept -> const_iterator
+  {
+    if (isSmall())
+    {
+      const size_type slot = small_.findFirst();
+      return (slot < SMALL_CAPACITY) ? const_iterator{ smallAt(slot), slot, this } : end();
+    }
+    const size_type bucket = occupied_.findFirst();
+    if (bucket < bucketCount_)
+    {
+      return const_iterator{ map_[bucket].get(), bucket, this };
+    }
     return end();
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::cend() const noexcept -> const_iterator
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::cend() const noexcept -> const_iterator
   {
     return const_iterator{ nullptr, bucketCount_, this };
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::begin() noexcept -> iterator
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::begin() noexcept -> iterator
   {
-    for (size_type bucket = 0; bucket < bucketCount_; ++bucket)
+    if (isSmall())
     {
-      if (map_[bucket])
-      {
-        return iterator{ map_[bucket].get(), bucket, this };
-      }
+      const size_type slot = small_.findFirst();
+      return (slot < SMALL_CAPACITY) ? iterator{ smallAt(slot), slot, this } : end();
+    }
+    const size_type bucket = occupied_.findFirst();
+    if (bucket < bucketCount_)
+    {
+      return iterator{ map_[bucket].get(), bucket, this };
     }
     return end();
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::end() noexcept -> iterator
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::end() noexcept -> iterator
   {
     return iterator{ nullptr, bucketCount_, this };
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::begin() const noexcept -> const_iterator
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::begin() const noexcept -> const_iterator
   {
     return cbegin();
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::end() const noexcept -> const_iterator
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::end() const noexcept -> const_iterator
   {
     return cend();
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::find(const Key& key) -> iterator
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::find(const Key& key) -> iterator
   {
-    auto bucket = hash(key);
+    const size_type bucket = hash(key);
+    node_t* node = findNode(bucket, key);
+    return node ? iterator{ node, bucket, this } : end();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::find(const Key& key) const -> const_iterator
+  {
+    const size_type bucket = hash(key);
+    node_t* node = findNode(bucket, key);
+    return node ? const_iterator{ node, bucket, this } : end();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::findNode(const size_type bucket, const Key& key) const -> node_t*
+  {
+    size_type probes = 0;
+    if (isSmall())
+    {
+      for (size_type slot = small_.findFirst(); slot < SMALL_CAPACITY; slot = small_.findNext(slot + 1))
+      {
+        ++probes;
+        if (keyEqual()(small_.at(slot)->data_.first, key))
+        {
+          statsPolicy().onFind(probes);
+          return smallAt(slot);
+        }
+      }
+      statsPolicy().onFind(probes);
+      return nullptr;
+    }
     for (auto node = map_[bucket].get(); node != nullptr; node = node->next_.get())
     {
-      if (KeyEqual{}(node->data_.first, key))
+      ++probes;
+      if (keyEqual()(node->data_.first, key))
       {
-        return iterator{ node, bucket, this };
+        statsPolicy().onFind(probes);
+        return node;
       }
     }
-    return end();
+    statsPolicy().onFind(probes);
+    return nullptr;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::find(const Key& key) const -> const_iterator
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::stats() const -> HashStatsSnapshot
   {
-    auto bucket = hash(key);
-    for (auto node = map_[bucket].get(); node != nullptr; node = node->next_.get())
+    HashStatsSnapshot snapshot = statsPolicy().snapshot();
+    snapshot.chainHistogram[0] = bucketCount_ - occupied_.count();
+    if (isSmall())
     {
-      if (KeyEqual{}(node->data_.first, key))
+      snapshot.chainHistogram[0] = 0;
+      ++snapshot.chainHistogram[HashStatsSnapshot::histogramSlot(size_)];
+    }
+    for (size_type bucket = occupied_.findFirst(); bucket < bucketCount_; bucket = occupied_.findNext(bucket + 1))
+    {
+      size_type length = 0;
+      for (auto node = map_[bucket].get(); node != nullptr; node = node->next_.get())
       {
-        return const_iterator{ node, bucket, this };
+        ++length;
       }
+      ++snapshot.chainHistogram[HashStatsSnapshot::histogramSlot(length)];
     }
-    return end();
+    return snapshot;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class Op >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::parallelForEach(Op op, const size_type threads)
+  {
+    for (size_type slot = small_.findFirst(); slot < SMALL_CAPACITY; slot = small_.findNext(slot + 1))
+    {
+      node_t* node = smallAt(slot);
+      op(node->data_);
+    }
+    parallelForChunks(bucketCount_, PARALLEL_CHUNK, threads,
+      [&](const size_type first, const size_type last, size_type)
+      {
+        for (size_type bucket = occupied_.findNext(first); bucket < last; bucket = occupied_.findNext(bucket + 1))
+        {
+          for (auto node = map_[bucket].get(); node != nullptr; node = node->next_.get())
+          {
+            op(node->data_);
+          }
+        }
+      });
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class Op >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::parallelForEach(Op op, const size_type threads) const
+  {
+    for (size_type slot = small_.findFirst(); slot < SMALL_CAPACITY; slot = small_.findNext(slot + 1))
+    {
+      node_t* node = smallAt(slot);
+      op(std::as_const(node->data_));
+    }
+    parallelForChunks(bucketCount_, PARALLEL_CHUNK, threads,
+      [&](const size_type first, const size_type last, size_type)
+      {
+        for (size_type bucket = occupied_.findNext(first); bucket < last; bucket = occupied_.findNext(bucket + 1))
+        {
+          for (auto node = map_[bucket].get(); node != nullptr; node = node->next_.get())
+          {
+            op(std::as_const(node->data_));
+          }
+        }
+      });
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class Pred >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::parallelEraseIf(Pred pred, const size_type threads) -> size_type
+  {
+    if (isSmall())
+    {
+      return eraseIf(pred);
+    }
+    const size_type workers = parallelWorkers(threads, parallelChunks(bucketCount_, PARALLEL_CHUNK));
+    std::vector< size_type > erased(workers);
+    std::vector< std::vector< size_type > > emptied(workers);
+    try
+    {
+      parallelForChunks(bucketCount_, PARALLEL_CHUNK, workers,
+        [&](const size_type first, const size_type last, const size_type worker)
+        {
+          for (size_type bucket = occupied_.findNext(first); bucket < last; bucket = occupied_.findNext(bucket + 1))
+          {
+            UniquePtr< node_t >* link = &map_[bucket];
+            while (*link)
+            {
+              if (pred(std::as_const((*link)->data_)))
+              {
+                *link = std::move((*link)->next_);
+                ++erased[worker];
+              }
+              else
+              {
+                link = &(*link)->next_;
+              }
+            }
+            if (!map_[bucket])
+            {
+              emptied[worker].push_back(bucket);
+            }
+          }
+        });
+    }
+    catch (...)
+    {
+      for (size_type count: erased)
+      {
+        size_ -= count;
+      }
+      resyncOccupied();
+      throw;
+    }
+    size_type total = 0;
+    for (size_type worker = 0; worker < workers; ++worker)
+    {
+      total += erased[worker];
+      for (size_type bucket: emptied[worker])
+      {
+        occupied_.reset(bucket);
+        statsPolicy().onBucketEmptied();
+      }
+    }
+    size_ -= total;
+    shrinkIfSparse();
+    return total;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  template< class T, class Transform, class Combine >
+  T HashMap< Key, Value, Hash, KeyEqual, Stats >::parallelReduce(T init, Transform transform, Combine combine,
+    const size_type threads) const
+  {
+    for (size_type slot = small_.findFirst(); slot < SMALL_CAPACITY; slot = small_.findNext(slot + 1))
+    {
+      init = combine(std::move(init), transform(std::as_const(small_.at(slot)->data_)));
+    }
+    const size_type workers = parallelWorkers(threads, parallelChunks(bucketCount_, PARALLEL_CHUNK));
+    std::vector< std::optional< T > > partial(workers);
+    parallelForChunks(bucketCount_, PARALLEL_CHUNK, workers,
+      [&](const size_type first, const size_type last, const size_type worker)
+      {
+        std::optional< T >& result = partial[worker];
+        for (size_type bucket = occupied_.findNext(first); bucket < last; bucket = occupied_.findNext(bucket + 1))
+        {
+          for (auto node = map_[bucket].get(); node != nullptr; node = node->next_.get())
+          {
+            if (result)
+            {
+              result = combine(std::move(*result), transform(std::as_const(node->data_)));
+            }
+            else
+            {
+              result.emplace(transform(std::as_const(node->data_)));
+            }
+          }
+        }
+      });
+    for (std::optional< T >& result: partial)
+    {
+      if (result)
+      {
+        init = combine(std::move(init), std::move(*result));
+      }
+    }
+    return init;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  void HashMap< Key, Value, Hash, KeyEqual, Stats >::resyncOccupied() noexcept
+  {
+    for (size_type bucket = occupied_.findFirst(); bucket < bucketCount_; bucket = occupied_.findNext(bucket + 1))
+    {
+      if (!map_[bucket])
+      {
+        occupied_.reset(bucket);
+        statsPolicy().onBucketEmptied();
+      }
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::freeze() const -> FrozenHashMap< Key, Value, Hash, KeyEqual >
+  {
+    return FrozenHashMap< Key, Value, Hash, KeyEqual >(cbegin(), cend(), hashFunction(), keyEqual());
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  const Hash& HashMap< Key, Value, Hash, KeyEqual, Stats >::hashFunction() const noexcept
+  {
+    return this->hasher_base_t::get();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  const KeyEqual& HashMap< Key, Value, Hash, KeyEqual, Stats >::keyEqual() const noexcept
+  {
+    return this->key_equal_base_t::get();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::statsPolicy() const noexcept -> const Stats&
+  {
+    return *this;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::operator[](const Key& key) -> mapped_type&
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::operator[](const Key& key) -> mapped_type&
   {
-    return emplace(key, mapped_type{}).first->second;
+    return tryEmplace(key).first->second;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::operator[](const Key& key) const -> const mapped_type&
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::operator[](const Key& key) const -> const mapped_type&
   {
     auto iter = find(key);
     if (iter == end())
@@ -514,8 +1535,8 @@ namespace ohantsev
     return iter->second;
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::at(const Key& key) -> mapped_type&
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::at(const Key& key) -> mapped_type&
   {
     auto iter = find(key);
     if (iter != end())
@@ -525,8 +1546,8 @@ namespace ohantsev
     throw std::out_of_range("Key not found");
   }
 
-  template< class Key, class Value, class Hash, class KeyEqual >
-  auto HashMap< Key, Value, Hash, KeyEqual >::at(const Key& key) const -> const mapped_type&
+  template< class Key, class Value, class Hash, class KeyEqual, class Stats >
+  auto HashMap< Key, Value, Hash, KeyEqual, Stats >::at(const Key& key) const -> const mapped_type&
   {
     auto iter = find(key);
     if (iter != end())
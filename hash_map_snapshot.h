@@ -0,0 +1,467 @@
+#ifndef HASH_MAP_SNAPSHOT_H
+#define HASH_MAP_SNAPSHOT_H
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ebo_storage.h"
+#include "hash_map.h"
+#include "seeded_hash.h"
+
+namespace ohantsev
+{
+  template< class Key >
+  using snapshot_lookup_t = std::conditional_t< std::is_same< Key, std::string >::value, std::string_view, Key >;
+
+  struct SnapshotHeader
+  {
+    static constexpr char MAGIC[8]{ 'O', 'H', 'S', 'N', 'A', 'P', '\0', '\0' };
+    static constexpr std::uint32_t VERSION{ 2 };
+    static constexpr std::uint64_t HASH_CHECK_ENTRIES{ 16 };
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t stringKeys;
+    std::uint64_t keySize;
+    std::uint64_t valueSize;
+    std::uint64_t entrySize;
+    std::uint64_t size;
+    std::uint64_t bucketCount;
+    std::uint64_t bucketsOffset;
+    std::uint64_t entriesOffset;
+    std::uint64_t blobOffset;
+    std::uint64_t blobSize;
+    std::uint64_t fileSize;
+    std::uint64_t hashCheck;
+  };
+
+  template< class Key, class Value,
+    class Hash = std::hash< snapshot_lookup_t< Key > >,
+    class KeyEqual = std::equal_to< snapshot_lookup_t< Key > > >
+  class HashMapSnapshot: private EboStorage< Hash, HasherTag >, private EboStorage< KeyEqual, KeyEqualTag >
+  {
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using lookup_type = snapshot_lookup_t< Key >;
+    using size_type = std::size_t;
+    using this_t = HashMapSnapshot;
+
+    static constexpr bool STRING_KEYS{ std::is_same< Key, std::string >::value };
+    static constexpr double LOAD_FACTOR{ 0.7 };
+
+    static_assert(std::is_trivially_copyable< Value >::value, "Snapshot values must be trivially copyable");
+    static_assert(STRING_KEYS || std::is_trivially_copyable< Key >::value,
+      "Snapshot keys must be trivially copyable or std::string");
+
+    explicit HashMapSnapshot(const std::string& path, const Hash& hasher = Hash(), const KeyEqual& equal = KeyEqual());
+    ~HashMapSnapshot();
+    HashMapSnapshot(const this_t&) = delete;
+    this_t& operator=(const this_t&) = delete;
+    HashMapSnapshot(this_t&& rhs) noexcept;
+    this_t& operator=(this_t&& rhs) noexcept;
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+    size_type bucketCount() const noexcept;
+    const mapped_type* find(const lookup_type& key) const;
+    bool contains(const lookup_type& key) const;
+    const mapped_type& at(const lookup_type& key) const;
+    const Hash& hashFunction() const noexcept;
+    const KeyEqual& keyEqual() const noexcept;
+
+    template< class MapHash, class MapKeyEqual, class MapStats >
+    static void write(const HashMap< Key, Value, MapHash, MapKeyEqual, MapStats >& map, const std::string& path,
+      const Hash& hasher = Hash());
+
+  private:
+    using hasher_base_t = EboStorage< Hash, HasherTag >;
+    using key_equal_base_t = EboStorage< KeyEqual, KeyEqualTag >;
+
+    struct InlineEntry
+    {
+      Key key;
+      Value value;
+    };
+
+    struct StringEntry
+    {
+      std::uint64_t hash;
+      std::uint64_t offset;
+      std::uint64_t length;
+      Value value;
+    };
+
+    using entry_t = std::conditional_t< STRING_KEYS, StringEntry, InlineEntry >;
+
+    const unsigned char* data_{ nullptr };
+    size_type fileSize_{ 0 };
+    const SnapshotHeader* header_{ nullptr };
+    const std::uint64_t* buckets_{ nullptr };
+    const entry_t* entries_{ nullptr };
+    const char* blob_{ nullptr };
+
+    void swap(this_t& rhs) noexcept;
+    void validate() const;
+    void verifyHash() const;
+    static std::uint64_t foldHash(std::uint64_t check, std::uint64_t hash) noexcept;
+    static std::uint64_t alignOffset(std::uint64_t offset, std::uint64_t alignment) noexcept;
+    static bool writeAll(int fd, const void* data, std::size_t size) noexcept;
+  };
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  HashMapSnapshot< Key, Value, Hash, KeyEqual >::HashMapSnapshot(const std::string& path, const Hash& hasher,
+    const KeyEqual& equal):
+    hasher_base_t(hasher),
+    key_equal_base_t(equal)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      throw std::runtime_error("Cannot open snapshot " + path);
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast< off_t >(sizeof(SnapshotHeader)))
+    {
+      ::close(fd);
+      throw std::runtime_error("Invalid snapshot " + path);
+    }
+    fileSize_ = static_cast< size_type >(info.st_size);
+    void* mapping = ::mmap(nullptr, fileSize_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+      fileSize_ = 0;
+      throw std::runtime_error("Cannot map snapshot " + path);
+    }
+    data_ = static_cast< const unsigned char* >(mapping);
+    header_ = reinterpret_cast< const SnapshotHeader* >(data_);
+    try
+    {
+      validate();
+      buckets_ = reinterpret_cast< const std::uint64_t* >(data_ + header_->bucketsOffset);
+      entries_ = reinterpret_cast< const entry_t* >(data_ + header_->entriesOffset);
+      blob_ = reinterpret_cast< const char* >(data_ + header_->blobOffset);
+      verifyHash();
+    }
+    catch (...)
+    {
+      ::munmap(const_cast< unsigned char* >(data_), fileSize_);
+      throw;
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  HashMapSnapshot< Key, Value, Hash, KeyEqual >::~HashMapSnapshot()
+  {
+    if (data_)
+    {
+      ::munmap(const_cast< unsigned char* >(data_), fileSize_);
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  HashMapSnapshot< Key, Value, Hash, KeyEqual >::HashMapSnapshot(this_t&& rhs) noexcept:
+    hasher_base_t(rhs.hashFunction()),
+    key_equal_base_t(rhs.keyEqual())
+  {
+    swap(rhs);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto HashMapSnapshot< Key, Value, Hash, KeyEqual >::operator=(this_t&& rhs) noexcept -> this_t&
+  {
+    if (this != &rhs)
+    {
+      this_t tmp(std::move(rhs));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  void HashMapSnapshot< Key, Value, Hash, KeyEqual >::swap(this_t& rhs) noexcept
+  {
+    std::swap(data_, rhs.data_);
+    std::swap(fileSize_, rhs.fileSize_);
+    std::swap(header_, rhs.header_);
+    std::swap(buckets_, rhs.buckets_);
+    std::swap(entries_, rhs.entries_);
+    std::swap(blob_, rhs.blob_);
+    std::swap(this->hasher_base_t::get(), rhs.hasher_base_t::get());
+    std::swap(this->key_equal_base_t::get(), rhs.key_equal_base_t::get());
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  void HashMapSnapshot< Key, Value, Hash, KeyEqual >::validate() const
+  {
+    const SnapshotHeader& header = *header_;
+    if (std::memcmp(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic)) != 0
+      || header.version != SnapshotHeader::VERSION)
+    {
+      throw std::runtime_error("Not a hash map snapshot");
+    }
+    if (header.stringKeys != STRING_KEYS || header.keySize != sizeof(Key) || header.valueSize != sizeof(Value)
+      || header.entrySize != sizeof(entry_t))
+    {
+      throw std::runtime_error("Snapshot type mismatch");
+    }
+    if (header.fileSize != fileSize_ || header.bucketCount == 0 || header.bucketCount >= fileSize_
+      || header.size > fileSize_ / sizeof(entry_t) || header.bucketsOffset > fileSize_
+      || header.entriesOffset > fileSize_ || header.blobOffset > fileSize_)
+    {
+      throw std::runtime_error("Corrupted snapshot");
+    }
+    const std::uint64_t bucketsEnd = header.bucketsOffset + (header.bucketCount + 1) * sizeof(std::uint64_t);
+    const std::uint64_t entriesEnd = header.entriesOffset + header.size * sizeof(entry_t);
+    if (header.bucketsOffset % alignof(std::uint64_t) != 0 || header.entriesOffset % alignof(entry_t) != 0
+      || header.bucketsOffset < sizeof(SnapshotHeader) || bucketsEnd > header.entriesOffset
+      || entriesEnd > header.blobOffset || header.blobSize != fileSize_ - header.blobOffset
+      || reinterpret_cast< const std::uint64_t* >(data_ + header.bucketsOffset)[header.bucketCount] != header.size)
+    {
+      throw std::runtime_error("Corrupted snapshot");
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  void HashMapSnapshot< Key, Value, Hash, KeyEqual >::verifyHash() const
+  {
+    const std::uint64_t checked = std::min(header_->size, SnapshotHeader::HASH_CHECK_ENTRIES);
+    std::uint64_t check = 0;
+    for (const entry_t* entry = entries_; entry != entries_ + checked; ++entry)
+    {
+      if constexpr (STRING_KEYS)
+      {
+        if (entry->offset > header_->blobSize || entry->length > header_->blobSize - entry->offset)
+        {
+          throw std::runtime_error("Corrupted snapshot");
+        }
+        check = foldHash(check, hashFunction()(lookup_type(blob_ + entry->offset, entry->length)));
+      }
+      else
+      {
+        check = foldHash(check, hashFunction()(entry->key));
+      }
+    }
+    if (check != header_->hashCheck)
+    {
+      throw std::runtime_error("Snapshot was written with a different hash function");
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  std::uint64_t HashMapSnapshot< Key, Value, Hash, KeyEqual >::foldHash(const std::uint64_t check,
+    const std::uint64_t hash) noexcept
+  {
+    return splitMix(check ^ hash);
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto HashMapSnapshot< Key, Value, Hash, KeyEqual >::size() const noexcept -> size_type
+  {
+    return header_ ? header_->size : 0;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  bool HashMapSnapshot< Key, Value, Hash, KeyEqual >::empty() const noexcept
+  {
+    return size() == 0;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto HashMapSnapshot< Key, Value, Hash, KeyEqual >::bucketCount() const noexcept -> size_type
+  {
+    return header_ ? header_->bucketCount : 0;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto HashMapSnapshot< Key, Value, Hash, KeyEqual >::find(const lookup_type& key) const -> const mapped_type*
+  {
+    if (!header_)
+    {
+      return nullptr;
+    }
+    const std::uint64_t hash = hashFunction()(key);
+    const std::uint64_t bucket = hash % header_->bucketCount;
+    const std::uint64_t first = buckets_[bucket];
+    const std::uint64_t last = buckets_[bucket + 1];
+    if (first > last || last > header_->size)
+    {
+      throw std::runtime_error("Corrupted snapshot");
+    }
+    for (const entry_t* entry = entries_ + first; entry != entries_ + last; ++entry)
+    {
+      if constexpr (STRING_KEYS)
+      {
+        if (entry->hash != hash)
+        {
+          continue;
+        }
+        if (entry->offset > header_->blobSize || entry->length > header_->blobSize - entry->offset)
+        {
+          throw std::runtime_error("Corrupted snapshot");
+        }
+        if (keyEqual()(lookup_type(blob_ + entry->offset, entry->length), key))
+        {
+          return &entry->value;
+        }
+      }
+      else if (keyEqual()(entry->key, key))
+      {
+        return &entry->value;
+      }
+    }
+    return nullptr;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  bool HashMapSnapshot< Key, Value, Hash, KeyEqual >::contains(const lookup_type& key) const
+  {
+    return find(key) != nullptr;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto HashMapSnapshot< Key, Value, Hash, KeyEqual >::at(const lookup_type& key) const -> const mapped_type&
+  {
+    const mapped_type* value = find(key);
+    if (!value)
+    {
+      throw std::out_of_range("Key not found");
+    }
+    return *value;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  const Hash& HashMapSnapshot< Key, Value, Hash, KeyEqual >::hashFunction() const noexcept
+  {
+    return this->hasher_base_t::get();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  const KeyEqual& HashMapSnapshot< Key, Value, Hash, KeyEqual >::keyEqual() const noexcept
+  {
+    return this->key_equal_base_t::get();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  std::uint64_t HashMapSnapshot< Key, Value, Hash, KeyEqual >::alignOffset(const std::uint64_t offset,
+    const std::uint64_t alignment) noexcept
+  {
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class MapHash, class MapKeyEqual, class MapStats >
+  void HashMapSnapshot< Key, Value, Hash, KeyEqual >::write(
+    const HashMap< Key, Value, MapHash, MapKeyEqual, MapStats >& map, const std::string& path, const Hash& hasher)
+  {
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic));
+    header.version = SnapshotHeader::VERSION;
+    header.stringKeys = STRING_KEYS;
+    header.keySize = sizeof(Key);
+    header.valueSize = sizeof(Value);
+    header.entrySize = sizeof(entry_t);
+    header.size = map.size();
+    header.bucketCount = static_cast< std::uint64_t >(map.size() / LOAD_FACTOR) + 1;
+
+    std::vector< std::uint64_t > buckets(header.bucketCount + 1);
+    std::vector< std::uint64_t > hashes;
+    hashes.reserve(map.size());
+    for (const auto& pair: map)
+    {
+      hashes.push_back(hasher(lookup_type(pair.first)));
+      ++buckets[hashes.back() % header.bucketCount + 1];
+    }
+    for (std::uint64_t bucket = 0; bucket < header.bucketCount; ++bucket)
+    {
+      buckets[bucket + 1] += buckets[bucket];
+    }
+    std::vector< entry_t > entries(map.size());
+    std::vector< std::uint64_t > entryHashes(map.size());
+    std::vector< std::uint64_t > cursor(buckets.begin(), buckets.end() - 1);
+    std::string blob;
+    std::size_t index = 0;
+    for (const auto& pair: map)
+    {
+      const std::uint64_t hash = hashes[index++];
+      const std::uint64_t position = cursor[hash % header.bucketCount]++;
+      entry_t& entry = entries[position];
+      entryHashes[position] = hash;
+      if constexpr (STRING_KEYS)
+      {
+        entry.hash = hash;
+        entry.offset = blob.size();
+        entry.length = pair.first.size();
+        blob += pair.first;
+      }
+      else
+      {
+        std::memcpy(&entry.key, &pair.first, sizeof(Key));
+      }
+      std::memcpy(&entry.value, &pair.second, sizeof(Value));
+    }
+
+    header.bucketsOffset = alignOffset(sizeof(SnapshotHeader), alignof(std::uint64_t));
+    header.entriesOffset = alignOffset(header.bucketsOffset + buckets.size() * sizeof(std::uint64_t), alignof(entry_t));
+    header.blobOffset = header.entriesOffset + entries.size() * sizeof(entry_t);
+    header.blobSize = blob.size();
+    header.fileSize = header.blobOffset + header.blobSize;
+    for (std::uint64_t i = 0; i < std::min(header.size, SnapshotHeader::HASH_CHECK_ENTRIES); ++i)
+    {
+      header.hashCheck = foldHash(header.hashCheck, entryHashes[i]);
+    }
+
+    const std::string temporary = path + ".tmp" + std::to_string(::getpid());
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+    if (fd < 0)
+    {
+      throw std::runtime_error("Cannot create snapshot " + path);
+    }
+    const char padding[alignof(entry_t) > alignof(std::uint64_t) ? alignof(entry_t) : alignof(std::uint64_t)]{};
+    const bool written = writeAll(fd, &header, sizeof(header))
+      && writeAll(fd, padding, header.bucketsOffset - sizeof(header))
+      && writeAll(fd, buckets.data(), buckets.size() * sizeof(std::uint64_t))
+      && writeAll(fd, padding, header.entriesOffset - header.bucketsOffset - buckets.size() * sizeof(std::uint64_t))
+      && writeAll(fd, entries.data(), entries.size() * sizeof(entry_t))
+      && writeAll(fd, blob.data(), blob.size())
+      && ::fsync(fd) == 0;
+    if (::close(fd) != 0 || !written || ::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+      ::unlink(temporary.c_str());
+      throw std::runtime_error("Cannot write snapshot " + path);
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  bool HashMapSnapshot< Key, Value, Hash, KeyEqual >::writeAll(const int fd, const void* data, std::size_t size) noexcept
+  {
+    const char* bytes = static_cast< const char* >(data);
+    while (size != 0)
+    {
+      const ::ssize_t written = ::write(fd, bytes, size);
+      if (written < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        return false;
+      }
+      bytes += written;
+      size -= static_cast< std::size_t >(written);
+    }
+    return true;
+  }
+}
+#endif
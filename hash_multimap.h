@@ -0,0 +1,681 @@
+#ifndef HASH_MULTIMAP_H
+#define HASH_MULTIMAP_H
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "bucket_bitmap.h"
+#include "ebo_storage.h"
+#include "fwd_list.h"
+#include "unique_ptr.h"
+
+namespace ohantsev
+{
+  struct MultiMapKeyOf
+  {
+    template< class Pair >
+    const typename Pair::first_type& operator()(const Pair& pair) const noexcept
+    {
+      return pair.first;
+    }
+  };
+
+  struct MultiSetKeyOf
+  {
+    template< class Key >
+    const Key& operator()(const Key& key) const noexcept
+    {
+      return key;
+    }
+  };
+
+  template< class Key, class Stored, class KeyOf, class Hash = std::hash< Key >, class KeyEqual = std::equal_to< Key > >
+  class HashMultiTable: private EboStorage< Hash, HasherTag >, private EboStorage< KeyEqual, KeyEqualTag >
+  {
+  public:
+    using key_type = Key;
+    using value_type = Stored;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using size_type = std::size_t;
+    using this_t = HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >;
+
+    template< bool IsConst >
+    class TableIterator;
+
+    using iterator = TableIterator< std::is_same< Key, Stored >::value >;
+    using const_iterator = TableIterator< true >;
+
+    static constexpr double MAX_LOAD_FACTOR{ 0.7 };
+    static constexpr double EXPANSION_COEFFICIENT{ 2.0 };
+    static constexpr size_type SMALL_SIZE{ 8 };
+
+    HashMultiTable() = default;
+    explicit HashMultiTable(size_type capacity, const Hash& hasher = Hash(), const KeyEqual& equal = KeyEqual());
+    explicit HashMultiTable(const Hash& hasher, const KeyEqual& equal = KeyEqual());
+    ~HashMultiTable();
+    HashMultiTable(const this_t& rhs);
+    this_t& operator=(const this_t& rhs);
+    HashMultiTable(this_t&& rhs) noexcept;
+    this_t& operator=(this_t&& rhs) noexcept;
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+    double loadFactor() const noexcept;
+    void rehash();
+    void reserve(size_type capacity);
+    iterator insert(const value_type& value);
+    iterator insert(value_type&& value);
+    template< class... Args >
+    iterator emplace(Args&&... args);
+    bool erase(const const_iterator& iter);
+    size_type eraseAll(const Key& key);
+    void clear() noexcept;
+    iterator find(const Key& key);
+    const_iterator find(const Key& key) const;
+    size_type count(const Key& key) const;
+    std::pair< iterator, iterator > equalRange(const Key& key);
+    std::pair< const_iterator, const_iterator > equalRange(const Key& key) const;
+    const Hash& hashFunction() const noexcept;
+    const KeyEqual& keyEqual() const noexcept;
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+  private:
+    using node_t = FwdListNode< Stored >;
+    using hasher_base_t = EboStorage< Hash, HasherTag >;
+    using key_equal_base_t = EboStorage< KeyEqual, KeyEqualTag >;
+
+    size_type size_{ 0 };
+    size_type bucketCount_{ 1 };
+    UniquePtr< node_t > inline_;
+    UniquePtr< node_t >* map_{ &inline_ };
+    BucketBitmap occupied_{ 1 };
+
+    bool isSmall() const noexcept;
+    void swap(this_t& rhs) noexcept;
+    void removeContainer() noexcept;
+    void relink(size_type capacity);
+    void growIfNeeded();
+    size_type hash(const Key& key) const;
+    static const Key& keyOf(const node_t* node) noexcept;
+    UniquePtr< node_t >* findGroup(size_type bucket, const Key& key) const;
+    node_t* groupEnd(node_t* first) const;
+    iterator insertNode(UniquePtr< node_t >&& node);
+    void unlink(size_type bucket, UniquePtr< node_t >& link) noexcept;
+  };
+
+  template< class Key, class Value, class Hash = std::hash< Key >, class KeyEqual = std::equal_to< Key > >
+  using HashMultiMap = HashMultiTable< Key, std::pair< const Key, Value >, MultiMapKeyOf, Hash, KeyEqual >;
+
+  template< class Key, class Hash = std::hash< Key >, class KeyEqual = std::equal_to< Key > >
+  using HashMultiSet = HashMultiTable< Key, Key, MultiSetKeyOf, Hash, KeyEqual >;
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< bool IsConst >
+  class HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::TableIterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Stored;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t< IsConst, const Stored*, Stored* >;
+    using reference = std::conditional_t< IsConst, const Stored&, Stored& >;
+
+    TableIterator() = delete;
+    TableIterator(const TableIterator& rhs) = default;
+    TableIterator& operator=(const TableIterator& rhs) = default;
+    TableIterator(TableIterator&& rhs) = default;
+    TableIterator& operator=(TableIterator&& rhs) = default;
+    template< bool OtherConst, class = std::enable_if_t< IsConst && !OtherConst > >
+    TableIterator(const TableIterator< OtherConst >& rhs) noexcept;
+    reference operator*() const;
+    pointer operator->() const;
+    TableIterator& operator++();
+    TableIterator operator++(int);
+    bool operator==(const TableIterator& rhs) const noexcept;
+    bool operator!=(const TableIterator& rhs) const noexcept;
+
+  private:
+    friend class HashMultiTable;
+    template< bool >
+    friend class TableIterator;
+
+    node_t* current_{ nullptr };
+    size_type bucket_{ 0 };
+    const HashMultiTable* owner_{ nullptr };
+
+    TableIterator(node_t* node, size_type bucket, const HashMultiTable* owner) noexcept;
+  };
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< bool IsConst >
+  HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::TableIterator< IsConst >::
+  TableIterator(node_t* node, const size_type bucket, const HashMultiTable* owner) noexcept:
+    current_(node),
+    bucket_(bucket),
+    owner_(owner)
+  {}
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< bool IsConst >
+  template< bool OtherConst, class >
+  HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::TableIterator< IsConst >::
+  TableIterator(const TableIterator< OtherConst >& rhs) noexcept:
+    current_(rhs.current_),
+    bucket_(rhs.bucket_),
+    owner_(rhs.owner_)
+  {}
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< bool IsConst >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::TableIterator< IsConst >::
+  operator*() const -> reference
+  {
+    assert(current_ != nullptr);
+    return current_->data_;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< bool IsConst >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::TableIterator< IsConst >::
+  operator->() const -> pointer
+  {
+    return std::addressof(**this);
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< bool IsConst >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::TableIterator< IsConst >::
+  operator++() -> TableIterator&
+  {
+    if (!current_)
+    {
+      return *this;
+    }
+    if (current_->next_.get())
+    {
+      current_ = current_->next_.get();
+      return *this;
+    }
+    bucket_ = owner_->occupied_.findNext(bucket_ + 1);
+    current_ = (bucket_ < owner_->bucketCount_) ? owner_->map_[bucket_].get() : nullptr;
+    return *this;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< bool IsConst >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::TableIterator< IsConst >::
+  operator++(int) -> TableIterator
+  {
+    TableIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< bool IsConst >
+  bool HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::TableIterator< IsConst >::
+  operator==(const TableIterator& rhs) const noexcept
+  {
+    assert(owner_ != nullptr);
+    assert(rhs.owner_ != nullptr);
+    return current_ == rhs.current_;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< bool IsConst >
+  bool HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::TableIterator< IsConst >::
+  operator!=(const TableIterator& rhs) const noexcept
+  {
+    return !(*this == rhs);
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::HashMultiTable(const size_type capacity, const Hash& hasher,
+    const KeyEqual& equal):
+    hasher_base_t(hasher),
+    key_equal_base_t(equal)
+  {
+    if (capacity == 0)
+    {
+      throw std::invalid_argument("Invalid capacity");
+    }
+    const size_type tmp = static_cast< size_type >(capacity / MAX_LOAD_FACTOR) + 1;
+    BucketBitmap occupied(tmp);
+    map_ = new UniquePtr< node_t >[tmp]();
+    bucketCount_ = tmp;
+    occupied_.swap(occupied);
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::HashMultiTable(const Hash& hasher, const KeyEqual& equal):
+    hasher_base_t(hasher),
+    key_equal_base_t(equal)
+  {}
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::~HashMultiTable()
+  {
+    removeContainer();
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::HashMultiTable(const this_t& rhs):
+    hasher_base_t(rhs.hashFunction()),
+    key_equal_base_t(rhs.keyEqual())
+  {
+    this_t tmp = (rhs.size_ <= SMALL_SIZE) ? this_t(rhs.hashFunction(), rhs.keyEqual())
+      : this_t(rhs.size_, rhs.hashFunction(), rhs.keyEqual());
+    for (const value_type& value: rhs)
+    {
+      tmp.insert(value);
+    }
+    swap(tmp);
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::operator=(const this_t& rhs) -> this_t&
+  {
+    if (this != &rhs)
+    {
+      this_t tmp(rhs);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::HashMultiTable(this_t&& rhs) noexcept:
+    hasher_base_t(rhs.hashFunction()),
+    key_equal_base_t(rhs.keyEqual())
+  {
+    swap(rhs);
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::operator=(this_t&& rhs) noexcept -> this_t&
+  {
+    if (this != &rhs)
+    {
+      removeContainer();
+      swap(rhs);
+    }
+    return *this;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::size() const noexcept -> size_type
+  {
+    return size_;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  bool HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::empty() const noexcept
+  {
+    return size_ == 0;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  double HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::loadFactor() const noexcept
+  {
+    return static_cast< double >(size_) / bucketCount_;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  void HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::rehash()
+  {
+    relink(static_cast< size_type >(size_ * EXPANSION_COEFFICIENT));
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  void HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::reserve(const size_type capacity)
+  {
+    if (capacity > size_)
+    {
+      relink(capacity);
+    }
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::insert(const value_type& value) -> iterator
+  {
+    return insertNode(makeUnique< node_t >(value, UniquePtr< node_t >()));
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::insert(value_type&& value) -> iterator
+  {
+    return insertNode(makeUnique< node_t >(std::move(value), UniquePtr< node_t >()));
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  template< class... Args >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::emplace(Args&&... args) -> iterator
+  {
+    return insertNode(makeUnique< node_t >(std::in_place, std::forward< Args >(args)...));
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::insertNode(UniquePtr< node_t >&& node) -> iterator
+  {
+    growIfNeeded();
+    const Key& key = keyOf(node.get());
+    const size_type bucket = hash(key);
+    UniquePtr< node_t >* link = findGroup(bucket, key);
+    if (*link)
+    {
+      link = &groupEnd(link->get())->next_;
+    }
+    else
+    {
+      link = &map_[bucket];
+      occupied_.set(bucket);
+    }
+    node->next_ = std::move(*link);
+    *link = std::move(node);
+    ++size_;
+    return iterator{ link->get(), bucket, this };
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  bool HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::erase(const const_iterator& iter)
+  {
+    if (!iter.current_)
+    {
+      return false;
+    }
+    for (UniquePtr< node_t >* link = &map_[iter.bucket_]; *link; link = &(*link)->next_)
+    {
+      if (link->get() == iter.current_)
+      {
+        unlink(iter.bucket_, *link);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::eraseAll(const Key& key) -> size_type
+  {
+    const size_type bucket = hash(key);
+    UniquePtr< node_t >* link = findGroup(bucket, key);
+    size_type erased = 0;
+    while (*link && keyEqual()(keyOf(link->get()), key))
+    {
+      UniquePtr< node_t > next = std::move((*link)->next_);
+      *link = std::move(next);
+      ++erased;
+    }
+    size_ -= erased;
+    if (!map_[bucket])
+    {
+      occupied_.reset(bucket);
+    }
+    return erased;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  void HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::clear() noexcept
+  {
+    for (size_type i = occupied_.findFirst(); i < bucketCount_; i = occupied_.findNext(i + 1))
+    {
+      map_[i].reset();
+    }
+    occupied_.clear();
+    size_ = 0;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::find(const Key& key) -> iterator
+  {
+    const size_type bucket = hash(key);
+    node_t* first = findGroup(bucket, key)->get();
+    return first ? iterator{ first, bucket, this } : end();
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::find(const Key& key) const -> const_iterator
+  {
+    const size_type bucket = hash(key);
+    node_t* first = findGroup(bucket, key)->get();
+    return first ? const_iterator{ first, bucket, this } : cend();
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::count(const Key& key) const -> size_type
+  {
+    size_type result = 0;
+    for (node_t* node = findGroup(hash(key), key)->get(); node && keyEqual()(keyOf(node), key);
+      node = node->next_.get())
+    {
+      ++result;
+    }
+    return result;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::equalRange(const Key& key)
+    -> std::pair< iterator, iterator >
+  {
+    const size_type bucket = hash(key);
+    node_t* first = findGroup(bucket, key)->get();
+    if (!first)
+    {
+      return { end(), end() };
+    }
+    iterator last{ groupEnd(first), bucket, this };
+    return { iterator{ first, bucket, this }, ++last };
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::equalRange(const Key& key) const
+    -> std::pair< const_iterator, const_iterator >
+  {
+    const size_type bucket = hash(key);
+    node_t* first = findGroup(bucket, key)->get();
+    if (!first)
+    {
+      return { cend(), cend() };
+    }
+    const_iterator last{ groupEnd(first), bucket, this };
+    return { const_iterator{ first, bucket, this }, ++last };
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  const Hash& HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::hashFunction() const noexcept
+  {
+    return this->hasher_base_t::get();
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  const KeyEqual& HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::keyEqual() const noexcept
+  {
+    return this->key_equal_base_t::get();
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::begin() noexcept -> iterator
+  {
+    const size_type bucket = occupied_.findFirst();
+    if (bucket < bucketCount_)
+    {
+      return iterator{ map_[bucket].get(), bucket, this };
+    }
+    return end();
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::end() noexcept -> iterator
+  {
+    return iterator{ nullptr, bucketCount_, this };
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::begin() const noexcept -> const_iterator
+  {
+    return cbegin();
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::end() const noexcept -> const_iterator
+  {
+    return cend();
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::cbegin() const noexcept -> const_iterator
+  {
+    const size_type bucket = occupied_.findFirst();
+    if (bucket < bucketCount_)
+    {
+      return const_iterator{ map_[bucket].get(), bucket, this };
+    }
+    return cend();
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::cend() const noexcept -> const_iterator
+  {
+    return const_iterator{ nullptr, bucketCount_, this };
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  bool HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::isSmall() const noexcept
+  {
+    return map_ == &inline_;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  void HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::swap(this_t& rhs) noexcept
+  {
+    const bool small = isSmall();
+    const bool rhsSmall = rhs.isSmall();
+    std::swap(size_, rhs.size_);
+    std::swap(bucketCount_, rhs.bucketCount_);
+    std::swap(map_, rhs.map_);
+    std::swap(inline_, rhs.inline_);
+    occupied_.swap(rhs.occupied_);
+    std::swap(this->hasher_base_t::get(), rhs.hasher_base_t::get());
+    std::swap(this->key_equal_base_t::get(), rhs.key_equal_base_t::get());
+    if (rhsSmall)
+    {
+      map_ = &inline_;
+    }
+    if (small)
+    {
+      rhs.map_ = &rhs.inline_;
+    }
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  void HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::removeContainer() noexcept
+  {
+    clear();
+    if (!isSmall())
+    {
+      delete[] map_;
+    }
+    map_ = &inline_;
+    occupied_ = BucketBitmap(1);
+    bucketCount_ = 1;
+    size_ = 0;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  void HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::relink(const size_type capacity)
+  {
+    this_t tmp = (capacity <= SMALL_SIZE) ? this_t(hashFunction(), keyEqual())
+      : this_t(capacity, hashFunction(), keyEqual());
+    for (size_type bucket = occupied_.findFirst(); bucket < bucketCount_; bucket = occupied_.findNext(bucket + 1))
+    {
+      while (map_[bucket])
+      {
+        node_t* last = groupEnd(map_[bucket].get());
+        UniquePtr< node_t > group = std::move(map_[bucket]);
+        map_[bucket] = std::move(last->next_);
+        const size_type target = tmp.hash(keyOf(group.get()));
+        if (!tmp.map_[target])
+        {
+          tmp.occupied_.set(target);
+        }
+        last->next_ = std::move(tmp.map_[target]);
+        tmp.map_[target] = std::move(group);
+      }
+    }
+    tmp.size_ = size_;
+    removeContainer();
+    swap(tmp);
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  void HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::growIfNeeded()
+  {
+    if (isSmall() ? size_ >= SMALL_SIZE : loadFactor() >= MAX_LOAD_FACTOR)
+    {
+      rehash();
+    }
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::hash(const Key& key) const -> size_type
+  {
+    assert(bucketCount_ != 0);
+    if (isSmall())
+    {
+      return 0;
+    }
+    return hashFunction()(key) % bucketCount_;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  const Key& HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::keyOf(const node_t* node) noexcept
+  {
+    return KeyOf{}(node->data_);
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::findGroup(const size_type bucket, const Key& key) const
+    -> UniquePtr< node_t >*
+  {
+    UniquePtr< node_t >* link = &map_[bucket];
+    while (*link && !keyEqual()(keyOf(link->get()), key))
+    {
+      link = &(*link)->next_;
+    }
+    return link;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  auto HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::groupEnd(node_t* first) const -> node_t*
+  {
+    const Key& key = keyOf(first);
+    while (first->next_ && keyEqual()(keyOf(first->next_.get()), key))
+    {
+      first = first->next_.get();
+    }
+    return first;
+  }
+
+  template< class Key, class Stored, class KeyOf, class Hash, class KeyEqual >
+  void HashMultiTable< Key, Stored, KeyOf, Hash, KeyEqual >::unlink(const size_type bucket,
+    UniquePtr< node_t >& link) noexcept
+  {
+    UniquePtr< node_t > next = std::move(link->next_);
+    link = std::move(next);
+    --size_;
+    if (!map_[bucket])
+    {
+      occupied_.reset(bucket);
+    }
+  }
+}
+#endif
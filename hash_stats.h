@@ -0,0 +1,143 @@
+#ifndef HASH_STATS_H
+#define HASH_STATS_H
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace ohantsev
+{
+  struct HashStatsSnapshot
+  {
+    static constexpr std::size_t HISTOGRAM_SIZE{ 16 };
+
+    std::size_t finds{ 0 };
+    std::size_t probes{ 0 };
+    std::size_t maxProbeLength{ 0 };
+    std::size_t probeHistogram[HISTOGRAM_SIZE]{};
+    std::size_t chainHistogram[HISTOGRAM_SIZE]{};
+    std::size_t rehashes{ 0 };
+    std::chrono::nanoseconds resizeTime{ 0 };
+    std::size_t allocations{ 0 };
+    std::size_t occupiedBuckets{ 0 };
+    std::size_t peakOccupiedBuckets{ 0 };
+
+    static std::size_t histogramSlot(std::size_t length) noexcept
+    {
+      return std::min(length, HISTOGRAM_SIZE - 1);
+    }
+  };
+
+  class NoHashStats
+  {
+  public:
+    using time_point = int;
+
+    void onFind(std::size_t) const noexcept {}
+    void onAllocate(std::size_t = 1) const noexcept {}
+    void onBucketFilled() const noexcept {}
+    void onBucketEmptied() const noexcept {}
+    void onClear() const noexcept {}
+    time_point resizeStarted() const noexcept { return 0; }
+    void resizeFinished(time_point, std::size_t) const noexcept {}
+    HashStatsSnapshot snapshot() const noexcept { return {}; }
+  };
+
+  class HashStats
+  {
+  public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    void onFind(std::size_t probes) const noexcept;
+    void onAllocate(std::size_t count = 1) const noexcept;
+    void onBucketFilled() const noexcept;
+    void onBucketEmptied() const noexcept;
+    void onClear() const noexcept;
+    time_point resizeStarted() const noexcept;
+    void resizeFinished(time_point start, std::size_t occupiedBuckets) const noexcept;
+    HashStatsSnapshot snapshot() const noexcept;
+
+  private:
+    using counter_t = std::atomic< std::size_t >;
+
+    mutable counter_t finds_{ 0 };
+    mutable counter_t probes_{ 0 };
+    mutable counter_t maxProbeLength_{ 0 };
+    mutable counter_t probeHistogram_[HashStatsSnapshot::HISTOGRAM_SIZE]{};
+    mutable counter_t rehashes_{ 0 };
+    mutable std::atomic< std::chrono::nanoseconds::rep > resizeTime_{ 0 };
+    mutable counter_t allocations_{ 0 };
+    mutable counter_t occupiedBuckets_{ 0 };
+    mutable counter_t peakOccupiedBuckets_{ 0 };
+
+    static void raise(counter_t& counter, std::size_t value) noexcept;
+  };
+
+  inline void HashStats::onFind(const std::size_t probes) const noexcept
+  {
+    finds_.fetch_add(1, std::memory_order_relaxed);
+    probes_.fetch_add(probes, std::memory_order_relaxed);
+    raise(maxProbeLength_, probes);
+    probeHistogram_[HashStatsSnapshot::histogramSlot(probes)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  inline void HashStats::onAllocate(const std::size_t count) const noexcept
+  {
+    allocations_.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  inline void HashStats::onBucketFilled() const noexcept
+  {
+    raise(peakOccupiedBuckets_, occupiedBuckets_.fetch_add(1, std::memory_order_relaxed) + 1);
+  }
+
+  inline void HashStats::onBucketEmptied() const noexcept
+  {
+    occupiedBuckets_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  inline void HashStats::onClear() const noexcept
+  {
+    occupiedBuckets_.store(0, std::memory_order_relaxed);
+  }
+
+  inline auto HashStats::resizeStarted() const noexcept -> time_point
+  {
+    return std::chrono::steady_clock::now();
+  }
+
+  inline void HashStats::resizeFinished(const time_point start, const std::size_t occupiedBuckets) const noexcept
+  {
+    const auto elapsed = std::chrono::duration_cast< std::chrono::nanoseconds >(std::chrono::steady_clock::now() - start);
+    rehashes_.fetch_add(1, std::memory_order_relaxed);
+    resizeTime_.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    occupiedBuckets_.store(occupiedBuckets, std::memory_order_relaxed);
+    raise(peakOccupiedBuckets_, occupiedBuckets);
+  }
+
+  inline HashStatsSnapshot HashStats::snapshot() const noexcept
+  {
+    HashStatsSnapshot result;
+    result.finds = finds_.load(std::memory_order_relaxed);
+    result.probes = probes_.load(std::memory_order_relaxed);
+    result.maxProbeLength = maxProbeLength_.load(std::memory_order_relaxed);
+    for (std::size_t slot = 0; slot < HashStatsSnapshot::HISTOGRAM_SIZE; ++slot)
+    {
+      result.probeHistogram[slot] = probeHistogram_[slot].load(std::memory_order_relaxed);
+    }
+    result.rehashes = rehashes_.load(std::memory_order_relaxed);
+    result.resizeTime = std::chrono::nanoseconds(resizeTime_.load(std::memory_order_relaxed));
+    result.allocations = allocations_.load(std::memory_order_relaxed);
+    result.occupiedBuckets = occupiedBuckets_.load(std::memory_order_relaxed);
+    result.peakOccupiedBuckets = peakOccupiedBuckets_.load(std::memory_order_relaxed);
+    return result;
+  }
+
+  inline void HashStats::raise(counter_t& counter, const std::size_t value) noexcept
+  {
+    std::size_t current = counter.load(std::memory_order_relaxed);
+    while (current < value && !counter.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {}
+  }
+}
+#endif
@@ -0,0 +1,188 @@
+#ifndef INLINE_POOL_H
+#define INLINE_POOL_H
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ohantsev
+{
+  template< class T, std::size_t N >
+  class InlinePool
+  {
+  public:
+    static constexpr std::size_t CAPACITY{ N };
+
+    InlinePool() = default;
+    ~InlinePool();
+    InlinePool(const InlinePool&) = delete;
+    InlinePool& operator=(const InlinePool&) = delete;
+    bool full() const noexcept;
+    bool owns(const T* item) const noexcept;
+    std::size_t indexOf(const T* item) const noexcept;
+    std::size_t findFirst() const noexcept;
+    std::size_t findNext(std::size_t slot) const noexcept;
+    T* at(std::size_t slot) noexcept;
+    const T* at(std::size_t slot) const noexcept;
+    template< class... Args >
+    T* create(Args&&... args);
+    void destroy(T* item) noexcept;
+    void clear() noexcept;
+    void swap(InlinePool& rhs) noexcept;
+
+  private:
+    static_assert(N <= 32, "InlinePool tracks its slots in a 32-bit mask");
+    static_assert(N == 0 || std::is_nothrow_move_constructible< T >::value,
+      "InlinePool relocates its items and needs a non-throwing move");
+
+    struct Slot
+    {
+      alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    std::array< Slot, N > slots_;
+    std::uint32_t live_{ 0 };
+
+    bool isLive(std::size_t slot) const noexcept;
+    static void relocate(Slot& from, Slot& to) noexcept;
+  };
+
+  template< class T, std::size_t N >
+  InlinePool< T, N >::~InlinePool()
+  {
+    clear();
+  }
+
+  template< class T, std::size_t N >
+  bool InlinePool< T, N >::full() const noexcept
+  {
+    return live_ == (N == 0 ? 0 : (~std::uint32_t{ 0 } >> (32 - N)));
+  }
+
+  template< class T, std::size_t N >
+  bool InlinePool< T, N >::owns(const T* item) const noexcept
+  {
+    const void* first = slots_.data();
+    const void* last = slots_.data() + N;
+    return !std::less< const void* >()(item, first) && std::less< const void* >()(item, last);
+  }
+
+  template< class T, std::size_t N >
+  std::size_t InlinePool< T, N >::indexOf(const T* item) const noexcept
+  {
+    assert(owns(item));
+    return static_cast< std::size_t >(reinterpret_cast< const Slot* >(item) - slots_.data());
+  }
+
+  template< class T, std::size_t N >
+  bool InlinePool< T, N >::isLive(const std::size_t slot) const noexcept
+  {
+    return (live_ >> slot) & 1u;
+  }
+
+  template< class T, std::size_t N >
+  std::size_t InlinePool< T, N >::findFirst() const noexcept
+  {
+    return findNext(0);
+  }
+
+  template< class T, std::size_t N >
+  std::size_t InlinePool< T, N >::findNext(std::size_t slot) const noexcept
+  {
+    while (slot < N && !isLive(slot))
+    {
+      ++slot;
+    }
+    return slot;
+  }
+
+  template< class T, std::size_t N >
+  T* InlinePool< T, N >::at(const std::size_t slot) noexcept
+  {
+    assert(slot < N && isLive(slot));
+    return std::launder(reinterpret_cast< T* >(slots_[slot].bytes));
+  }
+
+  template< class T, std::size_t N >
+  const T* InlinePool< T, N >::at(const std::size_t slot) const noexcept
+  {
+    assert(slot < N && isLive(slot));
+    return std::launder(reinterpret_cast< const T* >(slots_[slot].bytes));
+  }
+
+  template< class T, std::size_t N >
+  template< class... Args >
+  T* InlinePool< T, N >::create(Args&&... args)
+  {
+    std::size_t slot = 0;
+    while (slot < N && isLive(slot))
+    {
+      ++slot;
+    }
+    assert(slot < N);
+    T* item = ::new (static_cast< void* >(slots_[slot].bytes)) T(std::forward< Args >(args)...);
+    live_ |= std::uint32_t{ 1 } << slot;
+    return item;
+  }
+
+  template< class T, std::size_t N >
+  void InlinePool< T, N >::destroy(T* item) noexcept
+  {
+    const std::size_t slot = indexOf(item);
+    assert(isLive(slot));
+    item->~T();
+    live_ &= ~(std::uint32_t{ 1 } << slot);
+  }
+
+  template< class T, std::size_t N >
+  void InlinePool< T, N >::clear() noexcept
+  {
+    for (std::size_t slot = findFirst(); slot < N; slot = findNext(slot + 1))
+    {
+      at(slot)->~T();
+    }
+    live_ = 0;
+  }
+
+  template< class T, std::size_t N >
+  void InlinePool< T, N >::relocate(Slot& from, Slot& to) noexcept
+  {
+    T* item = std::launder(reinterpret_cast< T* >(from.bytes));
+    ::new (static_cast< void* >(to.bytes)) T(std::move(*item));
+    item->~T();
+  }
+
+  template< class T, std::size_t N >
+  void InlinePool< T, N >::swap(InlinePool& rhs) noexcept
+  {
+    if constexpr (N > 0)
+    {
+      for (std::size_t slot = 0; slot < N; ++slot)
+      {
+        const bool live = isLive(slot);
+        const bool rhsLive = rhs.isLive(slot);
+        if (live && rhsLive)
+        {
+          Slot spare;
+          relocate(slots_[slot], spare);
+          relocate(rhs.slots_[slot], slots_[slot]);
+          relocate(spare, rhs.slots_[slot]);
+        }
+        else if (live)
+        {
+          relocate(slots_[slot], rhs.slots_[slot]);
+        }
+        else if (rhsLive)
+        {
+          relocate(rhs.slots_[slot], slots_[slot]);
+        }
+      }
+    }
+    std::swap(live_, rhs.live_);
+  }
+}
+#endif
@@ -0,0 +1,82 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ohantsev
+{
+  inline std::size_t parallelChunks(const std::size_t count, const std::size_t grain) noexcept
+  {
+    return (count + grain - 1) / grain;
+  }
+
+  inline std::size_t parallelWorkers(const std::size_t threads, const std::size_t chunks) noexcept
+  {
+    return std::max< std::size_t >(1, std::min(threads, chunks));
+  }
+
+  template< class ChunkOp >
+  void parallelForChunks(const std::size_t count, const std::size_t grain, const std::size_t threads, ChunkOp op)
+  {
+    const std::size_t chunks = parallelChunks(count, grain);
+    const std::size_t workers = parallelWorkers(threads, chunks);
+    if (workers == 1)
+    {
+      for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+      {
+        op(chunk * grain, std::min(count, (chunk + 1) * grain), 0);
+      }
+      return;
+    }
+    std::atomic< std::size_t > next{ 0 };
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto work = [&](const std::size_t worker)
+    {
+      try
+      {
+        for (std::size_t chunk = next++; chunk < chunks; chunk = next++)
+        {
+          op(chunk * grain, std::min(count, (chunk + 1) * grain), worker);
+        }
+      }
+      catch (...)
+      {
+        next = chunks;
+        std::lock_guard< std::mutex > lock(errorMutex);
+        if (!error)
+        {
+          error = std::current_exception();
+        }
+      }
+    };
+    std::vector< std::thread > pool;
+    pool.reserve(workers - 1);
+    for (std::size_t worker = 1; worker < workers; ++worker)
+    {
+      try
+      {
+        pool.emplace_back(work, worker);
+      }
+      catch (...)
+      {
+        break;
+      }
+    }
+    work(0);
+    for (std::thread& thread: pool)
+    {
+      thread.join();
+    }
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+}
+#endif
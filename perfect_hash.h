@@ -0,0 +1,612 @@
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ebo_storage.h"
+#include "unique_ptr.h"
+
+namespace ohantsev
+{
+  struct PerfectHashWorkspace
+  {
+    std::size_t* bucketStart;
+    std::size_t* cursor;
+    std::size_t* members;
+    std::size_t* order;
+    std::size_t* positions;
+    bool* taken;
+  };
+
+  struct PerfectHashBuilder
+  {
+    static constexpr std::uint64_t MAX_PILOT{ 1 << 20 };
+    static constexpr std::size_t MAX_SEEDS{ 16 };
+    static constexpr std::size_t BUCKET_DENSITY{ 5 };
+
+    static constexpr std::uint64_t mix(std::uint64_t x) noexcept
+    {
+      x += 0x9E3779B97F4A7C15ull;
+      x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+      x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+      return x ^ (x >> 31);
+    }
+
+    static constexpr std::uint64_t seed(const std::size_t attempt) noexcept
+    {
+      return mix(attempt + 1);
+    }
+
+    static constexpr std::size_t bucketCount(const std::size_t size) noexcept
+    {
+      std::size_t log = 1;
+      while ((std::size_t{ 1 } << log) < size)
+      {
+        ++log;
+      }
+      return std::max< std::size_t >(1, BUCKET_DENSITY * size / log);
+    }
+
+    static constexpr std::size_t tableSize(const std::size_t size) noexcept
+    {
+      return size + size / 50 + 1;
+    }
+
+    static constexpr std::size_t bucketOf(const std::uint64_t hash, const std::size_t buckets) noexcept
+    {
+      return static_cast< std::size_t >(((hash >> 32) * buckets) >> 32);
+    }
+
+    static constexpr std::size_t positionOf(const std::uint64_t hash, const std::uint64_t pilot,
+      const std::size_t table) noexcept
+    {
+      return static_cast< std::size_t >(((((hash ^ mix(pilot)) * 0x9E3779B97F4A7C15ull) >> 32) * table) >> 32);
+    }
+
+    static constexpr std::size_t slot(const std::uint64_t hash, const std::uint64_t seed, const std::size_t size,
+      const std::size_t buckets, const std::uint32_t* pilots, const std::size_t* remap) noexcept
+    {
+      const std::uint64_t mixed = mix(hash ^ seed);
+      const std::size_t position = positionOf(mixed, pilots[bucketOf(mixed, buckets)], tableSize(size));
+      return (position < size) ? position : remap[position - size];
+    }
+
+    static constexpr bool build(const std::uint64_t* hashes, const std::size_t size, const std::uint64_t seed,
+      std::uint32_t* pilots, std::size_t* remap, PerfectHashWorkspace work) noexcept
+    {
+      const std::size_t buckets = bucketCount(size);
+      const std::size_t table = tableSize(size);
+      for (std::size_t bucket = 0; bucket <= buckets; ++bucket)
+      {
+        work.bucketStart[bucket] = 0;
+      }
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        ++work.bucketStart[bucketOf(mix(hashes[i] ^ seed), buckets) + 1];
+      }
+      std::size_t largest = 0;
+      for (std::size_t bucket = 0; bucket < buckets; ++bucket)
+      {
+        largest = std::max(largest, work.bucketStart[bucket + 1]);
+        work.bucketStart[bucket + 1] += work.bucketStart[bucket];
+        work.cursor[bucket] = work.bucketStart[bucket];
+      }
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        work.members[work.cursor[bucketOf(mix(hashes[i] ^ seed), buckets)]++] = i;
+      }
+      std::size_t ordered = 0;
+      for (std::size_t length = largest; length > 0; --length)
+      {
+        for (std::size_t bucket = 0; bucket < buckets; ++bucket)
+        {
+          if (work.bucketStart[bucket + 1] - work.bucketStart[bucket] == length)
+          {
+            work.order[ordered++] = bucket;
+          }
+        }
+      }
+      for (std::size_t bucket = 0; bucket < buckets; ++bucket)
+      {
+        pilots[bucket] = 0;
+      }
+      for (std::size_t position = 0; position < table; ++position)
+      {
+        work.taken[position] = false;
+      }
+      for (std::size_t i = 0; i < ordered; ++i)
+      {
+        const std::size_t bucket = work.order[i];
+        const std::size_t first = work.bucketStart[bucket];
+        const std::size_t length = work.bucketStart[bucket + 1] - first;
+        bool placed = false;
+        for (std::uint64_t pilot = 0; pilot < MAX_PILOT && !placed; ++pilot)
+        {
+          placed = true;
+          for (std::size_t j = 0; j < length && placed; ++j)
+          {
+            const std::size_t position = positionOf(mix(hashes[work.members[first + j]] ^ seed), pilot, table);
+            placed = !work.taken[position];
+            for (std::size_t k = 0; k < j && placed; ++k)
+            {
+              placed = work.positions[k] != position;
+            }
+            work.positions[j] = position;
+          }
+          if (placed)
+          {
+            pilots[bucket] = static_cast< std::uint32_t >(pilot);
+            for (std::size_t j = 0; j < length; ++j)
+            {
+              work.taken[work.positions[j]] = true;
+            }
+          }
+        }
+        if (!placed)
+        {
+          return false;
+        }
+      }
+      std::size_t free = 0;
+      for (std::size_t position = size; position < table; ++position)
+      {
+        remap[position - size] = 0;
+        if (work.taken[position])
+        {
+          while (work.taken[free])
+          {
+            ++free;
+          }
+          remap[position - size] = free++;
+        }
+      }
+      return true;
+    }
+  };
+
+  class PerfectHashIndex
+  {
+  public:
+    PerfectHashIndex() = default;
+    PerfectHashIndex(const std::uint64_t* hashes, std::size_t size);
+    std::size_t size() const noexcept;
+    std::size_t operator()(std::uint64_t hash) const noexcept;
+    std::pair< std::size_t, std::size_t > range(std::uint64_t hash) const noexcept;
+    std::vector< std::size_t > positions(const std::uint64_t* hashes, std::size_t size) const;
+
+  private:
+    std::uint64_t seed_{ 0 };
+    std::size_t size_{ 0 };
+    std::size_t slots_{ 0 };
+    std::size_t buckets_{ 0 };
+    std::vector< std::uint32_t > pilots_;
+    std::vector< std::size_t > remap_;
+    std::vector< std::size_t > groupStart_;
+
+    std::size_t slot(std::uint64_t hash) const noexcept;
+  };
+
+  inline PerfectHashIndex::PerfectHashIndex(const std::uint64_t* hashes, const std::size_t size):
+    size_(size)
+  {
+    if (size == 0)
+    {
+      return;
+    }
+    std::vector< std::uint64_t > distinct(hashes, hashes + size);
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    slots_ = distinct.size();
+    buckets_ = PerfectHashBuilder::bucketCount(slots_);
+    const std::size_t buckets = buckets_;
+    const std::size_t table = PerfectHashBuilder::tableSize(slots_);
+    pilots_.resize(buckets);
+    remap_.resize(table - slots_);
+    std::vector< std::size_t > bucketStart(buckets + 1);
+    std::vector< std::size_t > cursor(buckets);
+    std::vector< std::size_t > members(slots_);
+    std::vector< std::size_t > order(buckets);
+    std::vector< std::size_t > positions(slots_);
+    UniquePtr< bool[] > taken(new bool[table]);
+    const PerfectHashWorkspace work{ bucketStart.data(), cursor.data(), members.data(), order.data(),
+      positions.data(), taken.get() };
+    bool built = false;
+    for (std::size_t attempt = 0; attempt < PerfectHashBuilder::MAX_SEEDS && !built; ++attempt)
+    {
+      seed_ = PerfectHashBuilder::seed(attempt);
+      built = PerfectHashBuilder::build(distinct.data(), slots_, seed_, pilots_.data(), remap_.data(), work);
+    }
+    if (!built)
+    {
+      throw std::runtime_error("Perfect hash construction failed");
+    }
+    if (slots_ != size_)
+    {
+      groupStart_.assign(slots_ + 1, 0);
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        ++groupStart_[slot(hashes[i]) + 1];
+      }
+      for (std::size_t i = 0; i < slots_; ++i)
+      {
+        groupStart_[i + 1] += groupStart_[i];
+      }
+    }
+  }
+
+  inline std::size_t PerfectHashIndex::size() const noexcept
+  {
+    return size_;
+  }
+
+  inline std::size_t PerfectHashIndex::slot(const std::uint64_t hash) const noexcept
+  {
+    return PerfectHashBuilder::slot(hash, seed_, slots_, buckets_, pilots_.data(), remap_.data());
+  }
+
+  inline std::size_t PerfectHashIndex::operator()(const std::uint64_t hash) const noexcept
+  {
+    return range(hash).first;
+  }
+
+  inline std::pair< std::size_t, std::size_t > PerfectHashIndex::range(const std::uint64_t hash) const noexcept
+  {
+    const std::size_t position = slot(hash);
+    if (groupStart_.empty())
+    {
+      return std::make_pair(position, position + 1);
+    }
+    return std::make_pair(groupStart_[position], groupStart_[position + 1]);
+  }
+
+  inline std::vector< std::size_t > PerfectHashIndex::positions(const std::uint64_t* hashes,
+    const std::size_t size) const
+  {
+    std::vector< std::size_t > result(size);
+    std::vector< std::size_t > cursor(groupStart_.begin(), groupStart_.end());
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      const std::size_t position = slot(hashes[i]);
+      result[i] = cursor.empty() ? position : cursor[position]++;
+    }
+    return result;
+  }
+
+  template< class Key, class Hash = std::hash< Key >, class KeyEqual = std::equal_to< Key > >
+  class FrozenHashSet: private EboStorage< Hash, HasherTag >, private EboStorage< KeyEqual, KeyEqualTag >
+  {
+  public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = std::size_t;
+    using const_iterator = typename std::vector< Key >::const_iterator;
+    using iterator = const_iterator;
+
+    FrozenHashSet() = default;
+    template< class ForwardIt >
+    FrozenHashSet(ForwardIt first, ForwardIt last, const Hash& hasher = Hash(), const KeyEqual& equal = KeyEqual());
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+    const Key* find(const Key& key) const;
+    bool contains(const Key& key) const;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const Hash& hashFunction() const noexcept;
+    const KeyEqual& keyEqual() const noexcept;
+
+  private:
+    PerfectHashIndex index_;
+    std::vector< Key > keys_;
+  };
+
+  template< class Key, class Hash, class KeyEqual >
+  template< class ForwardIt >
+  FrozenHashSet< Key, Hash, KeyEqual >::FrozenHashSet(ForwardIt first, ForwardIt last, const Hash& hasher,
+    const KeyEqual& equal):
+    EboStorage< Hash, HasherTag >(hasher),
+    EboStorage< KeyEqual, KeyEqualTag >(equal)
+  {
+    std::vector< std::uint64_t > hashes;
+    for (ForwardIt iter = first; iter != last; ++iter)
+    {
+      hashes.push_back(hashFunction()(*iter));
+    }
+    index_ = PerfectHashIndex(hashes.data(), hashes.size());
+    const std::vector< std::size_t > positions = index_.positions(hashes.data(), hashes.size());
+    std::vector< ForwardIt > slots(hashes.size(), first);
+    std::size_t i = 0;
+    for (ForwardIt iter = first; iter != last; ++iter)
+    {
+      slots[positions[i++]] = iter;
+    }
+    keys_.reserve(slots.size());
+    for (const ForwardIt& iter: slots)
+    {
+      keys_.push_back(*iter);
+    }
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  auto FrozenHashSet< Key, Hash, KeyEqual >::size() const noexcept -> size_type
+  {
+    return keys_.size();
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  bool FrozenHashSet< Key, Hash, KeyEqual >::empty() const noexcept
+  {
+    return keys_.empty();
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  const Key* FrozenHashSet< Key, Hash, KeyEqual >::find(const Key& key) const
+  {
+    if (keys_.empty())
+    {
+      return nullptr;
+    }
+    const std::pair< std::size_t, std::size_t > range = index_.range(hashFunction()(key));
+    for (std::size_t i = range.first; i != range.second; ++i)
+    {
+      if (keyEqual()(keys_[i], key))
+      {
+        return &keys_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  bool FrozenHashSet< Key, Hash, KeyEqual >::contains(const Key& key) const
+  {
+    return find(key) != nullptr;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  auto FrozenHashSet< Key, Hash, KeyEqual >::begin() const noexcept -> const_iterator
+  {
+    return keys_.begin();
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  auto FrozenHashSet< Key, Hash, KeyEqual >::end() const noexcept -> const_iterator
+  {
+    return keys_.end();
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  const Hash& FrozenHashSet< Key, Hash, KeyEqual >::hashFunction() const noexcept
+  {
+    return this->EboStorage< Hash, HasherTag >::get();
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  const KeyEqual& FrozenHashSet< Key, Hash, KeyEqual >::keyEqual() const noexcept
+  {
+    return this->EboStorage< KeyEqual, KeyEqualTag >::get();
+  }
+
+  template< class Key, class Value, class Hash = std::hash< Key >, class KeyEqual = std::equal_to< Key > >
+  class FrozenHashMap: private EboStorage< Hash, HasherTag >, private EboStorage< KeyEqual, KeyEqualTag >
+  {
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair< const Key, Value >;
+    using size_type = std::size_t;
+    using const_iterator = typename std::vector< value_type >::const_iterator;
+    using iterator = const_iterator;
+
+    FrozenHashMap() = default;
+    template< class ForwardIt >
+    FrozenHashMap(ForwardIt first, ForwardIt last, const Hash& hasher = Hash(), const KeyEqual& equal = KeyEqual());
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+    const value_type* find(const Key& key) const;
+    bool contains(const Key& key) const;
+    const mapped_type& at(const Key& key) const;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const Hash& hashFunction() const noexcept;
+    const KeyEqual& keyEqual() const noexcept;
+
+  private:
+    PerfectHashIndex index_;
+    std::vector< value_type > values_;
+  };
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  template< class ForwardIt >
+  FrozenHashMap< Key, Value, Hash, KeyEqual >::FrozenHashMap(ForwardIt first, ForwardIt last, const Hash& hasher,
+    const KeyEqual& equal):
+    EboStorage< Hash, HasherTag >(hasher),
+    EboStorage< KeyEqual, KeyEqualTag >(equal)
+  {
+    std::vector< std::uint64_t > hashes;
+    for (ForwardIt iter = first; iter != last; ++iter)
+    {
+      hashes.push_back(hashFunction()(iter->first));
+    }
+    index_ = PerfectHashIndex(hashes.data(), hashes.size());
+    const std::vector< std::size_t > positions = index_.positions(hashes.data(), hashes.size());
+    std::vector< ForwardIt > slots(hashes.size(), first);
+    std::size_t i = 0;
+    for (ForwardIt iter = first; iter != last; ++iter)
+    {
+      slots[positions[i++]] = iter;
+    }
+    values_.reserve(slots.size());
+    for (const ForwardIt& iter: slots)
+    {
+      values_.emplace_back(iter->first, iter->second);
+    }
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto FrozenHashMap< Key, Value, Hash, KeyEqual >::size() const noexcept -> size_type
+  {
+    return values_.size();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  bool FrozenHashMap< Key, Value, Hash, KeyEqual >::empty() const noexcept
+  {
+    return values_.empty();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto FrozenHashMap< Key, Value, Hash, KeyEqual >::find(const Key& key) const -> const value_type*
+  {
+    if (values_.empty())
+    {
+      return nullptr;
+    }
+    const std::pair< std::size_t, std::size_t > range = index_.range(hashFunction()(key));
+    for (std::size_t i = range.first; i != range.second; ++i)
+    {
+      if (keyEqual()(values_[i].first, key))
+      {
+        return &values_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  bool FrozenHashMap< Key, Value, Hash, KeyEqual >::contains(const Key& key) const
+  {
+    return find(key) != nullptr;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto FrozenHashMap< Key, Value, Hash, KeyEqual >::at(const Key& key) const -> const mapped_type&
+  {
+    const value_type* pair = find(key);
+    if (!pair)
+    {
+      throw std::out_of_range("Key not found");
+    }
+    return pair->second;
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto FrozenHashMap< Key, Value, Hash, KeyEqual >::begin() const noexcept -> const_iterator
+  {
+    return values_.begin();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  auto FrozenHashMap< Key, Value, Hash, KeyEqual >::end() const noexcept -> const_iterator
+  {
+    return values_.end();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  const Hash& FrozenHashMap< Key, Value, Hash, KeyEqual >::hashFunction() const noexcept
+  {
+    return this->EboStorage< Hash, HasherTag >::get();
+  }
+
+  template< class Key, class Value, class Hash, class KeyEqual >
+  const KeyEqual& FrozenHashMap< Key, Value, Hash, KeyEqual >::keyEqual() const noexcept
+  {
+    return this->EboStorage< KeyEqual, KeyEqualTag >::get();
+  }
+
+  template< class Key, std::size_t N >
+  class StaticPerfectHashSet
+  {
+  public:
+    static_assert(std::is_integral< Key >::value, "Compile-time perfect hashing supports integral keys");
+    static_assert(N > 0, "Empty compile-time key set");
+
+    static constexpr std::size_t BUCKETS{ PerfectHashBuilder::bucketCount(N) };
+    static constexpr std::size_t TABLE{ PerfectHashBuilder::tableSize(N) };
+
+    constexpr explicit StaticPerfectHashSet(const Key (&keys)[N]);
+    constexpr std::size_t size() const noexcept;
+    constexpr std::size_t indexOf(Key key) const noexcept;
+    constexpr bool contains(Key key) const noexcept;
+    constexpr const Key* begin() const noexcept;
+    constexpr const Key* end() const noexcept;
+
+  private:
+    std::uint64_t seed_{ 0 };
+    std::uint32_t pilots_[BUCKETS]{};
+    std::size_t remap_[TABLE - N]{};
+    Key keys_[N]{};
+  };
+
+  template< class Key, std::size_t N >
+  constexpr StaticPerfectHashSet< Key, N >::StaticPerfectHashSet(const Key (&keys)[N])
+  {
+    std::uint64_t hashes[N]{};
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      hashes[i] = static_cast< std::uint64_t >(keys[i]);
+    }
+    std::size_t bucketStart[BUCKETS + 1]{};
+    std::size_t cursor[BUCKETS]{};
+    std::size_t members[N]{};
+    std::size_t order[BUCKETS]{};
+    std::size_t positions[N]{};
+    bool taken[TABLE]{};
+    const PerfectHashWorkspace work{ bucketStart, cursor, members, order, positions, taken };
+    std::size_t attempt = 0;
+    seed_ = PerfectHashBuilder::seed(attempt);
+    while (!PerfectHashBuilder::build(hashes, N, seed_, pilots_, remap_, work))
+    {
+      if (++attempt == PerfectHashBuilder::MAX_SEEDS)
+      {
+        throw std::invalid_argument("Perfect hash construction failed");
+      }
+      seed_ = PerfectHashBuilder::seed(attempt);
+    }
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      keys_[indexOf(keys[i])] = keys[i];
+    }
+  }
+
+  template< class Key, std::size_t N >
+  constexpr std::size_t StaticPerfectHashSet< Key, N >::size() const noexcept
+  {
+    return N;
+  }
+
+  template< class Key, std::size_t N >
+  constexpr std::size_t StaticPerfectHashSet< Key, N >::indexOf(const Key key) const noexcept
+  {
+    return PerfectHashBuilder::slot(static_cast< std::uint64_t >(key), seed_, N, BUCKETS, pilots_, remap_);
+  }
+
+  template< class Key, std::size_t N >
+  constexpr bool StaticPerfectHashSet< Key, N >::contains(const Key key) const noexcept
+  {
+    return keys_[indexOf(key)] == key;
+  }
+
+  template< class Key, std::size_t N >
+  constexpr const Key* StaticPerfectHashSet< Key, N >::begin() const noexcept
+  {
+    return keys_;
+  }
+
+  template< class Key, std::size_t N >
+  constexpr const Key* StaticPerfectHashSet< Key, N >::end() const noexcept
+  {
+    return keys_ + N;
+  }
+
+  template< class Key, std::size_t N >
+  constexpr StaticPerfectHashSet< Key, N > makeStaticPerfectHashSet(const Key (&keys)[N])
+  {
+    return StaticPerfectHashSet< Key, N >(keys);
+  }
+}
+#endif
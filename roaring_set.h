@@ -0,0 +1,1243 @@
+#ifndef ROARING_SET_H
+#define ROARING_SET_H
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ohantsev
+{
+  class RoaringSet
+  {
+  public:
+    using key_type = std::uint32_t;
+    using value_type = std::uint32_t;
+    using size_type = std::size_t;
+
+    class Iterator;
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
+    static constexpr size_type ARRAY_LIMIT{ 4096 };
+    static constexpr size_type CHUNK_BITS{ 65536 };
+    static constexpr size_type BITMAP_WORDS{ CHUNK_BITS / 64 };
+
+    RoaringSet() = default;
+    template< class InputIt >
+    RoaringSet(InputIt first, InputIt last);
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+    bool insert(std::uint32_t key);
+    bool remove(std::uint32_t key);
+    iterator find(std::uint32_t key) const;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+    void clear() noexcept;
+    void shrinkToFit();
+    size_type memoryUsage() const noexcept;
+    RoaringSet& unite(const RoaringSet& rhs);
+    RoaringSet& intersect(const RoaringSet& rhs);
+    RoaringSet& subtract(const RoaringSet& rhs);
+
+  private:
+    enum class Kind: std::uint8_t
+    {
+      ARRAY,
+      BITMAP,
+      RUN
+    };
+
+    struct Container
+    {
+      Kind kind_{ Kind::ARRAY };
+      std::uint32_t cardinality_{ 0 };
+      std::vector< std::uint16_t > values_;
+      std::vector< std::uint64_t > words_;
+
+      bool contains(std::uint16_t low) const noexcept;
+      bool add(std::uint16_t low);
+      bool erase(std::uint16_t low);
+      std::uint32_t nextBit(std::uint32_t from) const noexcept;
+      size_type findRun(std::uint16_t low) const noexcept;
+      size_type lowerRun(std::uint16_t low) const noexcept;
+      std::uint32_t runEnd(size_type run) const noexcept;
+      size_type runCount() const noexcept;
+      bool addToRun(std::uint16_t low);
+      bool eraseFromRun(std::uint16_t low);
+      void unrunIfLarger();
+      size_type memoryUsage() const noexcept;
+      template< class Op >
+      void forEach(Op op) const;
+      void toBitmap();
+      void toArray();
+      void unrun();
+      void normalize();
+      void runOptimize();
+    };
+
+    std::vector< std::uint16_t > keys_;
+    std::vector< Container > containers_;
+    size_type size_{ 0 };
+
+    struct WordOr
+    {
+      std::uint64_t operator()(std::uint64_t x, std::uint64_t y) const noexcept
+      {
+        return x | y;
+      }
+#if defined(__SSE2__)
+      __m128i operator()(__m128i x, __m128i y) const noexcept
+      {
+        return _mm_or_si128(x, y);
+      }
+#endif
+    };
+
+    struct WordAnd
+    {
+      std::uint64_t operator()(std::uint64_t x, std::uint64_t y) const noexcept
+      {
+        return x & y;
+      }
+#if defined(__SSE2__)
+      __m128i operator()(__m128i x, __m128i y) const noexcept
+      {
+        return _mm_and_si128(x, y);
+      }
+#endif
+    };
+
+    struct WordAndNot
+    {
+      std::uint64_t operator()(std::uint64_t x, std::uint64_t y) const noexcept
+      {
+        return x & ~y;
+      }
+#if defined(__SSE2__)
+      __m128i operator()(__m128i x, __m128i y) const noexcept
+      {
+        return _mm_andnot_si128(y, x);
+      }
+#endif
+    };
+
+    size_type findContainer(std::uint16_t high) const noexcept;
+    static Container uniteContainers(const Container& lhs, const Container& rhs);
+    static Container intersectContainers(const Container& lhs, const Container& rhs);
+    static Container subtractContainers(const Container& lhs, const Container& rhs);
+    static const Container& plain(const Container& container, Container& buffer);
+    static Container bitmapOf(const Container& container);
+    template< class Op >
+    static std::uint32_t combineWords(std::uint64_t* dst, const std::uint64_t* src, Op op) noexcept;
+    static void intersectArrays(const std::vector< std::uint16_t >& lhs, const std::vector< std::uint16_t >& rhs,
+      std::vector< std::uint16_t >& out);
+    static void subtractArrays(const std::vector< std::uint16_t >& lhs, const std::vector< std::uint16_t >& rhs,
+      std::vector< std::uint16_t >& out);
+#if defined(__SSE2__)
+    static unsigned blockMatches(const std::uint16_t* lhs, const std::uint16_t* rhs) noexcept;
+#endif
+    static std::uint32_t countWords(const std::uint64_t* words) noexcept;
+    static void setRange(std::uint64_t* words, std::uint32_t first, std::uint32_t last) noexcept;
+    static bool testBit(const std::uint64_t* words, std::uint32_t bit) noexcept;
+    static std::size_t countTrailingZeros(std::uint64_t word) noexcept;
+    static std::size_t popCount(std::uint64_t word) noexcept;
+  };
+
+  class RoaringSet::Iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::uint32_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::uint32_t*;
+    using reference = const std::uint32_t&;
+
+    Iterator() = default;
+    reference operator*() const;
+    pointer operator->() const;
+    Iterator& operator++();
+    Iterator operator++(int);
+    bool operator==(const Iterator& rhs) const noexcept;
+    bool operator!=(const Iterator& rhs) const noexcept;
+
+  private:
+    friend class RoaringSet;
+
+    const RoaringSet* owner_{ nullptr };
+    size_type container_{ 0 };
+    size_type pos_{ 0 };
+    size_type offset_{ 0 };
+    std::uint32_t value_{ 0 };
+
+    Iterator(const RoaringSet* owner, size_type container, size_type pos, size_type offset) noexcept;
+    void nextContainer() noexcept;
+    void load() noexcept;
+  };
+
+  inline RoaringSet::Iterator::Iterator(const RoaringSet* owner, const size_type container, const size_type pos,
+    const size_type offset) noexcept:
+    owner_(owner),
+    container_(container),
+    pos_(pos),
+    offset_(offset)
+  {
+    load();
+  }
+
+  inline auto RoaringSet::Iterator::operator*() const -> reference
+  {
+    assert(owner_ != nullptr);
+    assert(container_ < owner_->containers_.size());
+    return value_;
+  }
+
+  inline auto RoaringSet::Iterator::operator->() const -> pointer
+  {
+    return &**this;
+  }
+
+  inline auto RoaringSet::Iterator::operator++() -> Iterator&
+  {
+    if (container_ >= owner_->containers_.size())
+    {
+      return *this;
+    }
+    const Container& container = owner_->containers_[container_];
+    switch (container.kind_)
+    {
+    case Kind::ARRAY:
+      if (++pos_ == container.values_.size())
+      {
+        nextContainer();
+      }
+      break;
+    case Kind::BITMAP:
+      pos_ = container.nextBit(static_cast< std::uint32_t >(pos_ + 1));
+      if (pos_ == CHUNK_BITS)
+      {
+        nextContainer();
+      }
+      break;
+    case Kind::RUN:
+      if (offset_ < container.values_[2 * pos_ + 1])
+      {
+        ++offset_;
+        break;
+      }
+      offset_ = 0;
+      if (2 * ++pos_ == container.values_.size())
+      {
+        nextContainer();
+      }
+      break;
+    }
+    load();
+    return *this;
+  }
+
+  inline auto RoaringSet::Iterator::operator++(int) -> Iterator
+  {
+    Iterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  inline bool RoaringSet::Iterator::operator==(const Iterator& rhs) const noexcept
+  {
+    assert(owner_ == rhs.owner_);
+    return container_ == rhs.container_ && pos_ == rhs.pos_ && offset_ == rhs.offset_;
+  }
+
+  inline bool RoaringSet::Iterator::operator!=(const Iterator& rhs) const noexcept
+  {
+    return !(*this == rhs);
+  }
+
+  inline void RoaringSet::Iterator::nextContainer() noexcept
+  {
+    ++container_;
+    pos_ = 0;
+    offset_ = 0;
+    if (container_ < owner_->containers_.size() && owner_->containers_[container_].kind_ == Kind::BITMAP)
+    {
+      pos_ = owner_->containers_[container_].nextBit(0);
+    }
+  }
+
+  inline void RoaringSet::Iterator::load() noexcept
+  {
+    if (container_ >= owner_->containers_.size())
+    {
+      return;
+    }
+    const Container& container = owner_->containers_[container_];
+    std::uint32_t low = 0;
+    switch (container.kind_)
+    {
+    case Kind::ARRAY:
+      low = container.values_[pos_];
+      break;
+    case Kind::BITMAP:
+      low = static_cast< std::uint32_t >(pos_);
+      break;
+    case Kind::RUN:
+      low = container.values_[2 * pos_] + static_cast< std::uint32_t >(offset_);
+      break;
+    }
+    value_ = (static_cast< std::uint32_t >(owner_->keys_[container_]) << 16) | low;
+  }
+
+  template< class InputIt >
+  RoaringSet::RoaringSet(InputIt first, InputIt last)
+  {
+    for (; first != last; ++first)
+    {
+      insert(*first);
+    }
+  }
+
+  inline auto RoaringSet::size() const noexcept -> size_type
+  {
+    return size_;
+  }
+
+  inline bool RoaringSet::empty() const noexcept
+  {
+    return size_ == 0;
+  }
+
+  inline bool RoaringSet::insert(const std::uint32_t key)
+  {
+    const auto high = static_cast< std::uint16_t >(key >> 16);
+    const auto at = std::lower_bound(keys_.begin(), keys_.end(), high);
+    const auto index = static_cast< size_type >(at - keys_.begin());
+    if (at == keys_.end() || *at != high)
+    {
+      containers_.emplace(containers_.begin() + index);
+      try
+      {
+        keys_.insert(at, high);
+      }
+      catch (...)
+      {
+        containers_.erase(containers_.begin() + index);
+        throw;
+      }
+    }
+    bool added = false;
+    try
+    {
+      added = containers_[index].add(static_cast< std::uint16_t >(key));
+    }
+    catch (...)
+    {
+      if (containers_[index].cardinality_ == 0)
+      {
+        keys_.erase(keys_.begin() + index);
+        containers_.erase(containers_.begin() + index);
+      }
+      throw;
+    }
+    size_ += added;
+    return added;
+  }
+
+  inline bool RoaringSet::remove(const std::uint32_t key)
+  {
+    const size_type index = findContainer(static_cast< std::uint16_t >(key >> 16));
+    if (index == keys_.size() || !containers_[index].erase(static_cast< std::uint16_t >(key)))
+    {
+      return false;
+    }
+    --size_;
+    if (containers_[index].cardinality_ == 0)
+    {
+      keys_.erase(keys_.begin() + index);
+      containers_.erase(containers_.begin() + index);
+    }
+    return true;
+  }
+
+  inline auto RoaringSet::find(const std::uint32_t key) const -> iterator
+  {
+    const size_type index = findContainer(static_cast< std::uint16_t >(key >> 16));
+    if (index == keys_.size())
+    {
+      return end();
+    }
+    const Container& container = containers_[index];
+    const auto low = static_cast< std::uint16_t >(key);
+    switch (container.kind_)
+    {
+    case Kind::ARRAY:
+    {
+      const auto at = std::lower_bound(container.values_.begin(), container.values_.end(), low);
+      if (at != container.values_.end() && *at == low)
+      {
+        return iterator{ this, index, static_cast< size_type >(at - container.values_.begin()), 0 };
+      }
+      break;
+    }
+    case Kind::BITMAP:
+      if (testBit(container.words_.data(), low))
+      {
+        return iterator{ this, index, low, 0 };
+      }
+      break;
+    case Kind::RUN:
+    {
+      const size_type run = container.findRun(low);
+      if (run != container.runCount())
+      {
+        return iterator{ this, index, run, static_cast< size_type >(low - container.values_[2 * run]) };
+      }
+      break;
+    }
+    }
+    return end();
+  }
+
+  inline auto RoaringSet::cbegin() const noexcept -> const_iterator
+  {
+    if (containers_.empty())
+    {
+      return cend();
+    }
+    const size_type pos = (containers_.front().kind_ == Kind::BITMAP) ? containers_.front().nextBit(0) : 0;
+    return const_iterator{ this, 0, pos, 0 };
+  }
+
+  inline auto RoaringSet::cend() const noexcept -> const_iterator
+  {
+    return const_iterator{ this, containers_.size(), 0, 0 };
+  }
+
+  inline auto RoaringSet::begin() const noexcept -> iterator
+  {
+    return cbegin();
+  }
+
+  inline auto RoaringSet::end() const noexcept -> iterator
+  {
+    return cend();
+  }
+
+  inline void RoaringSet::clear() noexcept
+  {
+    keys_.clear();
+    containers_.clear();
+    size_ = 0;
+  }
+
+  inline void RoaringSet::shrinkToFit()
+  {
+    for (Container& container: containers_)
+    {
+      container.runOptimize();
+    }
+    keys_.shrink_to_fit();
+    containers_.shrink_to_fit();
+  }
+
+  inline auto RoaringSet::memoryUsage() const noexcept -> size_type
+  {
+    size_type bytes = sizeof(*this) + keys_.capacity() * sizeof(std::uint16_t)
+      + containers_.capacity() * sizeof(Container);
+    for (const Container& container: containers_)
+    {
+      bytes += container.memoryUsage();
+    }
+    return bytes;
+  }
+
+  inline RoaringSet& RoaringSet::unite(const RoaringSet& rhs)
+  {
+    if (this == &rhs)
+    {
+      return *this;
+    }
+    std::vector< std::uint16_t > keys;
+    std::vector< Container > containers;
+    keys.reserve(keys_.size() + rhs.keys_.size());
+    containers.reserve(keys_.size() + rhs.keys_.size());
+    size_type size = 0;
+    size_type i = 0;
+    size_type j = 0;
+    while (i < keys_.size() || j < rhs.keys_.size())
+    {
+      if (j == rhs.keys_.size() || (i < keys_.size() && keys_[i] < rhs.keys_[j]))
+      {
+        keys.push_back(keys_[i]);
+        containers.push_back(containers_[i++]);
+      }
+      else if (i == keys_.size() || rhs.keys_[j] < keys_[i])
+      {
+        keys.push_back(rhs.keys_[j]);
+        containers.push_back(rhs.containers_[j++]);
+      }
+      else
+      {
+        keys.push_back(keys_[i]);
+        containers.push_back(uniteContainers(containers_[i++], rhs.containers_[j++]));
+      }
+      size += containers.back().cardinality_;
+    }
+    keys_.swap(keys);
+    containers_.swap(containers);
+    size_ = size;
+    return *this;
+  }
+
+  inline RoaringSet& RoaringSet::intersect(const RoaringSet& rhs)
+  {
+    if (this == &rhs)
+    {
+      return *this;
+    }
+    std::vector< std::uint16_t > keys;
+    std::vector< Container > containers;
+    size_type size = 0;
+    size_type i = 0;
+    size_type j = 0;
+    while (i < keys_.size() && j < rhs.keys_.size())
+    {
+      if (keys_[i] < rhs.keys_[j])
+      {
+        ++i;
+      }
+      else if (rhs.keys_[j] < keys_[i])
+      {
+        ++j;
+      }
+      else
+      {
+        Container container = intersectContainers(containers_[i], rhs.containers_[j]);
+        if (container.cardinality_ != 0)
+        {
+          size += container.cardinality_;
+          keys.push_back(keys_[i]);
+          containers.push_back(std::move(container));
+        }
+        ++i;
+        ++j;
+      }
+    }
+    keys_.swap(keys);
+    containers_.swap(containers);
+    size_ = size;
+    return *this;
+  }
+
+  inline RoaringSet& RoaringSet::subtract(const RoaringSet& rhs)
+  {
+    if (this == &rhs)
+    {
+      clear();
+      return *this;
+    }
+    std::vector< std::uint16_t > keys;
+    std::vector< Container > containers;
+    keys.reserve(keys_.size());
+    containers.reserve(keys_.size());
+    size_type size = 0;
+    size_type j = 0;
+    for (size_type i = 0; i < keys_.size(); ++i)
+    {
+      while (j < rhs.keys_.size() && rhs.keys_[j] < keys_[i])
+      {
+        ++j;
+      }
+      Container container = (j < rhs.keys_.size() && rhs.keys_[j] == keys_[i])
+        ? subtractContainers(containers_[i], rhs.containers_[j]) : containers_[i];
+      if (container.cardinality_ != 0)
+      {
+        size += container.cardinality_;
+        keys.push_back(keys_[i]);
+        containers.push_back(std::move(container));
+      }
+    }
+    keys_.swap(keys);
+    containers_.swap(containers);
+    size_ = size;
+    return *this;
+  }
+
+  inline auto RoaringSet::findContainer(const std::uint16_t high) const noexcept -> size_type
+  {
+    const auto at = std::lower_bound(keys_.begin(), keys_.end(), high);
+    return (at != keys_.end() && *at == high) ? static_cast< size_type >(at - keys_.begin()) : keys_.size();
+  }
+
+  inline auto RoaringSet::uniteContainers(const Container& lhs, const Container& rhs) -> Container
+  {
+    Container lhsBuffer;
+    Container rhsBuffer;
+    const Container& a = plain(lhs, lhsBuffer);
+    const Container& b = plain(rhs, rhsBuffer);
+    if (a.kind_ == Kind::ARRAY && b.kind_ == Kind::ARRAY && a.cardinality_ + b.cardinality_ <= ARRAY_LIMIT)
+    {
+      Container result;
+      result.values_.reserve(a.cardinality_ + b.cardinality_);
+      std::set_union(a.values_.begin(), a.values_.end(), b.values_.begin(), b.values_.end(),
+        std::back_inserter(result.values_));
+      result.cardinality_ = static_cast< std::uint32_t >(result.values_.size());
+      return result;
+    }
+    const bool lhsBitmap = a.kind_ == Kind::BITMAP;
+    Container result = bitmapOf(lhsBitmap ? a : b);
+    const Container& other = lhsBitmap ? b : a;
+    if (other.kind_ == Kind::BITMAP)
+    {
+      result.cardinality_ = combineWords(result.words_.data(), other.words_.data(), WordOr());
+    }
+    else
+    {
+      for (const std::uint16_t low: other.values_)
+      {
+        result.add(low);
+      }
+    }
+    result.normalize();
+    return result;
+  }
+
+  inline auto RoaringSet::intersectContainers(const Container& lhs, const Container& rhs) -> Container
+  {
+    Container lhsBuffer;
+    Container rhsBuffer;
+    const Container& a = plain(lhs, lhsBuffer);
+    const Container& b = plain(rhs, rhsBuffer);
+    Container result;
+    if (a.kind_ == Kind::BITMAP && b.kind_ == Kind::BITMAP)
+    {
+      result = a;
+      result.cardinality_ = combineWords(result.words_.data(), b.words_.data(), WordAnd());
+      result.normalize();
+    }
+    else if (a.kind_ == Kind::ARRAY && b.kind_ == Kind::ARRAY)
+    {
+      intersectArrays(a.values_, b.values_, result.values_);
+    }
+    else
+    {
+      const Container& array = (a.kind_ == Kind::ARRAY) ? a : b;
+      const Container& bitmap = (a.kind_ == Kind::ARRAY) ? b : a;
+      std::copy_if(array.values_.begin(), array.values_.end(), std::back_inserter(result.values_),
+        [&bitmap](std::uint16_t low)
+        {
+          return testBit(bitmap.words_.data(), low);
+        });
+    }
+    if (result.kind_ == Kind::ARRAY)
+    {
+      result.cardinality_ = static_cast< std::uint32_t >(result.values_.size());
+    }
+    return result;
+  }
+
+  inline auto RoaringSet::subtractContainers(const Container& lhs, const Container& rhs) -> Container
+  {
+    Container lhsBuffer;
+    Container rhsBuffer;
+    const Container& a = plain(lhs, lhsBuffer);
+    const Container& b = plain(rhs, rhsBuffer);
+    Container result;
+    if (a.kind_ == Kind::BITMAP)
+    {
+      result = a;
+      if (b.kind_ == Kind::BITMAP)
+      {
+        result.cardinality_ = combineWords(result.words_.data(), b.words_.data(), WordAndNot());
+      }
+      else
+      {
+        for (const std::uint16_t low: b.values_)
+        {
+          if (testBit(result.words_.data(), low))
+          {
+            result.words_[low / 64] &= ~(std::uint64_t{ 1 } << (low % 64));
+            --result.cardinality_;
+          }
+        }
+      }
+      result.normalize();
+      return result;
+    }
+    if (b.kind_ == Kind::ARRAY)
+    {
+      subtractArrays(a.values_, b.values_, result.values_);
+    }
+    else
+    {
+      std::copy_if(a.values_.begin(), a.values_.end(), std::back_inserter(result.values_),
+        [&b](std::uint16_t low)
+        {
+          return !testBit(b.words_.data(), low);
+        });
+    }
+    result.cardinality_ = static_cast< std::uint32_t >(result.values_.size());
+    return result;
+  }
+
+  inline auto RoaringSet::plain(const Container& container, Container& buffer) -> const Container&
+  {
+    if (container.kind_ != Kind::RUN)
+    {
+      return container;
+    }
+    buffer = container;
+    buffer.unrun();
+    return buffer;
+  }
+
+  inline auto RoaringSet::bitmapOf(const Container& container) -> Container
+  {
+    Container result = container;
+    if (result.kind_ != Kind::BITMAP)
+    {
+      result.toBitmap();
+    }
+    return result;
+  }
+
+  template< class Op >
+  std::uint32_t RoaringSet::combineWords(std::uint64_t* dst, const std::uint64_t* src, Op op) noexcept
+  {
+    size_type i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= BITMAP_WORDS; i += 2)
+    {
+      const __m128i lhs = _mm_loadu_si128(reinterpret_cast< const __m128i* >(dst + i));
+      const __m128i rhs = _mm_loadu_si128(reinterpret_cast< const __m128i* >(src + i));
+      _mm_storeu_si128(reinterpret_cast< __m128i* >(dst + i), op(lhs, rhs));
+    }
+#endif
+    for (; i < BITMAP_WORDS; ++i)
+    {
+      dst[i] = op(dst[i], src[i]);
+    }
+    return countWords(dst);
+  }
+
+#if defined(__SSE2__)
+  inline unsigned RoaringSet::blockMatches(const std::uint16_t* lhs, const std::uint16_t* rhs) noexcept
+  {
+    const __m128i lhsBlock = _mm_loadu_si128(reinterpret_cast< const __m128i* >(lhs));
+    __m128i rhsBlock = _mm_loadu_si128(reinterpret_cast< const __m128i* >(rhs));
+    __m128i matches = _mm_cmpeq_epi16(lhsBlock, rhsBlock);
+    for (int rotation = 1; rotation < 8; ++rotation)
+    {
+      rhsBlock = _mm_or_si128(_mm_srli_si128(rhsBlock, 2), _mm_slli_si128(rhsBlock, 14));
+      matches = _mm_or_si128(matches, _mm_cmpeq_epi16(lhsBlock, rhsBlock));
+    }
+    return static_cast< unsigned >(_mm_movemask_epi8(_mm_packs_epi16(matches, _mm_setzero_si128())));
+  }
+#endif
+
+  inline void RoaringSet::intersectArrays(const std::vector< std::uint16_t >& lhs,
+    const std::vector< std::uint16_t >& rhs, std::vector< std::uint16_t >& out)
+  {
+    size_type i = 0;
+    size_type j = 0;
+#if defined(__SSE2__)
+    while (i + 8 <= lhs.size() && j + 8 <= rhs.size())
+    {
+      const unsigned mask = blockMatches(lhs.data() + i, rhs.data() + j);
+      for (size_type k = 0; k < 8; ++k)
+      {
+        if (mask & (1u << k))
+        {
+          out.push_back(lhs[i + k]);
+        }
+      }
+      const std::uint16_t lhsLast = lhs[i + 7];
+      const std::uint16_t rhsLast = rhs[j + 7];
+      i += (lhsLast <= rhsLast) ? 8 : 0;
+      j += (rhsLast <= lhsLast) ? 8 : 0;
+    }
+#endif
+    while (i < lhs.size() && j < rhs.size())
+    {
+      if (lhs[i] < rhs[j])
+      {
+        ++i;
+      }
+      else if (rhs[j] < lhs[i])
+      {
+        ++j;
+      }
+      else
+      {
+        out.push_back(lhs[i]);
+        ++i;
+        ++j;
+      }
+    }
+  }
+
+  inline void RoaringSet::subtractArrays(const std::vector< std::uint16_t >& lhs,
+    const std::vector< std::uint16_t >& rhs, std::vector< std::uint16_t >& out)
+  {
+    size_type i = 0;
+    size_type j = 0;
+    unsigned matched = 0;
+#if defined(__SSE2__)
+    while (i + 8 <= lhs.size() && j + 8 <= rhs.size())
+    {
+      matched |= blockMatches(lhs.data() + i, rhs.data() + j);
+      const std::uint16_t lhsLast = lhs[i + 7];
+      const std::uint16_t rhsLast = rhs[j + 7];
+      if (lhsLast <= rhsLast)
+      {
+        for (size_type k = 0; k < 8; ++k)
+        {
+          if (!(matched & (1u << k)))
+          {
+            out.push_back(lhs[i + k]);
+          }
+        }
+        matched = 0;
+        i += 8;
+      }
+      j += (rhsLast <= lhsLast) ? 8 : 0;
+    }
+#endif
+    for (const size_type block = i; i < lhs.size(); ++i)
+    {
+      if (i - block < 8 && (matched & (1u << (i - block))))
+      {
+        continue;
+      }
+      while (j < rhs.size() && rhs[j] < lhs[i])
+      {
+        ++j;
+      }
+      if (j == rhs.size() || rhs[j] != lhs[i])
+      {
+        out.push_back(lhs[i]);
+      }
+    }
+  }
+
+  inline std::uint32_t RoaringSet::countWords(const std::uint64_t* words) noexcept
+  {
+    size_type count = 0;
+    for (size_type i = 0; i < BITMAP_WORDS; ++i)
+    {
+      count += popCount(words[i]);
+    }
+    return static_cast< std::uint32_t >(count);
+  }
+
+  inline void RoaringSet::setRange(std::uint64_t* words, const std::uint32_t first, const std::uint32_t last) noexcept
+  {
+    for (std::uint32_t word = first / 64; word <= last / 64; ++word)
+    {
+      std::uint64_t mask = ~std::uint64_t{ 0 };
+      if (word == first / 64)
+      {
+        mask &= ~std::uint64_t{ 0 } << (first % 64);
+      }
+      if (word == last / 64)
+      {
+        mask &= ~std::uint64_t{ 0 } >> (63 - last % 64);
+      }
+      words[word] |= mask;
+    }
+  }
+
+  inline bool RoaringSet::testBit(const std::uint64_t* words, const std::uint32_t bit) noexcept
+  {
+    return (words[bit / 64] >> (bit % 64)) & 1;
+  }
+
+  inline std::size_t RoaringSet::countTrailingZeros(const std::uint64_t word) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast< std::size_t >(__builtin_ctzll(word));
+#else
+    std::size_t count = 0;
+    while (!(word & (std::uint64_t{ 1 } << count)))
+    {
+      ++count;
+    }
+    return count;
+#endif
+  }
+
+  inline std::size_t RoaringSet::popCount(std::uint64_t word) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast< std::size_t >(__builtin_popcountll(word));
+#else
+    std::size_t count = 0;
+    while (word)
+    {
+      word &= word - 1;
+      ++count;
+    }
+    return count;
+#endif
+  }
+
+  inline bool RoaringSet::Container::contains(const std::uint16_t low) const noexcept
+  {
+    switch (kind_)
+    {
+    case Kind::ARRAY:
+      return std::binary_search(values_.begin(), values_.end(), low);
+    case Kind::BITMAP:
+      return testBit(words_.data(), low);
+    case Kind::RUN:
+      return findRun(low) != runCount();
+    }
+    return false;
+  }
+
+  inline bool RoaringSet::Container::add(const std::uint16_t low)
+  {
+    switch (kind_)
+    {
+    case Kind::ARRAY:
+    {
+      const auto at = std::lower_bound(values_.begin(), values_.end(), low);
+      if (at != values_.end() && *at == low)
+      {
+        return false;
+      }
+      if (cardinality_ == ARRAY_LIMIT)
+      {
+        toBitmap();
+        return add(low);
+      }
+      values_.insert(at, low);
+      break;
+    }
+    case Kind::BITMAP:
+      if (testBit(words_.data(), low))
+      {
+        return false;
+      }
+      words_[low / 64] |= std::uint64_t{ 1 } << (low % 64);
+      break;
+    case Kind::RUN:
+      return addToRun(low);
+    }
+    ++cardinality_;
+    return true;
+  }
+
+  inline bool RoaringSet::Container::erase(const std::uint16_t low)
+  {
+    switch (kind_)
+    {
+    case Kind::ARRAY:
+    {
+      const auto at = std::lower_bound(values_.begin(), values_.end(), low);
+      if (at == values_.end() || *at != low)
+      {
+        return false;
+      }
+      values_.erase(at);
+      --cardinality_;
+      return true;
+    }
+    case Kind::BITMAP:
+      if (!testBit(words_.data(), low))
+      {
+        return false;
+      }
+      words_[low / 64] &= ~(std::uint64_t{ 1 } << (low % 64));
+      if (--cardinality_ <= ARRAY_LIMIT / 2)
+      {
+        toArray();
+      }
+      return true;
+    case Kind::RUN:
+      return eraseFromRun(low);
+    }
+    return false;
+  }
+
+  inline std::uint32_t RoaringSet::Container::nextBit(const std::uint32_t from) const noexcept
+  {
+    if (from >= CHUNK_BITS)
+    {
+      return CHUNK_BITS;
+    }
+    size_type word = from / 64;
+    std::uint64_t bits = words_[word] & (~std::uint64_t{ 0 } << (from % 64));
+    while (!bits)
+    {
+      if (++word == BITMAP_WORDS)
+      {
+        return CHUNK_BITS;
+      }
+      bits = words_[word];
+    }
+    return static_cast< std::uint32_t >(word * 64 + countTrailingZeros(bits));
+  }
+
+  inline bool RoaringSet::Container::addToRun(const std::uint16_t low)
+  {
+    const size_type next = lowerRun(low);
+    if (next < runCount() && values_[2 * next] <= low)
+    {
+      return false;
+    }
+    const bool joinsPrevious = next > 0 && runEnd(next - 1) + 1 == low;
+    const bool joinsNext = next < runCount() && values_[2 * next] == low + 1u;
+    if (joinsPrevious && joinsNext)
+    {
+      values_[2 * next - 1] = static_cast< std::uint16_t >(runEnd(next) - values_[2 * next - 2]);
+      values_.erase(values_.begin() + 2 * next, values_.begin() + 2 * next + 2);
+    }
+    else if (joinsPrevious)
+    {
+      ++values_[2 * next - 1];
+    }
+    else if (joinsNext)
+    {
+      values_[2 * next] = low;
+      ++values_[2 * next + 1];
+    }
+    else
+    {
+      const std::uint16_t run[2]{ low, 0 };
+      values_.insert(values_.begin() + 2 * next, run, run + 2);
+    }
+    ++cardinality_;
+    unrunIfLarger();
+    return true;
+  }
+
+  inline bool RoaringSet::Container::eraseFromRun(const std::uint16_t low)
+  {
+    const size_type run = findRun(low);
+    if (run == runCount())
+    {
+      return false;
+    }
+    const std::uint32_t start = values_[2 * run];
+    const std::uint32_t end = runEnd(run);
+    if (start == end)
+    {
+      values_.erase(values_.begin() + 2 * run, values_.begin() + 2 * run + 2);
+    }
+    else if (low == start)
+    {
+      ++values_[2 * run];
+      --values_[2 * run + 1];
+    }
+    else if (low == end)
+    {
+      --values_[2 * run + 1];
+    }
+    else
+    {
+      const std::uint16_t tail[2]{ static_cast< std::uint16_t >(low + 1),
+        static_cast< std::uint16_t >(end - low - 1) };
+      values_.insert(values_.begin() + 2 * run + 2, tail, tail + 2);
+      values_[2 * run + 1] = static_cast< std::uint16_t >(low - start - 1);
+    }
+    --cardinality_;
+    unrunIfLarger();
+    return true;
+  }
+
+  inline void RoaringSet::Container::unrunIfLarger()
+  {
+    const size_type plain = (cardinality_ <= ARRAY_LIMIT) ? cardinality_ * sizeof(std::uint16_t)
+      : BITMAP_WORDS * sizeof(std::uint64_t);
+    if (cardinality_ != 0 && values_.size() * sizeof(std::uint16_t) > plain)
+    {
+      unrun();
+    }
+  }
+
+  inline auto RoaringSet::Container::lowerRun(const std::uint16_t low) const noexcept -> size_type
+  {
+    size_type first = 0;
+    size_type last = runCount();
+    while (first < last)
+    {
+      const size_type middle = first + (last - first) / 2;
+      if (runEnd(middle) < low)
+      {
+        first = middle + 1;
+      }
+      else
+      {
+        last = middle;
+      }
+    }
+    return first;
+  }
+
+  inline auto RoaringSet::Container::findRun(const std::uint16_t low) const noexcept -> size_type
+  {
+    const size_type run = lowerRun(low);
+    return (run < runCount() && values_[2 * run] <= low) ? run : runCount();
+  }
+
+  inline std::uint32_t RoaringSet::Container::runEnd(const size_type run) const noexcept
+  {
+    return values_[2 * run] + static_cast< std::uint32_t >(values_[2 * run + 1]);
+  }
+
+  inline auto RoaringSet::Container::runCount() const noexcept -> size_type
+  {
+    return values_.size() / 2;
+  }
+
+  inline auto RoaringSet::Container::memoryUsage() const noexcept -> size_type
+  {
+    return values_.capacity() * sizeof(std::uint16_t) + words_.capacity() * sizeof(std::uint64_t);
+  }
+
+  template< class Op >
+  void RoaringSet::Container::forEach(Op op) const
+  {
+    switch (kind_)
+    {
+    case Kind::ARRAY:
+      for (const std::uint16_t low: values_)
+      {
+        op(low);
+      }
+      break;
+    case Kind::BITMAP:
+      for (size_type word = 0; word < BITMAP_WORDS; ++word)
+      {
+        for (std::uint64_t bits = words_[word]; bits; bits &= bits - 1)
+        {
+          op(static_cast< std::uint16_t >(word * 64 + countTrailingZeros(bits)));
+        }
+      }
+      break;
+    case Kind::RUN:
+      for (size_type run = 0; run < runCount(); ++run)
+      {
+        const std::uint32_t start = values_[2 * run];
+        for (std::uint32_t low = start; low <= start + values_[2 * run + 1]; ++low)
+        {
+          op(static_cast< std::uint16_t >(low));
+        }
+      }
+      break;
+    }
+  }
+
+  inline void RoaringSet::Container::toBitmap()
+  {
+    assert(kind_ == Kind::ARRAY);
+    std::vector< std::uint64_t > words(BITMAP_WORDS);
+    for (const std::uint16_t low: values_)
+    {
+      words[low / 64] |= std::uint64_t{ 1 } << (low % 64);
+    }
+    words_.swap(words);
+    std::vector< std::uint16_t >().swap(values_);
+    kind_ = Kind::BITMAP;
+  }
+
+  inline void RoaringSet::Container::toArray()
+  {
+    assert(kind_ == Kind::BITMAP);
+    std::vector< std::uint16_t > values;
+    values.reserve(cardinality_);
+    forEach([&values](std::uint16_t low)
+    {
+      values.push_back(low);
+    });
+    values_.swap(values);
+    std::vector< std::uint64_t >().swap(words_);
+    kind_ = Kind::ARRAY;
+  }
+
+  inline void RoaringSet::Container::unrun()
+  {
+    assert(kind_ == Kind::RUN);
+    if (cardinality_ <= ARRAY_LIMIT)
+    {
+      std::vector< std::uint16_t > values;
+      values.reserve(cardinality_);
+      forEach([&values](std::uint16_t low)
+      {
+        values.push_back(low);
+      });
+      values_.swap(values);
+      kind_ = Kind::ARRAY;
+      return;
+    }
+    std::vector< std::uint64_t > words(BITMAP_WORDS);
+    for (size_type run = 0; run < runCount(); ++run)
+    {
+      setRange(words.data(), values_[2 * run], values_[2 * run] + static_cast< std::uint32_t >(values_[2 * run + 1]));
+    }
+    words_.swap(words);
+    std::vector< std::uint16_t >().swap(values_);
+    kind_ = Kind::BITMAP;
+  }
+
+  inline void RoaringSet::Container::normalize()
+  {
+    if (kind_ == Kind::BITMAP && cardinality_ <= ARRAY_LIMIT)
+    {
+      toArray();
+    }
+    else if (kind_ == Kind::ARRAY && cardinality_ > ARRAY_LIMIT)
+    {
+      toBitmap();
+    }
+  }
+
+  inline void RoaringSet::Container::runOptimize()
+  {
+    if (kind_ == Kind::RUN)
+    {
+      values_.shrink_to_fit();
+      return;
+    }
+    size_type runs = 0;
+    std::uint32_t previous = CHUNK_BITS;
+    forEach([&runs, &previous](std::uint16_t low)
+    {
+      runs += (low != previous + 1);
+      previous = low;
+    });
+    const size_type current = (kind_ == Kind::ARRAY) ? cardinality_ * sizeof(std::uint16_t)
+      : BITMAP_WORDS * sizeof(std::uint64_t);
+    if (runs * 2 * sizeof(std::uint16_t) >= current)
+    {
+      values_.shrink_to_fit();
+      return;
+    }
+    std::vector< std::uint16_t > values;
+    values.reserve(runs * 2);
+    forEach([&values](std::uint16_t low)
+    {
+      if (!values.empty() && values[values.size() - 2] + static_cast< std::uint32_t >(values.back()) + 1 == low)
+      {
+        ++values.back();
+      }
+      else
+      {
+        values.push_back(low);
+        values.push_back(0);
+      }
+    });
+    values_.swap(values);
+    std::vector< std::uint64_t >().swap(words_);
+    kind_ = Kind::RUN;
+  }
+}
+#endif
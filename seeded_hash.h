@@ -0,0 +1,149 @@
+#ifndef SEEDED_HASH_H
+#define SEEDED_HASH_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "ebo_storage.h"
+
+namespace ohantsev
+{
+  template< class Hash, class = void >
+  struct IsReseedable: std::false_type
+  {};
+
+  template< class Hash >
+  struct IsReseedable< Hash, std::void_t< decltype(std::declval< Hash& >().reseed()) > >: std::true_type
+  {};
+
+  inline std::uint64_t splitMix(std::uint64_t x) noexcept
+  {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+  }
+
+  inline std::uint64_t mulFold(const std::uint64_t a, const std::uint64_t b) noexcept
+  {
+    const std::uint64_t aLo = a & 0xFFFFFFFFull;
+    const std::uint64_t aHi = a >> 32;
+    const std::uint64_t bLo = b & 0xFFFFFFFFull;
+    const std::uint64_t bHi = b >> 32;
+    const std::uint64_t lowLow = aLo * bLo;
+    const std::uint64_t lowHigh = aLo * bHi;
+    const std::uint64_t highLow = aHi * bLo;
+    const std::uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFull) + (highLow & 0xFFFFFFFFull);
+    const std::uint64_t low = (middle << 32) | (lowLow & 0xFFFFFFFFull);
+    const std::uint64_t high = aHi * bHi + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+    return low ^ high;
+  }
+
+  inline std::uint64_t freshHashSeed()
+  {
+    static std::atomic< std::uint64_t > counter{ 0 };
+    static const std::uint64_t base = []
+    {
+      std::random_device device;
+      const std::uint64_t entropy = (static_cast< std::uint64_t >(device()) << 32) ^ device();
+      return splitMix(entropy ^ reinterpret_cast< std::uintptr_t >(&counter));
+    }();
+    return splitMix(base + counter.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed));
+  }
+
+  template< class Key, class Base = std::hash< Key > >
+  class SeededHash: private EboStorage< Base >
+  {
+  public:
+    SeededHash();
+    explicit SeededHash(std::uint64_t seed, const Base& base = Base());
+    std::size_t operator()(const Key& key) const;
+    void reseed();
+    std::uint64_t seed() const noexcept;
+    const Base& base() const noexcept;
+
+  private:
+    static constexpr std::uint64_t SECRET[4]{
+      0xA0761D6478BD642Full, 0xE7037ED1A0B428DBull, 0x8EBC6AF09C88C6E3ull, 0x589965CC75374CC3ull
+    };
+
+    std::uint64_t seed_;
+
+    std::uint64_t hashBytes(const char* data, std::size_t size) const noexcept;
+  };
+
+  template< class Key, class Base >
+  SeededHash< Key, Base >::SeededHash():
+    seed_(freshHashSeed())
+  {}
+
+  template< class Key, class Base >
+  SeededHash< Key, Base >::SeededHash(const std::uint64_t seed, const Base& base):
+    EboStorage< Base >(base),
+    seed_(seed)
+  {}
+
+  template< class Key, class Base >
+  std::size_t SeededHash< Key, Base >::operator()(const Key& key) const
+  {
+    if constexpr (std::is_integral< Key >::value || std::is_enum< Key >::value)
+    {
+      const auto word = static_cast< std::uint64_t >(key);
+      return static_cast< std::size_t >(mulFold(word ^ seed_ ^ SECRET[0], seed_ ^ SECRET[1]));
+    }
+    else if constexpr (std::is_convertible< const Key&, std::string_view >::value)
+    {
+      const std::string_view view = key;
+      return static_cast< std::size_t >(hashBytes(view.data(), view.size()));
+    }
+    else
+    {
+      const auto word = static_cast< std::uint64_t >(base()(key));
+      return static_cast< std::size_t >(mulFold(word ^ seed_ ^ SECRET[0], seed_ ^ SECRET[1]));
+    }
+  }
+
+  template< class Key, class Base >
+  std::uint64_t SeededHash< Key, Base >::hashBytes(const char* data, std::size_t size) const noexcept
+  {
+    std::uint64_t state = seed_ ^ mulFold(size ^ SECRET[0], SECRET[1]);
+    const std::size_t length = size;
+    for (; size >= 8; data += 8, size -= 8)
+    {
+      std::uint64_t word;
+      std::memcpy(&word, data, 8);
+      state = mulFold(word ^ SECRET[2] ^ seed_, state ^ SECRET[1]);
+    }
+    std::uint64_t tail = 0;
+    if (size != 0)
+    {
+      std::memcpy(&tail, data, size);
+    }
+    state = mulFold(tail ^ SECRET[3] ^ seed_, state ^ SECRET[1]);
+    return mulFold(state ^ SECRET[0], length ^ seed_ ^ SECRET[3]);
+  }
+
+  template< class Key, class Base >
+  void SeededHash< Key, Base >::reseed()
+  {
+    seed_ = freshHashSeed();
+  }
+
+  template< class Key, class Base >
+  std::uint64_t SeededHash< Key, Base >::seed() const noexcept
+  {
+    return seed_;
+  }
+
+  template< class Key, class Base >
+  const Base& SeededHash< Key, Base >::base() const noexcept
+  {
+    return this->EboStorage< Base >::get();
+  }
+}
+#endif
@@ -0,0 +1,9 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+#include <cstddef>
+
+namespace testing_support
+{
+  std::size_t allocationCount() noexcept;
+}
+#endif
@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "BinarySearchTree.h"
+
+TEST(BinarySearchTree, ProfilesDegenerateTreeDepths)
+{
+  const int count = 5000;
+  BinarySearchTree< int, TreeProfiler > tree;
+  for (int i = 0; i < count; ++i)
+  {
+    ASSERT_TRUE(tree.insert(i));
+  }
+  const TreeProfile profile = tree.profile();
+  EXPECT_EQ(profile.inserts, static_cast< std::size_t >(count));
+  for (std::size_t slot = 0; slot + 1 < TreeProfile::HISTOGRAM_SIZE; ++slot)
+  {
+    EXPECT_EQ(profile.depthHistogram[slot], 1u);
+  }
+  EXPECT_EQ(profile.depthHistogram[TreeProfile::HISTOGRAM_SIZE - 1], count - (TreeProfile::HISTOGRAM_SIZE - 1));
+  tree.clear();
+  EXPECT_EQ(tree.getNumberOfNodes(), 0);
+  EXPECT_EQ(tree.profile().depthHistogram[0], 0u);
+}
+
+TEST(BinarySearchTree, ProfilesBalancedTreeDepths)
+{
+  BinarySearchTree< int, TreeProfiler > tree;
+  for (int value: { 4, 2, 6, 1, 3, 5, 7 })
+  {
+    tree.insert(value);
+  }
+  const TreeProfile profile = tree.profile();
+  EXPECT_EQ(profile.depthHistogram[0], 1u);
+  EXPECT_EQ(profile.depthHistogram[1], 2u);
+  EXPECT_EQ(profile.depthHistogram[2], 4u);
+  EXPECT_EQ(profile.depthHistogram[3], 0u);
+}
+
+TEST(BinarySearchTree, ProfilesConcurrentSearches)
+{
+  BinarySearchTree< int, TreeProfiler > tree;
+  for (int value: { 4, 2, 6, 1, 3, 5, 7 })
+  {
+    tree.insert(value);
+  }
+  const int threads = 4;
+  const int searches = 10000;
+  std::vector< std::thread > workers;
+  for (int worker = 0; worker < threads; ++worker)
+  {
+    workers.emplace_back([&tree]()
+    {
+      for (int i = 0; i < searches; ++i)
+      {
+        tree.searchIterative(i % 8);
+      }
+    });
+  }
+  for (std::thread& worker: workers)
+  {
+    worker.join();
+  }
+  const TreeProfile profile = tree.profile();
+  EXPECT_EQ(profile.searches, static_cast< std::size_t >(threads * searches));
+  EXPECT_EQ(profile.maxSearchPath, 3u);
+}
+
+TEST(BinarySearchTree, MoveKeepsProfile)
+{
+  BinarySearchTree< int, TreeProfiler > tree;
+  for (int value: { 2, 1, 3 })
+  {
+    tree.insert(value);
+  }
+  tree.searchIterative(3);
+  BinarySearchTree< int, TreeProfiler > moved(std::move(tree));
+  EXPECT_EQ(moved.profile().inserts, 3u);
+  EXPECT_EQ(moved.profile().searches, 1u);
+  EXPECT_EQ(tree.profile().inserts, 0u);
+  tree = std::move(moved);
+  EXPECT_EQ(tree.profile().inserts, 3u);
+  EXPECT_EQ(tree.profile().maxSearchPath, 2u);
+  EXPECT_EQ(moved.profile().searches, 0u);
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "bounded_cache.h"
+
+namespace
+{
+  class LruModel
+  {
+  public:
+    explicit LruModel(std::size_t capacity):
+      capacity_(capacity)
+    {}
+
+    int* get(int key)
+    {
+      const auto found = find(key);
+      if (found == entries_.end())
+      {
+        return nullptr;
+      }
+      entries_.splice(entries_.begin(), entries_, found);
+      return &entries_.front().second;
+    }
+
+    bool put(int key, int value, std::vector< int >& evicted)
+    {
+      const auto found = find(key);
+      if (found != entries_.end())
+      {
+        found->second = value;
+        entries_.splice(entries_.begin(), entries_, found);
+        return false;
+      }
+      if (entries_.size() == capacity_)
+      {
+        evicted.push_back(entries_.back().first);
+        entries_.pop_back();
+      }
+      entries_.emplace_front(key, value);
+      return true;
+    }
+
+    bool erase(int key)
+    {
+      const auto found = find(key);
+      if (found == entries_.end())
+      {
+        return false;
+      }
+      entries_.erase(found);
+      return true;
+    }
+
+    std::size_t size() const
+    {
+      return entries_.size();
+    }
+
+  private:
+    std::size_t capacity_;
+    std::list< std::pair< int, int > > entries_;
+
+    std::list< std::pair< int, int > >::iterator find(int key)
+    {
+      return std::find_if(entries_.begin(), entries_.end(), [key](const std::pair< int, int >& entry)
+      {
+        return entry.first == key;
+      });
+    }
+  };
+
+  struct ModuloHash
+  {
+    int modulus;
+
+    std::size_t operator()(int key) const
+    {
+      return static_cast< std::size_t >(key % modulus);
+    }
+  };
+
+  struct ModuloEqual
+  {
+    int modulus;
+
+    bool operator()(int lhs, int rhs) const
+    {
+      return lhs % modulus == rhs % modulus;
+    }
+  };
+
+  struct RecordEviction
+  {
+    std::vector< int >* evicted;
+
+    void operator()(const int& key, int&) const
+    {
+      evicted->push_back(key);
+    }
+  };
+}
+
+TEST(LruCache, MatchesReferenceModel)
+{
+  std::vector< int > evicted;
+  std::vector< int > expectedEvicted;
+  ohantsev::LruCache< int, int, std::hash< int >, std::equal_to< int >, RecordEviction > cache(64,
+    RecordEviction{ &evicted });
+  LruModel model(64);
+  std::mt19937 random(21);
+  for (int step = 0; step < 20000; ++step)
+  {
+    const int key = static_cast< int >(random() % 200);
+    const int value = static_cast< int >(random());
+    switch (random() % 4)
+    {
+    case 0:
+    {
+      int* actual = cache.get(key);
+      int* expected = model.get(key);
+      ASSERT_EQ(actual == nullptr, expected == nullptr);
+      if (actual)
+      {
+        EXPECT_EQ(*actual, *expected);
+      }
+      break;
+    }
+    case 1:
+      EXPECT_EQ(cache.erase(key), model.erase(key));
+      break;
+    default:
+      EXPECT_EQ(cache.put(key, value), model.put(key, value, expectedEvicted));
+    }
+    ASSERT_EQ(cache.size(), model.size());
+  }
+  EXPECT_EQ(evicted, expectedEvicted);
+}
+
+TEST(ClockCache, StaysWithinCapacityAndKeepsReferencedEntries)
+{
+  ohantsev::ClockCache< int, std::string > cache(4);
+  for (int i = 0; i < 4; ++i)
+  {
+    cache.put(i, std::to_string(i));
+  }
+  ASSERT_NE(cache.get(0), nullptr);
+  cache.put(4, "4");
+  EXPECT_EQ(cache.size(), 4u);
+  EXPECT_TRUE(cache.contains(0));
+  EXPECT_FALSE(cache.contains(1));
+  std::mt19937 random(22);
+  for (int step = 0; step < 10000; ++step)
+  {
+    const int key = static_cast< int >(random() % 32);
+    if (random() % 2)
+    {
+      cache.put(key, std::to_string(key));
+    }
+    else if (const std::string* value = cache.get(key))
+    {
+      EXPECT_EQ(*value, std::to_string(key));
+    }
+    ASSERT_LE(cache.size(), cache.capacity());
+  }
+}
+
+TEST(ShardedCache, SplitsCapacityAcrossShards)
+{
+  ohantsev::ShardedCache< int, int > cache(100, 8);
+  EXPECT_EQ(cache.shardCount(), 8u);
+  for (int i = 0; i < 1000; ++i)
+  {
+    cache.put(i, i * 2);
+  }
+  EXPECT_LE(cache.size(), 100u);
+  EXPECT_EQ(cache.get(999), 1998);
+  EXPECT_TRUE(cache.erase(999));
+  EXPECT_FALSE(cache.get(999).has_value());
+  EXPECT_THROW((ohantsev::ShardedCache< int, int >(4, 8)), std::invalid_argument);
+}
+
+TEST(LruCache, UsesHasherAndComparatorInstances)
+{
+  ohantsev::LruCache< int, int, ModuloHash, ModuloEqual > cache(8, ohantsev::NoEviction(), ModuloHash{ 10 },
+    ModuloEqual{ 10 });
+  EXPECT_EQ(cache.hashFunction().modulus, 10);
+  EXPECT_EQ(cache.keyEqual().modulus, 10);
+  EXPECT_TRUE(cache.put(3, 30));
+  EXPECT_FALSE(cache.put(13, 130));
+  ASSERT_NE(cache.get(23), nullptr);
+  EXPECT_EQ(*cache.get(23), 130);
+  EXPECT_EQ(cache.size(), 1u);
+  ohantsev::ShardedCache< int, int, ohantsev::LruPolicy, ModuloHash, ModuloEqual > sharded(16, 4,
+    ohantsev::NoEviction(), ModuloHash{ 10 }, ModuloEqual{ 10 });
+  EXPECT_EQ(sharded.hashFunction().modulus, 10);
+  EXPECT_TRUE(sharded.put(7, 70));
+  EXPECT_FALSE(sharded.put(17, 170));
+  EXPECT_EQ(sharded.get(27), 170);
+  EXPECT_EQ(sharded.size(), 1u);
+}
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "allocation_counter.h"
+#include "DictionaryList.h"
+
+namespace
+{
+  using list_t = DictionaryList< int >;
+
+  std::string print(const list_t& list)
+  {
+    std::ostringstream out;
+    out << list;
+    return out.str();
+  }
+
+  std::string printReversed(const list_t& list)
+  {
+    std::ostringstream out;
+    list.reversePrint(out);
+    return out.str();
+  }
+
+  template< class Range >
+  std::string print(const Range& keys)
+  {
+    std::ostringstream out;
+    bool first = true;
+    for (const int key: keys)
+    {
+      out << (first ? "" : " ") << key;
+      first = false;
+    }
+    return out.str();
+  }
+
+  std::string printReversed(const std::set< int >& keys)
+  {
+    return print(std::set< int, std::greater< int > >(keys.begin(), keys.end()));
+  }
+
+  list_t makeList(const std::set< int >& keys)
+  {
+    list_t list;
+    for (const int key: keys)
+    {
+      list.insertItem(key);
+    }
+    return list;
+  }
+
+  std::set< int > randomKeys(std::mt19937& random, const std::size_t count, const int range)
+  {
+    std::set< int > keys;
+    while (keys.size() < count)
+    {
+      keys.insert(static_cast< int >(random() % range));
+    }
+    return keys;
+  }
+
+  const std::size_t SIZES[] = { 0, 1, 7, 300, 2000 };
+
+  struct KWayInput
+  {
+    std::vector< list_t > lists;
+    std::vector< const list_t* > pointers;
+    std::set< int > united;
+    std::set< int > shared;
+  };
+
+  KWayInput makeKWayInput(std::mt19937& random, const std::size_t count, const std::size_t size, const int range)
+  {
+    KWayInput input;
+    std::vector< std::set< int > > keys;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      const std::size_t listSize = std::min< std::size_t >(size + random() % (size + 1), range);
+      keys.push_back(randomKeys(random, listSize, range));
+      input.lists.push_back(makeList(keys.back()));
+      input.united.insert(keys.back().begin(), keys.back().end());
+    }
+    for (const int key: input.united)
+    {
+      const bool everywhere = std::all_of(keys.begin(), keys.end(), [key](const std::set< int >& list)
+      {
+        return list.count(key) == 1;
+      });
+      if (everywhere)
+      {
+        input.shared.insert(key);
+      }
+    }
+    for (const list_t& list: input.lists)
+    {
+      input.pointers.push_back(&list);
+    }
+    return input;
+  }
+
+  const std::size_t THREADS[] = { 1, 2, 4, 7 };
+}
+
+TEST(DictionaryList, MergeRvalueSplicesNodes)
+{
+  std::mt19937 random(1);
+  for (const std::size_t firstSize: SIZES)
+  {
+    for (const std::size_t secondSize: SIZES)
+    {
+      const int range = static_cast< int >(2 * std::max(firstSize, secondSize) + 2);
+      const std::set< int > first = randomKeys(random, firstSize, range);
+      const std::set< int > second = randomKeys(random, secondSize, range);
+      std::set< int > united(first);
+      united.insert(second.begin(), second.end());
+
+      list_t merged = makeList(first);
+      list_t other = makeList(second);
+      const std::size_t before = testing_support::allocationCount();
+      merged.merge(std::move(other));
+      EXPECT_EQ(testing_support::allocationCount() - before, 0u);
+      EXPECT_EQ(print(merged), print(united));
+      EXPECT_EQ(printReversed(merged), printReversed(united));
+      EXPECT_EQ(print(other), "");
+      EXPECT_EQ(printReversed(other), "");
+      EXPECT_TRUE(other.insertItem(1));
+      EXPECT_EQ(print(other), "1");
+    }
+  }
+}
+
+TEST(DictionaryList, MergeRvalueWithItselfKeepsItems)
+{
+  const std::set< int > keys = { 1, 2, 3 };
+  list_t list = makeList(keys);
+  list.merge(std::move(list));
+  EXPECT_EQ(print(list), print(keys));
+  EXPECT_EQ(printReversed(list), printReversed(keys));
+}
+
+TEST(DictionaryList, SpliceIntersectionMovesSharedNodes)
+{
+  std::mt19937 random(2);
+  for (const std::size_t firstSize: SIZES)
+  {
+    for (const std::size_t secondSize: SIZES)
+    {
+      const int range = static_cast< int >(2 * std::max(firstSize, secondSize) + 2);
+      const std::set< int > first = randomKeys(random, firstSize, range);
+      const std::set< int > second = randomKeys(random, secondSize, range);
+      std::set< int > intersection;
+      std::set_intersection(first.begin(), first.end(), second.begin(), second.end(),
+        std::inserter(intersection, intersection.end()));
+      std::set< int > difference;
+      std::set_difference(first.begin(), first.end(), second.begin(), second.end(),
+        std::inserter(difference, difference.end()));
+
+      list_t remaining = makeList(first);
+      const list_t other = makeList(second);
+      const std::size_t before = testing_support::allocationCount();
+      list_t shared = spliceIntersection(remaining, other);
+      EXPECT_EQ(testing_support::allocationCount() - before, 0u);
+      EXPECT_EQ(print(shared), print(intersection));
+      EXPECT_EQ(printReversed(shared), printReversed(intersection));
+      EXPECT_EQ(print(remaining), print(difference));
+      EXPECT_EQ(printReversed(remaining), printReversed(difference));
+      EXPECT_EQ(print(other), print(second));
+      EXPECT_EQ(print(getIntersection(makeList(first), other)), print(intersection));
+    }
+  }
+}
+
+TEST(DictionaryList, MergeAllMatchesUnion)
+{
+  std::mt19937 random(3);
+  for (const std::size_t count: { 0, 1, 2, 3, 8, 17 })
+  {
+    for (const std::size_t size: { 0, 1, 50, 3000 })
+    {
+      const KWayInput input = makeKWayInput(random, count, size, static_cast< int >(4 * size + 4));
+      for (const std::size_t threads: THREADS)
+      {
+        const list_t merged = list_t::mergeAll(input.pointers.data(), count, threads);
+        EXPECT_EQ(print(merged), print(input.united)) << count << " lists, " << threads << " threads";
+        EXPECT_EQ(printReversed(merged), printReversed(input.united));
+      }
+    }
+  }
+}
+
+TEST(DictionaryList, IntersectAllMatchesCommonKeys)
+{
+  std::mt19937 random(4);
+  for (const std::size_t count: { 0, 1, 2, 3, 8, 17 })
+  {
+    for (const std::size_t size: { 0, 1, 50, 3000 })
+    {
+      const KWayInput input = makeKWayInput(random, count, size, static_cast< int >(size + 2));
+      for (const std::size_t threads: THREADS)
+      {
+        const list_t shared = list_t::intersectAll(input.pointers.data(), count, threads);
+        EXPECT_EQ(print(shared), print(input.shared)) << count << " lists, " << threads << " threads";
+        EXPECT_EQ(printReversed(shared), printReversed(input.shared));
+      }
+    }
+  }
+}
+
+TEST(DictionaryList, KWayLeavesInputsIntact)
+{
+  std::mt19937 random(5);
+  const KWayInput input = makeKWayInput(random, 5, 1000, 3000);
+  std::vector< std::string > before;
+  for (const list_t& list: input.lists)
+  {
+    before.push_back(print(list));
+  }
+  list_t::mergeAll(input.pointers.data(), input.pointers.size(), 4);
+  list_t::intersectAll(input.pointers.data(), input.pointers.size(), 4);
+  for (std::size_t i = 0; i < input.lists.size(); ++i)
+  {
+    EXPECT_EQ(print(input.lists[i]), before[i]);
+  }
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <gtest/gtest.h>
+#include "expiring_map.h"
+
+namespace
+{
+  struct Entry
+  {
+    int value;
+    std::uint64_t deadline;
+  };
+
+  std::uint64_t randomDeadline(std::mt19937_64& random, std::uint64_t now)
+  {
+    switch (random() % 4)
+    {
+    case 0:
+      return now + random() % 64;
+    case 1:
+      return now + random() % 100000;
+    case 2:
+      return now + random() % (std::uint64_t{ 1 } << 40);
+    default:
+      return now - std::min< std::uint64_t >(now, random() % 8);
+    }
+  }
+}
+
+TEST(ExpiringMap, MatchesReferenceModel)
+{
+  std::mt19937_64 random(31);
+  std::uint64_t now = 1000;
+  ohantsev::ExpiringMap< int, int > map(now);
+  std::map< int, Entry > expected;
+  for (int step = 0; step < 30000; ++step)
+  {
+    const int key = static_cast< int >(random() % 300);
+    switch (random() % 6)
+    {
+    case 0:
+    case 1:
+    {
+      const int value = static_cast< int >(random());
+      const std::uint64_t deadline = randomDeadline(random, now);
+      EXPECT_EQ(map.put(key, value, deadline), expected.count(key) == 0);
+      expected[key] = Entry{ value, deadline };
+      break;
+    }
+    case 2:
+    {
+      const std::uint64_t deadline = randomDeadline(random, now);
+      const auto found = expected.find(key);
+      EXPECT_EQ(map.expireAt(key, deadline), found != expected.end());
+      if (found != expected.end())
+      {
+        found->second.deadline = deadline;
+      }
+      break;
+    }
+    case 3:
+      EXPECT_EQ(map.erase(key), expected.erase(key) == 1);
+      break;
+    case 4:
+    {
+      const int* value = map.find(key);
+      const auto found = expected.find(key);
+      const bool live = found != expected.end() && found->second.deadline > now;
+      ASSERT_EQ(value != nullptr, live);
+      if (live)
+      {
+        EXPECT_EQ(*value, found->second.value);
+      }
+      break;
+    }
+    default:
+    {
+      now += (random() % 8 == 0) ? random() % (std::uint64_t{ 1 } << 30) : random() % 200;
+      std::set< int > expired;
+      const auto count = map.advance(now, [&expired](const int& expiredKey, int&)
+      {
+        expired.insert(expiredKey);
+      });
+      std::set< int > expectedExpired;
+      for (auto iter = expected.begin(); iter != expected.end();)
+      {
+        if (iter->second.deadline <= now)
+        {
+          expectedExpired.insert(iter->first);
+          iter = expected.erase(iter);
+        }
+        else
+        {
+          ++iter;
+        }
+      }
+      EXPECT_EQ(count, expectedExpired.size());
+      EXPECT_EQ(expired, expectedExpired);
+      EXPECT_EQ(map.now(), now);
+    }
+    }
+    ASSERT_EQ(map.size(), expected.size());
+  }
+}
+
+TEST(ExpiringMap, ReportsDeadlines)
+{
+  ohantsev::ExpiringMap< std::string, int > map(0, 1);
+  EXPECT_TRUE(map.put("a", 1, 10));
+  EXPECT_FALSE(map.put("a", 2, 20));
+  ASSERT_NE(map.deadline("a"), nullptr);
+  EXPECT_EQ(*map.deadline("a"), 20u);
+  EXPECT_EQ(map.advance(19), 0u);
+  EXPECT_EQ(*map.find("a"), 2);
+  EXPECT_EQ(map.advance(20), 1u);
+  EXPECT_TRUE(map.empty());
+  EXPECT_THROW((ohantsev::ExpiringMap< int, int >(0, 0)), std::invalid_argument);
+}
+
+namespace
+{
+  struct ModuloHash
+  {
+    int modulus;
+
+    std::size_t operator()(int key) const
+    {
+      return static_cast< std::size_t >(key % modulus);
+    }
+  };
+
+  struct ModuloEqual
+  {
+    int modulus;
+
+    bool operator()(int lhs, int rhs) const
+    {
+      return lhs % modulus == rhs % modulus;
+    }
+  };
+}
+
+TEST(ExpiringMap, UsesHasherAndComparatorInstances)
+{
+  ohantsev::ExpiringMap< int, int, ModuloHash, ModuloEqual > map(0, 1, ModuloHash{ 10 }, ModuloEqual{ 10 });
+  EXPECT_EQ(map.hashFunction().modulus, 10);
+  EXPECT_EQ(map.keyEqual().modulus, 10);
+  for (int i = 0; i < 50; ++i)
+  {
+    map.put(i, i, 100);
+  }
+  EXPECT_EQ(map.size(), 10u);
+  ASSERT_NE(map.find(3), nullptr);
+  EXPECT_EQ(*map.find(3), 43);
+  EXPECT_TRUE(map.erase(13));
+  EXPECT_EQ(map.find(43), nullptr);
+}
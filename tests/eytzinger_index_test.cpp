@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <set>
+#include <vector>
+#include <gtest/gtest.h>
+#include "BinarySearchTree.h"
+#include "DictionaryList.h"
+#include "EytzingerIndex.h"
+
+namespace
+{
+  std::vector< int > randomSorted(std::mt19937& random, const std::size_t count)
+  {
+    std::set< int > keys;
+    while (keys.size() < count)
+    {
+      keys.insert(static_cast< int >(random() % (4 * count + 1)) * 2);
+    }
+    return std::vector< int >(keys.begin(), keys.end());
+  }
+
+  void expectMatchesSorted(const EytzingerIndex< int >& index, const std::vector< int >& sorted)
+  {
+    ASSERT_EQ(index.size(), sorted.size());
+    const int last = sorted.empty() ? 0 : sorted.back();
+    for (int probe = -3; probe <= last + 3; ++probe)
+    {
+      const auto lower = std::lower_bound(sorted.begin(), sorted.end(), probe);
+      const auto upper = std::upper_bound(sorted.begin(), sorted.end(), probe);
+      const int* foundLower = index.lowerBound(probe);
+      const int* foundUpper = index.upperBound(probe);
+      ASSERT_EQ(foundLower == nullptr, lower == sorted.end()) << probe;
+      ASSERT_EQ(foundUpper == nullptr, upper == sorted.end()) << probe;
+      if (foundLower)
+      {
+        EXPECT_EQ(*foundLower, *lower) << probe;
+      }
+      if (foundUpper)
+      {
+        EXPECT_EQ(*foundUpper, *upper) << probe;
+      }
+      EXPECT_EQ(index.contains(probe), lower != upper) << probe;
+    }
+  }
+
+  std::size_t countBetween(const std::vector< int >& sorted, const int low, const int high)
+  {
+    if (high < low)
+    {
+      return 0;
+    }
+    return std::upper_bound(sorted.begin(), sorted.end(), high) - std::lower_bound(sorted.begin(), sorted.end(), low);
+  }
+}
+
+TEST(EytzingerIndex, MatchesSortedArrayBounds)
+{
+  std::mt19937 random(1);
+  for (std::size_t size = 0; size <= 70; ++size)
+  {
+    const std::vector< int > sorted = randomSorted(random, size);
+    expectMatchesSorted(EytzingerIndex< int >(sorted.data(), sorted.size()), sorted);
+  }
+  const std::vector< int > large = randomSorted(random, 5000);
+  expectMatchesSorted(EytzingerIndex< int >(large.data(), large.size()), large);
+}
+
+TEST(EytzingerIndex, CountsNodesBetweenBounds)
+{
+  std::mt19937 random(2);
+  for (const std::size_t size: { 0, 1, 2, 7, 8, 31, 100, 1000 })
+  {
+    const std::vector< int > sorted = randomSorted(random, size);
+    const EytzingerIndex< int > index(sorted.data(), sorted.size());
+    const int span = static_cast< int >(8 * size + 8);
+    for (int step = 0; step < 500; ++step)
+    {
+      const int low = static_cast< int >(random() % span) - 4;
+      const int high = static_cast< int >(random() % span) - 4;
+      EXPECT_EQ(index.countNodesBetween(low, high), countBetween(sorted, low, high)) << low << ' ' << high;
+    }
+  }
+}
+
+TEST(EytzingerIndex, FreezeMatchesBinarySearchTree)
+{
+  std::mt19937 random(3);
+  BinarySearchTree< int > tree;
+  std::set< int > keys;
+  for (int i = 0; i < 2000; ++i)
+  {
+    const int key = static_cast< int >(random() % 6000);
+    EXPECT_EQ(tree.insert(key), keys.insert(key).second);
+  }
+  const std::vector< int > sorted(keys.begin(), keys.end());
+  const EytzingerIndex< int > index = tree.freeze();
+  expectMatchesSorted(index, sorted);
+  for (int step = 0; step < 500; ++step)
+  {
+    const int low = static_cast< int >(random() % 6100) - 50;
+    const int high = static_cast< int >(random() % 6100) - 50;
+    EXPECT_EQ(index.countNodesBetween(low, high), tree.countNodesBetween(low, high)) << low << ' ' << high;
+    EXPECT_EQ(index.countNodesBetween(low, high), countBetween(sorted, low, high)) << low << ' ' << high;
+  }
+  EXPECT_EQ(BinarySearchTree< int >().freeze().size(), 0u);
+}
+
+TEST(EytzingerIndex, FreezeMatchesDictionaryList)
+{
+  std::mt19937 random(4);
+  DictionaryList< int > list;
+  std::set< int > keys;
+  for (int i = 0; i < 500; ++i)
+  {
+    const int key = static_cast< int >(random() % 1500);
+    EXPECT_EQ(list.insertItem(key), keys.insert(key).second);
+  }
+  const std::vector< int > sorted(keys.begin(), keys.end());
+  const EytzingerIndex< int > index = list.freeze();
+  expectMatchesSorted(index, sorted);
+  EXPECT_EQ(index.countNodesBetween(sorted.front(), sorted.back()), sorted.size());
+  EXPECT_EQ(index.countNodesBetween(sorted.back(), sorted.front()), 0u);
+  EXPECT_EQ(DictionaryList< int >().freeze().size(), 0u);
+}
+
+TEST(EytzingerIndex, MovesOwnership)
+{
+  const int sorted[] = { 1, 3, 5, 7 };
+  EytzingerIndex< int > index(sorted, 4);
+  EytzingerIndex< int > moved(std::move(index));
+  EXPECT_EQ(index.size(), 0u);
+  EXPECT_TRUE(moved.contains(5));
+  index = std::move(moved);
+  EXPECT_EQ(moved.size(), 0u);
+  EXPECT_EQ(index.countNodesBetween(2, 7), 3u);
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "FlatDictionaryList.h"
+
+namespace
+{
+  using SimdList = FlatDictionaryList< int >;
+  using ScalarList = FlatDictionaryList< long long >;
+
+  const std::size_t SIZES[] = { 0, 1, 3, 4, 5, 8, 17, 64, 200, 1000, 6000 };
+
+  template< class T >
+  std::string print(const T& printable)
+  {
+    std::ostringstream out;
+    out << printable;
+    return out.str();
+  }
+
+  std::string print(const std::vector< int >& keys)
+  {
+    std::ostringstream out;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      out << (i ? " " : "") << keys[i];
+    }
+    return out.str();
+  }
+
+  std::vector< int > randomKeys(std::mt19937& random, const std::size_t count, const int range)
+  {
+    std::set< int > keys;
+    while (keys.size() < count)
+    {
+      keys.insert(static_cast< int >(random() % (2 * range + 1)) - range);
+    }
+    return std::vector< int >(keys.begin(), keys.end());
+  }
+
+  template< class List >
+  List makeList(const std::vector< int >& keys)
+  {
+    List list;
+    for (const int key: keys)
+    {
+      list.insertItem(key);
+    }
+    return list;
+  }
+
+  template< class Check >
+  void forEachPair(const unsigned seed, Check check)
+  {
+    std::mt19937 random(seed);
+    for (const std::size_t firstSize: SIZES)
+    {
+      for (const std::size_t secondSize: SIZES)
+      {
+        const int range = static_cast< int >(std::max(firstSize, secondSize) + 4);
+        for (const int spread: { range, 4 * range })
+        {
+          check(randomKeys(random, firstSize, spread), randomKeys(random, secondSize, spread));
+        }
+      }
+    }
+  }
+}
+
+TEST(FlatDictionaryList, IntersectionMatchesScalarAndReference)
+{
+  forEachPair(1, [](const std::vector< int >& first, const std::vector< int >& second)
+  {
+    std::vector< int > expected;
+    std::set_intersection(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(expected));
+    const std::string simd = print(getIntersection(makeList< SimdList >(first), makeList< SimdList >(second)));
+    const std::string scalar = print(getIntersection(makeList< ScalarList >(first), makeList< ScalarList >(second)));
+    EXPECT_EQ(simd, print(expected)) << first.size() << " x " << second.size();
+    EXPECT_EQ(scalar, print(expected)) << first.size() << " x " << second.size();
+  });
+}
+
+TEST(FlatDictionaryList, DifferenceMatchesScalarAndReference)
+{
+  forEachPair(2, [](const std::vector< int >& first, const std::vector< int >& second)
+  {
+    std::vector< int > expected;
+    std::set_difference(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(expected));
+    SimdList simd = makeList< SimdList >(first);
+    SimdList simdOther = makeList< SimdList >(second);
+    simd.deleteItems(simdOther);
+    ScalarList scalar = makeList< ScalarList >(first);
+    ScalarList scalarOther = makeList< ScalarList >(second);
+    scalar.deleteItems(scalarOther);
+    EXPECT_EQ(print(simd), print(expected)) << first.size() << " - " << second.size();
+    EXPECT_EQ(print(scalar), print(expected)) << first.size() << " - " << second.size();
+    EXPECT_EQ(simd.size(), expected.size());
+  });
+}
+
+TEST(FlatDictionaryList, MergeMatchesScalarAndReference)
+{
+  forEachPair(3, [](const std::vector< int >& first, const std::vector< int >& second)
+  {
+    std::vector< int > expected;
+    std::set_union(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(expected));
+    SimdList simd = makeList< SimdList >(first);
+    SimdList simdOther = makeList< SimdList >(second);
+    simd.merge(simdOther);
+    ScalarList scalar = makeList< ScalarList >(first);
+    ScalarList scalarOther = makeList< ScalarList >(second);
+    scalar.merge(scalarOther);
+    EXPECT_EQ(print(simd), print(expected)) << first.size() << " + " << second.size();
+    EXPECT_EQ(print(scalar), print(expected)) << first.size() << " + " << second.size();
+    EXPECT_EQ(simd.size(), expected.size());
+  });
+}
+
+TEST(FlatDictionaryList, SimdBlocksHandleEqualMaxima)
+{
+  const std::vector< int > first = { 1, 2, 3, 8, 9, 10, 11, 16, 20 };
+  const std::vector< int > second = { 0, 3, 5, 8, 11, 12, 13, 16, 21 };
+  std::vector< int > intersection;
+  std::set_intersection(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(intersection));
+  EXPECT_EQ(print(getIntersection(makeList< SimdList >(first), makeList< SimdList >(second))), print(intersection));
+  std::vector< int > difference;
+  std::set_difference(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(difference));
+  SimdList list = makeList< SimdList >(first);
+  SimdList other = makeList< SimdList >(second);
+  list.deleteItems(other);
+  EXPECT_EQ(print(list), print(difference));
+}
@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <gtest/gtest.h>
+#include "hash_map_snapshot.h"
+#include "seeded_hash.h"
+
+namespace
+{
+  std::string snapshotPath(const std::string& name)
+  {
+    return ::testing::TempDir() + name;
+  }
+}
+
+TEST(HashMapSnapshot, RoundTripsIntegerKeys)
+{
+  const std::string path = snapshotPath("snapshot_int.bin");
+  ohantsev::HashMap< std::uint64_t, double > map;
+  for (std::uint64_t i = 0; i < 10000; ++i)
+  {
+    map.insert(std::make_pair(i * 31, i * 0.5));
+  }
+  ohantsev::HashMapSnapshot< std::uint64_t, double >::write(map, path);
+  const ohantsev::HashMapSnapshot< std::uint64_t, double > snapshot(path);
+  ASSERT_EQ(snapshot.size(), map.size());
+  for (const auto& pair: map)
+  {
+    ASSERT_NE(snapshot.find(pair.first), nullptr);
+    EXPECT_EQ(snapshot.at(pair.first), pair.second);
+  }
+  EXPECT_FALSE(snapshot.contains(1));
+  EXPECT_THROW(snapshot.at(1), std::out_of_range);
+  std::remove(path.c_str());
+}
+
+TEST(HashMapSnapshot, RoundTripsStringKeys)
+{
+  const std::string path = snapshotPath("snapshot_string.bin");
+  ohantsev::HashMap< std::string, int > map;
+  for (int i = 0; i < 5000; ++i)
+  {
+    map.emplace("user:" + std::to_string(i), i);
+  }
+  ohantsev::HashMapSnapshot< std::string, int >::write(map, path);
+  ohantsev::HashMapSnapshot< std::string, int > snapshot(path);
+  ohantsev::HashMapSnapshot< std::string, int > moved(std::move(snapshot));
+  for (int i = 0; i < 5000; ++i)
+  {
+    EXPECT_EQ(moved.at("user:" + std::to_string(i)), i);
+  }
+  EXPECT_EQ(moved.find("user:5000"), nullptr);
+  std::remove(path.c_str());
+}
+
+TEST(HashMapSnapshot, KeepsSeededHasher)
+{
+  using Snapshot = ohantsev::HashMapSnapshot< int, int, ohantsev::SeededHash< int > >;
+  const std::string path = snapshotPath("snapshot_seeded.bin");
+  const ohantsev::SeededHash< int > hasher(0x5EEDull);
+  ohantsev::HashMap< int, int, ohantsev::SeededHash< int > > map(hasher);
+  for (int i = 0; i < 2000; ++i)
+  {
+    map.insert(std::make_pair(i, -i));
+  }
+  Snapshot::write(map, path, map.hashFunction());
+  const Snapshot snapshot(path, ohantsev::SeededHash< int >(0x5EEDull));
+  EXPECT_EQ(snapshot.hashFunction().seed(), 0x5EEDull);
+  for (int i = 0; i < 2000; ++i)
+  {
+    ASSERT_NE(snapshot.find(i), nullptr);
+    EXPECT_EQ(*snapshot.find(i), -i);
+  }
+  EXPECT_THROW(Snapshot(path, ohantsev::SeededHash< int >(0xBADull)), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(HashMapSnapshot, RewriteKeepsOpenReadersValid)
+{
+  const std::string path = snapshotPath("snapshot_rewrite.bin");
+  ohantsev::HashMap< int, int > large;
+  for (int i = 0; i < 10000; ++i)
+  {
+    large.insert(std::make_pair(i, i * 3));
+  }
+  ohantsev::HashMapSnapshot< int, int >::write(large, path);
+  const ohantsev::HashMapSnapshot< int, int > old(path);
+  ohantsev::HashMap< int, int > small;
+  small.insert(std::make_pair(1, 1));
+  ohantsev::HashMapSnapshot< int, int >::write(small, path);
+  for (int i = 0; i < 10000; ++i)
+  {
+    ASSERT_NE(old.find(i), nullptr);
+    EXPECT_EQ(*old.find(i), i * 3);
+  }
+  const ohantsev::HashMapSnapshot< int, int > fresh(path);
+  EXPECT_EQ(fresh.size(), 1u);
+  EXPECT_EQ(fresh.at(1), 1);
+  std::remove(path.c_str());
+}
+
+TEST(HashMapSnapshot, RejectsForeignFiles)
+{
+  const std::string path = snapshotPath("snapshot_garbage.bin");
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << std::string(256, 'x');
+  }
+  EXPECT_THROW((ohantsev::HashMapSnapshot< int, int >(path)), std::runtime_error);
+  EXPECT_THROW((ohantsev::HashMapSnapshot< int, int >(snapshotPath("snapshot_missing.bin"))), std::runtime_error);
+  std::remove(path.c_str());
+}
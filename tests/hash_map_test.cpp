@@ -0,0 +1,609 @@
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include "allocation_counter.h"
+#include "hash_map.h"
+#include "hash_stats.h"
+#include "seeded_hash.h"
+
+namespace
+{
+  struct SaltedHash
+  {
+    std::size_t salt{ 0 };
+
+    std::size_t operator()(int key) const
+    {
+      return std::hash< int >{}(key) * 0x9E3779B97F4A7C15ull ^ salt;
+    }
+  };
+
+  struct CollidingHash
+  {
+    std::size_t operator()(int key) const
+    {
+      return static_cast< std::size_t >(key % 7);
+    }
+  };
+
+  struct ConstantHash
+  {
+    std::size_t operator()(int) const
+    {
+      return 0;
+    }
+  };
+
+  template< class Function >
+  void runOnSmallStack(Function function, const std::size_t stackSize)
+  {
+    pthread_attr_t attributes;
+    ASSERT_EQ(pthread_attr_init(&attributes), 0);
+    ASSERT_EQ(pthread_attr_setstacksize(&attributes, stackSize), 0);
+    pthread_t thread;
+    const int created = pthread_create(&thread, &attributes, [](void* argument) -> void*
+    {
+      (*static_cast< Function* >(argument))();
+      return nullptr;
+    }, &function);
+    pthread_attr_destroy(&attributes);
+    ASSERT_EQ(created, 0);
+    ASSERT_EQ(pthread_join(thread, nullptr), 0);
+  }
+
+  struct MoveOnly
+  {
+    int value;
+
+    explicit MoveOnly(int v):
+      value(v)
+    {}
+
+    MoveOnly(MoveOnly&&) = default;
+    MoveOnly& operator=(MoveOnly&&) = default;
+  };
+
+  struct Pinned
+  {
+    int value;
+
+    explicit Pinned(int v):
+      value(v)
+    {}
+
+    Pinned(const Pinned&) = delete;
+    Pinned& operator=(const Pinned&) = delete;
+  };
+
+  template< class Map >
+  void expectSame(const Map& map, const std::unordered_map< int, int >& expected)
+  {
+    ASSERT_EQ(map.size(), expected.size());
+    std::size_t visited = 0;
+    for (const auto& pair: map)
+    {
+      const auto found = expected.find(pair.first);
+      ASSERT_NE(found, expected.end());
+      EXPECT_EQ(pair.second, found->second);
+      ++visited;
+    }
+    EXPECT_EQ(visited, expected.size());
+  }
+
+  template< class Map >
+  void runDifferential(Map map, const unsigned seed, const int keys = 512)
+  {
+    std::mt19937 random(seed);
+    std::unordered_map< int, int > expected;
+    for (int step = 0; step < 20000; ++step)
+    {
+      const int key = static_cast< int >(random() % keys);
+      const int value = static_cast< int >(random());
+      switch (random() % 12)
+      {
+      case 0:
+      case 1:
+        EXPECT_EQ(map.insert(std::make_pair(key, value)).second, expected.emplace(key, value).second);
+        break;
+      case 2:
+        EXPECT_EQ(map.tryEmplace(key, value).second, expected.try_emplace(key, value).second);
+        break;
+      case 3:
+        EXPECT_EQ(map.insertOrAssign(key, value).second, expected.insert_or_assign(key, value).second);
+        break;
+      case 4:
+        map[key] = value;
+        expected[key] = value;
+        break;
+      case 5:
+      case 6:
+        EXPECT_EQ(map.erase(key), expected.erase(key) == 1);
+        break;
+      case 7:
+      {
+        auto node = map.extract(key);
+        EXPECT_EQ(node.empty(), expected.erase(key) == 0);
+        if (node && random() % 2)
+        {
+          expected.emplace(node.key(), node.mapped());
+          EXPECT_TRUE(map.insert(std::move(node)).second);
+        }
+        break;
+      }
+      case 8:
+      {
+        const auto found = map.find(key);
+        const auto reference = expected.find(key);
+        ASSERT_EQ(found == map.end(), reference == expected.end());
+        if (reference != expected.end())
+        {
+          EXPECT_EQ(found->second, reference->second);
+          EXPECT_EQ(map.at(key), reference->second);
+        }
+        else
+        {
+          EXPECT_THROW(map.at(key), std::out_of_range);
+        }
+        break;
+      }
+      case 9:
+        if (step % 64 == 0)
+        {
+          const int divisor = 2 + static_cast< int >(random() % 5);
+          const auto erased = map.eraseIf([divisor](const auto& pair)
+          {
+            return pair.first % divisor == 0;
+          });
+          const auto before = expected.size();
+          for (auto iter = expected.begin(); iter != expected.end();)
+          {
+            iter = (iter->first % divisor == 0) ? expected.erase(iter) : std::next(iter);
+          }
+          EXPECT_EQ(erased, before - expected.size());
+        }
+        break;
+      case 10:
+        if (step % 128 == 0)
+        {
+          switch (random() % 4)
+          {
+          case 0:
+            map.rehash();
+            break;
+          case 1:
+            map.reserve(random() % 4096);
+            break;
+          case 2:
+            map.shrinkToFit();
+            break;
+          default:
+            map.clear();
+            expected.clear();
+          }
+        }
+        break;
+      default:
+        if (step % 256 == 0)
+        {
+          Map copy(map);
+          expectSame(copy, expected);
+          Map moved(std::move(copy));
+          expectSame(moved, expected);
+          map = moved;
+        }
+      }
+    }
+    expectSame(map, expected);
+  }
+}
+
+TEST(HashMap, MatchesUnorderedMap)
+{
+  runDifferential(ohantsev::HashMap< int, int >(), 1);
+}
+
+TEST(HashMap, MatchesUnorderedMapWithCollidingHash)
+{
+  runDifferential(ohantsev::HashMap< int, int, CollidingHash >(), 2);
+}
+
+TEST(HashMap, MatchesUnorderedMapWithStatefulHash)
+{
+  runDifferential(ohantsev::HashMap< int, int, SaltedHash >(SaltedHash{ 0xABCDEF }), 3);
+  runDifferential(ohantsev::HashMap< int, int, ohantsev::SeededHash< int > >(), 4);
+}
+
+TEST(HashMap, MatchesUnorderedMapAroundSmallSize)
+{
+  runDifferential(ohantsev::HashMap< int, int >(), 5, 12);
+  runDifferential(ohantsev::HashMap< int, int, CollidingHash >(), 6, 12);
+}
+
+TEST(HashMap, SmallModeDoesNotAllocate)
+{
+  using map_t = ohantsev::HashMap< int, int >;
+  const int count = static_cast< int >(map_t::SMALL_SIZE) - 1;
+  const std::size_t before = testing_support::allocationCount();
+  int sum = 0;
+  {
+    map_t map;
+    for (int i = 0; i < count; ++i)
+    {
+      map.insert(std::make_pair(i, i));
+    }
+    map[count - 1] += 1;
+    map.erase(0);
+    map.tryEmplace(0, 5);
+    map_t copy(map);
+    map_t moved(std::move(copy));
+    for (const auto& pair: moved)
+    {
+      sum += pair.second;
+    }
+  }
+  const std::size_t allocations = testing_support::allocationCount() - before;
+  EXPECT_EQ(allocations, 0u);
+  EXPECT_EQ(sum, count * (count - 1) / 2 + 1 + 5);
+}
+
+TEST(HashMap, DestroysLongChainOnSmallStack)
+{
+  auto map = std::make_unique< ohantsev::HashMap< int, int, ConstantHash > >();
+  for (int i = 0; i < 20000; ++i)
+  {
+    map->insert(std::make_pair(i, i));
+  }
+  runOnSmallStack([&map]()
+  {
+    map.reset();
+  }, 256 * 1024);
+  EXPECT_EQ(map, nullptr);
+}
+
+TEST(FwdListNode, DestroysLongChainOnSmallStack)
+{
+  using node_t = ohantsev::FwdListNode< int >;
+  ohantsev::UniquePtr< node_t > head;
+  for (int i = 0; i < 200000; ++i)
+  {
+    head = ohantsev::UniquePtr< node_t >(new node_t(i, std::move(head)));
+  }
+  runOnSmallStack([&head]()
+  {
+    head.reset();
+  }, 256 * 1024);
+  EXPECT_FALSE(head);
+}
+
+TEST(HashMap, ReseedsWhenKeysCollide)
+{
+  using hash_t = ohantsev::SeededHash< int >;
+  using map_t = ohantsev::HashMap< int, int, hash_t >;
+  const std::size_t capacity = 256;
+  const std::size_t buckets = static_cast< std::size_t >(capacity / map_t::MAX_LOAD_FACTOR) + 1;
+  const hash_t attacked(12345);
+  std::vector< int > keys;
+  for (int key = 0; keys.size() < 100; ++key)
+  {
+    if (attacked(key) % buckets == 0)
+    {
+      keys.push_back(key);
+    }
+  }
+
+  map_t map(capacity, attacked);
+  for (const int key: keys)
+  {
+    EXPECT_TRUE(map.insert(std::make_pair(key, -key)).second);
+  }
+  EXPECT_NE(map.hashFunction().seed(), attacked.seed());
+  std::vector< std::size_t > chains(buckets, 0);
+  for (const int key: keys)
+  {
+    ASSERT_EQ(map.at(key), -key);
+    ++chains[map.hashFunction()(key) % buckets];
+  }
+  EXPECT_LE(*std::max_element(chains.begin(), chains.end()), map_t::MAX_CHAIN_LENGTH);
+  EXPECT_EQ(map.size(), keys.size());
+}
+
+TEST(HashMap, KeepsHasherInstance)
+{
+  ohantsev::HashMap< int, int, SaltedHash > map(SaltedHash{ 42 });
+  for (int i = 0; i < 1000; ++i)
+  {
+    map.insert(std::make_pair(i, i));
+  }
+  ohantsev::HashMap< int, int, SaltedHash > copy(map);
+  EXPECT_EQ(copy.hashFunction().salt, 42u);
+  for (int i = 0; i < 1000; ++i)
+  {
+    ASSERT_NE(copy.find(i), copy.end());
+  }
+}
+
+TEST(HashMap, StringKeys)
+{
+  ohantsev::HashMap< std::string, int > map;
+  for (int i = 0; i < 5000; ++i)
+  {
+    map.emplace(std::to_string(i), i);
+  }
+  ASSERT_EQ(map.size(), 5000u);
+  for (int i = 0; i < 5000; ++i)
+  {
+    EXPECT_EQ(map.at(std::to_string(i)), i);
+  }
+  EXPECT_EQ(map.find("missing"), map.end());
+}
+
+TEST(HashMap, EraseWhileIterating)
+{
+  ohantsev::HashMap< int, int > map;
+  for (int i = 0; i < 1000; ++i)
+  {
+    map.insert(std::make_pair(i, i));
+  }
+  for (auto iter = map.begin(); iter != map.end();)
+  {
+    if (iter->first % 3 == 0)
+    {
+      map.erase(iter++);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+  EXPECT_EQ(map.size(), 666u);
+  for (const auto& pair: map)
+  {
+    EXPECT_NE(pair.first % 3, 0);
+  }
+}
+
+TEST(HashMap, ShrinkKeepsReservedCapacity)
+{
+  ohantsev::HashMap< int, int > map;
+  map.reserve(100000);
+  for (int i = 0; i < 100; ++i)
+  {
+    map.insert(std::make_pair(i, i));
+  }
+  EXPECT_TRUE(map.erase(0));
+  EXPECT_TRUE(map.eraseIf([](const auto& pair)
+  {
+    return pair.first % 2 == 0;
+  }) > 0);
+  EXPECT_LT(map.loadFactor(), 0.01);
+  map.shrinkToFit();
+  EXPECT_GT(map.loadFactor(), 0.5);
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(map.find(i) != map.end(), i % 2 == 1);
+  }
+}
+
+TEST(HashMap, ShrinksAfterEraseBurst)
+{
+  ohantsev::HashMap< int, int > map;
+  for (int i = 0; i < 10000; ++i)
+  {
+    map.insert(std::make_pair(i, i));
+  }
+  for (int i = 0; i < 9900; ++i)
+  {
+    ASSERT_TRUE(map.erase(i));
+  }
+  EXPECT_GE(map.loadFactor(), 0.1);
+}
+
+TEST(HashMap, EraseBurstKeepsOtherElementsInPlace)
+{
+  ohantsev::HashMap< int, int > map;
+  for (int i = 0; i < 1000; ++i)
+  {
+    map.insert(std::make_pair(i, i));
+  }
+  int& kept = map.find(999)->second;
+  for (int i = 0; i < 999; ++i)
+  {
+    ASSERT_TRUE(map.erase(i));
+  }
+  EXPECT_EQ(&kept, &map.find(999)->second);
+  kept = -1;
+  EXPECT_EQ(map.at(999), -1);
+  map.shrinkToFit();
+  EXPECT_EQ(map.at(999), -1);
+}
+
+TEST(HashMap, MergeMovesOnlyMissingKeys)
+{
+  ohantsev::HashMap< int, int > target;
+  ohantsev::HashMap< int, int > source;
+  for (int i = 0; i < 100; ++i)
+  {
+    target.insert(std::make_pair(i, i));
+    source.insert(std::make_pair(i + 50, -i));
+  }
+  target.merge(source);
+  EXPECT_EQ(target.size(), 150u);
+  EXPECT_EQ(source.size(), 50u);
+  EXPECT_EQ(target.at(60), 60);
+  EXPECT_EQ(target.at(120), -70);
+}
+
+TEST(HashMap, TryEmplaceAcceptsMoveOnlyValues)
+{
+  ohantsev::HashMap< int, MoveOnly > map;
+  EXPECT_TRUE(map.tryEmplace(1, 10).second);
+  EXPECT_FALSE(map.tryEmplace(1, 20).second);
+  EXPECT_EQ(map.find(1)->second.value, 10);
+}
+
+TEST(HashMap, TryEmplaceConstructsValuesInPlace)
+{
+  ohantsev::HashMap< std::string, Pinned > map;
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_TRUE(map.tryEmplace(std::to_string(i), i).second);
+  }
+  std::string key = "100";
+  EXPECT_TRUE(map.tryEmplace(std::move(key), 100).second);
+  EXPECT_FALSE(map.tryEmplace("5", 500).second);
+  EXPECT_EQ(map.size(), 101u);
+  EXPECT_EQ(map.find("5")->second.value, 5);
+  EXPECT_EQ(map.find("100")->second.value, 100);
+}
+
+TEST(HashMap, ParallelOperationsMatchSerial)
+{
+  std::vector< std::pair< int, int > > pairs;
+  for (int i = 0; i < 50000; ++i)
+  {
+    pairs.emplace_back(i % 40000, i);
+  }
+  ohantsev::HashMap< int, int > map(pairs.begin(), pairs.end(), 4);
+  ASSERT_EQ(map.size(), 40000u);
+  map.parallelRehash(4);
+  const long long sum = map.parallelReduce(0LL, [](const auto& pair)
+  {
+    return static_cast< long long >(pair.first);
+  }, [](long long lhs, long long rhs)
+  {
+    return lhs + rhs;
+  }, 4);
+  EXPECT_EQ(sum, 40000LL * 39999 / 2);
+  EXPECT_EQ(map.parallelEraseIf([](const auto& pair)
+  {
+    return pair.first % 2 == 0;
+  }, 4), 20000u);
+  EXPECT_EQ(map.size(), 20000u);
+  EXPECT_EQ(map.find(2), map.end());
+  EXPECT_NE(map.find(3), map.end());
+}
+
+TEST(HashMap, RangeConstructorTakesOnlyIterators)
+{
+  static_assert(!std::is_constructible< ohantsev::HashMap< int, int >, int, int >::value,
+    "two integers must not select the range constructor");
+  static_assert(!std::is_constructible< ohantsev::HashMap< int, int >, std::size_t, std::size_t >::value,
+    "two sizes must not select the range constructor");
+  const std::list< std::pair< int, int > > pairs{ { 1, 10 }, { 2, 20 }, { 1, 30 } };
+  const ohantsev::HashMap< int, int > map(pairs.begin(), pairs.end());
+  EXPECT_EQ(map.size(), 2u);
+  EXPECT_EQ(map.at(1), 10);
+  EXPECT_EQ(map.at(2), 20);
+}
+
+TEST(HashMap, FreezeFindsEveryKey)
+{
+  ohantsev::HashMap< int, int > map;
+  for (int i = 0; i < 3000; ++i)
+  {
+    map.insert(std::make_pair(i * 7, i));
+  }
+  const auto frozen = map.freeze();
+  ASSERT_EQ(frozen.size(), map.size());
+  for (int i = 0; i < 3000; ++i)
+  {
+    EXPECT_EQ(frozen.at(i * 7), i);
+    EXPECT_FALSE(frozen.contains(i * 7 + 1));
+  }
+  ohantsev::HashMap< int, int, CollidingHash > colliding;
+  for (int i = 0; i < 100; ++i)
+  {
+    colliding.insert(std::make_pair(i, i));
+  }
+  const auto frozenColliding = colliding.freeze();
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(frozenColliding.at(i), i);
+  }
+}
+
+TEST(HashMap, StatsCountConcurrentFinds)
+{
+  ohantsev::HashMap< int, int, std::hash< int >, std::equal_to< int >, ohantsev::HashStats > map;
+  for (int i = 0; i < 1000; ++i)
+  {
+    map.insert(std::make_pair(i, i));
+  }
+  const ohantsev::HashStatsSnapshot before = map.stats();
+  const auto& readOnly = map;
+  std::vector< std::thread > readers;
+  for (int reader = 0; reader < 4; ++reader)
+  {
+    readers.emplace_back([&readOnly]
+    {
+      for (int i = 0; i < 2000; ++i)
+      {
+        readOnly.find(i);
+      }
+    });
+  }
+  for (std::thread& reader: readers)
+  {
+    reader.join();
+  }
+  const ohantsev::HashStatsSnapshot stats = map.stats();
+  EXPECT_EQ(stats.finds - before.finds, 8000u);
+  std::size_t histogramTotal = 0;
+  for (std::size_t slot = 0; slot < ohantsev::HashStatsSnapshot::HISTOGRAM_SIZE; ++slot)
+  {
+    histogramTotal += stats.probeHistogram[slot] - before.probeHistogram[slot];
+  }
+  EXPECT_EQ(histogramTotal, 8000u);
+  EXPECT_GT(stats.allocations, 0u);
+  auto copy = map;
+  EXPECT_EQ(copy.size(), map.size());
+}
+
+TEST(HashMap, ConcurrentReadersIterate)
+{
+  ohantsev::HashMap< int, int > map;
+  for (int i = 0; i < 1000; ++i)
+  {
+    map.insert(std::make_pair(i, i));
+  }
+  for (int i = 0; i < 500; ++i)
+  {
+    map.erase(i);
+  }
+  const auto& readOnly = map;
+  std::vector< long long > sums(4);
+  std::vector< std::thread > readers;
+  for (std::size_t reader = 0; reader < sums.size(); ++reader)
+  {
+    readers.emplace_back([&readOnly, &sums, reader]
+    {
+      for (int pass = 0; pass < 50; ++pass)
+      {
+        long long sum = 0;
+        for (auto iter = readOnly.cbegin(); iter != readOnly.cend(); ++iter)
+        {
+          sum += iter->first;
+        }
+        sums[reader] = sum;
+      }
+    });
+  }
+  for (std::thread& reader: readers)
+  {
+    reader.join();
+  }
+  for (const long long sum: sums)
+  {
+    EXPECT_EQ(sum, 1000LL * 999 / 2 - 500LL * 499 / 2);
+  }
+}
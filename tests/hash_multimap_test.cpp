@@ -0,0 +1,143 @@
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hash_multimap.h"
+
+namespace
+{
+  struct CollidingHash
+  {
+    std::size_t operator()(int key) const
+    {
+      return static_cast< std::size_t >(key % 3);
+    }
+  };
+
+  template< class Map >
+  void expectSame(const Map& map, const std::multimap< int, int >& expected)
+  {
+    ASSERT_EQ(map.size(), expected.size());
+    std::set< int > seen;
+    bool first = true;
+    int previous = 0;
+    for (const auto& pair: map)
+    {
+      if (first || pair.first != previous)
+      {
+        EXPECT_TRUE(seen.insert(pair.first).second) << "key " << pair.first << " is not contiguous";
+      }
+      previous = pair.first;
+      first = false;
+    }
+    for (int key = 0; key < 60; ++key)
+    {
+      EXPECT_EQ(map.count(key), expected.count(key));
+      std::vector< int > actual;
+      const auto range = map.equalRange(key);
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        EXPECT_EQ(iter->first, key);
+        actual.push_back(iter->second);
+      }
+      std::vector< int > reference;
+      const auto expectedRange = expected.equal_range(key);
+      for (auto iter = expectedRange.first; iter != expectedRange.second; ++iter)
+      {
+        reference.push_back(iter->second);
+      }
+      EXPECT_EQ(actual, reference);
+      EXPECT_EQ(map.find(key) == map.end(), reference.empty());
+    }
+  }
+
+  template< class Map >
+  void runDifferential(const unsigned seed)
+  {
+    std::mt19937 random(seed);
+    Map map;
+    std::multimap< int, int > expected;
+    for (int step = 0; step < 20000; ++step)
+    {
+      const int key = static_cast< int >(random() % 60);
+      switch (random() % 10)
+      {
+      case 0:
+      case 1:
+      case 2:
+      case 3:
+      case 4:
+      case 5:
+      {
+        const auto iter = map.insert(std::make_pair(key, step));
+        EXPECT_EQ(iter->first, key);
+        EXPECT_EQ(iter->second, step);
+        expected.emplace(key, step);
+        break;
+      }
+      case 6:
+        EXPECT_EQ(map.eraseAll(key), expected.erase(key));
+        break;
+      case 7:
+      {
+        const auto iter = map.find(key);
+        if (iter != map.end())
+        {
+          EXPECT_TRUE(map.erase(iter));
+          expected.erase(expected.find(key));
+        }
+        break;
+      }
+      case 8:
+        map.emplace(key, step);
+        expected.emplace(key, step);
+        break;
+      default:
+        if (step % 500 == 0)
+        {
+          Map copy(map);
+          expectSame(copy, expected);
+          Map moved(std::move(copy));
+          map = moved;
+          map.reserve(random() % 2000);
+        }
+      }
+      if (step % 97 == 0)
+      {
+        expectSame(map, expected);
+      }
+    }
+    expectSame(map, expected);
+  }
+}
+
+TEST(HashMultiMap, MatchesStdMultimap)
+{
+  runDifferential< ohantsev::HashMultiMap< int, int > >(41);
+}
+
+TEST(HashMultiMap, MatchesStdMultimapWithCollidingHash)
+{
+  runDifferential< ohantsev::HashMultiMap< int, int, CollidingHash > >(42);
+}
+
+TEST(HashMultiSet, CountsDuplicates)
+{
+  ohantsev::HashMultiSet< std::string > set;
+  set.insert("a");
+  set.insert("b");
+  set.insert("a");
+  set.emplace("a");
+  EXPECT_EQ(set.size(), 4u);
+  EXPECT_EQ(set.count("a"), 3u);
+  const auto range = set.equalRange("a");
+  EXPECT_EQ(std::distance(range.first, range.second), 3);
+  EXPECT_EQ(set.eraseAll("a"), 3u);
+  EXPECT_EQ(set.size(), 1u);
+  EXPECT_EQ(set.count("a"), 0u);
+}
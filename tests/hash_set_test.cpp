@@ -0,0 +1,248 @@
+#include <cstddef>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <gtest/gtest.h>
+#include "allocation_counter.h"
+#include "hashSet.h"
+#include "seeded_hash.h"
+
+namespace
+{
+  struct CollidingHash
+  {
+    std::size_t operator()(int key) const
+    {
+      return static_cast< std::size_t >(key % 5);
+    }
+  };
+
+  template< class Set >
+  void expectSame(const Set& set, const std::unordered_set< int >& expected)
+  {
+    ASSERT_EQ(set.size(), expected.size());
+    std::size_t visited = 0;
+    for (const int key: set)
+    {
+      EXPECT_EQ(expected.count(key), 1u);
+      ++visited;
+    }
+    EXPECT_EQ(visited, expected.size());
+  }
+
+  template< class Set >
+  void runDifferential(Set set, const unsigned seed, const int keys = 512)
+  {
+    std::mt19937 random(seed);
+    std::unordered_set< int > expected;
+    for (int step = 0; step < 20000; ++step)
+    {
+      const int key = static_cast< int >(random() % keys);
+      switch (random() % 8)
+      {
+      case 0:
+      case 1:
+      case 2:
+        EXPECT_EQ(set.insert(key), expected.insert(key).second);
+        break;
+      case 3:
+      case 4:
+        EXPECT_EQ(set.remove(key), expected.erase(key) == 1);
+        break;
+      case 5:
+        EXPECT_EQ(set.find(key) != set.end(), expected.count(key) == 1);
+        break;
+      case 6:
+        if (step % 128 == 0)
+        {
+          switch (random() % 4)
+          {
+          case 0:
+            set.rehash();
+            break;
+          case 1:
+            set.reserve(random() % 4096);
+            break;
+          case 2:
+            set.shrinkToFit();
+            break;
+          default:
+            set.clear();
+            expected.clear();
+          }
+        }
+        break;
+      default:
+        if (step % 256 == 0)
+        {
+          Set copy(set);
+          expectSame(copy, expected);
+          Set moved(std::move(copy));
+          expectSame(moved, expected);
+          set = moved;
+        }
+      }
+    }
+    expectSame(set, expected);
+  }
+}
+
+TEST(HashSet, MatchesUnorderedSet)
+{
+  runDifferential(HashSet< int >(), 11);
+}
+
+TEST(HashSet, MatchesUnorderedSetWithCollidingHash)
+{
+  runDifferential(HashSet< int, CollidingHash >(), 12);
+}
+
+TEST(HashSet, MatchesUnorderedSetWithSeededHash)
+{
+  runDifferential(HashSet< int, ohantsev::SeededHash< int > >(), 13);
+}
+
+TEST(HashSet, MatchesUnorderedSetAroundSmallSize)
+{
+  runDifferential(HashSet< int >(), 14, 12);
+}
+
+TEST(HashSet, RehashKeepsEveryKeyUnderLoadLimit)
+{
+  HashSet< int > small;
+  for (int i = 0; i < 3; ++i)
+  {
+    small.insert(i);
+  }
+  small.rehash();
+  EXPECT_EQ(small.size(), 3u);
+  for (int i = 0; i < 3; ++i)
+  {
+    EXPECT_TRUE(small.find(i) != small.end());
+  }
+
+  HashSet< int > loaded(100);
+  for (int i = 0; i < 101; ++i)
+  {
+    loaded.insert(i);
+  }
+  loaded.rehash();
+  EXPECT_LT(loaded.loadFactor(), 0.7);
+  EXPECT_EQ(loaded.size(), 101u);
+  for (int i = 0; i < 101; ++i)
+  {
+    EXPECT_TRUE(loaded.find(i) != loaded.end());
+  }
+}
+
+TEST(HashSet, SmallModeDoesNotAllocate)
+{
+  using set_t = HashSet< int >;
+  const int count = static_cast< int >(set_t::SMALL_SIZE) - 1;
+  const std::size_t before = testing_support::allocationCount();
+  int sum = 0;
+  {
+    set_t set;
+    for (int i = 0; i < count; ++i)
+    {
+      set.insert(i);
+    }
+    set.remove(0);
+    set_t copy(set);
+    set_t moved(std::move(copy));
+    for (const int key: moved)
+    {
+      sum += key;
+    }
+  }
+  const std::size_t allocations = testing_support::allocationCount() - before;
+  EXPECT_EQ(allocations, 0u);
+  EXPECT_EQ(sum, count * (count - 1) / 2);
+}
+
+TEST(HashSet, ShrinkKeepsReservedCapacity)
+{
+  HashSet< int > set(100000);
+  for (int i = 0; i < 100; ++i)
+  {
+    set.insert(i);
+  }
+  EXPECT_TRUE(set.remove(0));
+  EXPECT_LT(set.loadFactor(), 0.01);
+  set.shrinkToFit();
+  EXPECT_GT(set.loadFactor(), 0.5);
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(set.find(i) != set.end(), i != 0);
+  }
+}
+
+TEST(HashSet, EraseBurstKeepsOtherElementsInPlace)
+{
+  HashSet< int > set;
+  for (int i = 0; i < 1000; ++i)
+  {
+    set.insert(i);
+  }
+  const int* kept = &*set.find(999);
+  for (int i = 0; i < 999; ++i)
+  {
+    ASSERT_TRUE(set.remove(i));
+  }
+  EXPECT_EQ(kept, &*set.find(999));
+  EXPECT_EQ(*kept, 999);
+}
+
+TEST(HashSet, ParallelEraseIfAndFreeze)
+{
+  HashSet< int > set;
+  for (int i = 0; i < 10000; ++i)
+  {
+    set.insert(i);
+  }
+  EXPECT_EQ(set.parallelEraseIf([](int key)
+  {
+    return key % 4 == 0;
+  }, 4), 2500u);
+  const auto frozen = set.freeze();
+  ASSERT_EQ(frozen.size(), 7500u);
+  for (int i = 0; i < 10000; ++i)
+  {
+    EXPECT_EQ(frozen.contains(i), i % 4 != 0);
+  }
+}
+
+TEST(HashSet, StringKeys)
+{
+  HashSet< std::string > set;
+  for (int i = 0; i < 3000; ++i)
+  {
+    EXPECT_TRUE(set.insert("id-" + std::to_string(i)));
+  }
+  EXPECT_FALSE(set.insert("id-7"));
+  EXPECT_TRUE(set.remove("id-7"));
+  EXPECT_EQ(set.find("id-7"), set.end());
+  EXPECT_NE(set.find("id-8"), set.end());
+}
+
+TEST(HashSet, ResizingKeepsNodes)
+{
+  HashSet< int > set;
+  for (int i = 0; i <= static_cast< int >(HashSet< int >::SMALL_SIZE); ++i)
+  {
+    set.insert(i);
+  }
+  ASSERT_TRUE(set.insert(-1));
+  const int* address = &*set.find(-1);
+  for (int i = 0; i < 5000; ++i)
+  {
+    set.insert(i);
+  }
+  EXPECT_EQ(&*set.find(-1), address);
+  set.rehash();
+  EXPECT_EQ(&*set.find(-1), address);
+  set.reserve(100000);
+  EXPECT_EQ(&*set.find(-1), address);
+  EXPECT_EQ(set.size(), 5001u);
+}
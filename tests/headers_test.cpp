@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include "BinarySearchTree.h"
+#include "DictionaryList.h"
+#include "EytzingerIndex.h"
+#include "FlatDictionaryList.h"
+#include "HashIterator.h"
+#include "LoserTree.h"
+#include "Queue.h"
+#include "SkipDictionaryList.h"
+#include "Stack.h"
+#include "TreeProfiler.h"
+#include "bounded_cache.h"
+#include "bucket_bitmap.h"
+#include "chain_table.h"
+#include "ebo_storage.h"
+#include "expiring_map.h"
+#include "fwd_list.h"
+#include "hashSet.h"
+#include "hash_map.h"
+#include "hash_map_snapshot.h"
+#include "hash_multimap.h"
+#include "hash_stats.h"
+#include "inline_pool.h"
+#include "parallel_for.h"
+#include "perfect_hash.h"
+#include "roaring_set.h"
+#include "seeded_hash.h"
+#include "unique_ptr.h"
+
+TEST(Headers, IncludeTogether)
+{
+  ohantsev::HashMap< int, int > map;
+  HashSet< int > set;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(set.size(), 0u);
+}
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "LoserTree.h"
+
+namespace
+{
+  using run_t = std::vector< int >;
+
+  std::vector< std::pair< int, std::size_t > > drain(const std::vector< run_t >& runs)
+  {
+    std::vector< std::size_t > positions(runs.size(), 0);
+    std::vector< const int* > heads(runs.size());
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+      heads[i] = runs[i].empty() ? nullptr : runs[i].data();
+    }
+    LoserTree< int > tree(runs.size());
+    tree.build(heads.data());
+    std::vector< std::pair< int, std::size_t > > merged;
+    while (const int* top = tree.top())
+    {
+      const std::size_t winner = tree.winner();
+      EXPECT_EQ(top, runs[winner].data() + positions[winner]);
+      merged.emplace_back(*top, winner);
+      ++positions[winner];
+      tree.replaceWinner(positions[winner] < runs[winner].size() ? top + 1 : nullptr);
+    }
+    return merged;
+  }
+
+  std::vector< std::pair< int, std::size_t > > reference(const std::vector< run_t >& runs)
+  {
+    std::vector< std::pair< int, std::size_t > > merged;
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+      for (const int value: runs[i])
+      {
+        merged.emplace_back(value, i);
+      }
+    }
+    std::stable_sort(merged.begin(), merged.end());
+    return merged;
+  }
+}
+
+TEST(LoserTree, EmptyTreeHasNoTop)
+{
+  LoserTree< int > tree(0);
+  tree.build(nullptr);
+  EXPECT_EQ(tree.top(), nullptr);
+}
+
+TEST(LoserTree, MergesRunsAndBreaksTiesByIndex)
+{
+  std::mt19937 random(1);
+  for (std::size_t count = 1; count <= 17; ++count)
+  {
+    for (const int range: { 1, 4, 1000 })
+    {
+      std::vector< run_t > runs(count);
+      for (run_t& run: runs)
+      {
+        run.resize(random() % 40);
+        for (int& value: run)
+        {
+          value = static_cast< int >(random() % range);
+        }
+        std::sort(run.begin(), run.end());
+      }
+      EXPECT_EQ(drain(runs), reference(runs)) << count << " runs, range " << range;
+    }
+  }
+}
+
+TEST(LoserTree, SkipsExhaustedRuns)
+{
+  const std::vector< run_t > runs = { {}, { 2, 2 }, {}, { 1, 2, 3 }, {} };
+  const std::vector< std::pair< int, std::size_t > > expected = {
+    { 1, 3 }, { 2, 1 }, { 2, 1 }, { 2, 3 }, { 3, 3 }
+  };
+  EXPECT_EQ(drain(runs), expected);
+  EXPECT_TRUE(drain({ {}, {}, {} }).empty());
+}
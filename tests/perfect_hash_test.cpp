@@ -0,0 +1,98 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "perfect_hash.h"
+
+TEST(FrozenHashSet, FindsExactlyItsKeys)
+{
+  std::mt19937_64 random(61);
+  std::set< std::uint64_t > unique;
+  while (unique.size() < 20000)
+  {
+    unique.insert(random());
+  }
+  const std::vector< std::uint64_t > keys(unique.begin(), unique.end());
+  const ohantsev::FrozenHashSet< std::uint64_t > frozen(keys.begin(), keys.end());
+  ASSERT_EQ(frozen.size(), keys.size());
+  for (const std::uint64_t key: keys)
+  {
+    ASSERT_NE(frozen.find(key), nullptr);
+    EXPECT_EQ(*frozen.find(key), key);
+  }
+  for (int i = 0; i < 20000; ++i)
+  {
+    const std::uint64_t key = random();
+    EXPECT_EQ(frozen.contains(key), unique.count(key) == 1);
+  }
+  EXPECT_EQ(std::set< std::uint64_t >(frozen.begin(), frozen.end()), unique);
+}
+
+TEST(FrozenHashMap, LooksUpValues)
+{
+  std::vector< std::pair< std::string, int > > pairs;
+  for (int i = 0; i < 5000; ++i)
+  {
+    pairs.emplace_back("name-" + std::to_string(i), i);
+  }
+  const ohantsev::FrozenHashMap< std::string, int > frozen(pairs.begin(), pairs.end());
+  for (const auto& pair: pairs)
+  {
+    EXPECT_EQ(frozen.at(pair.first), pair.second);
+  }
+  EXPECT_FALSE(frozen.contains("name-5000"));
+  EXPECT_THROW(frozen.at("missing"), std::out_of_range);
+  const ohantsev::FrozenHashMap< std::string, int > empty;
+  EXPECT_EQ(empty.find("name-1"), nullptr);
+}
+
+TEST(StaticPerfectHashSet, BuildsAtCompileTime)
+{
+  static constexpr int keys[]{ 3, 17, 42, 1000, -5, 77, 123456 };
+  static constexpr auto set = ohantsev::makeStaticPerfectHashSet(keys);
+  static_assert(set.contains(42), "key must be present");
+  static_assert(!set.contains(43), "key must be absent");
+  for (const int key: keys)
+  {
+    EXPECT_TRUE(set.contains(key));
+  }
+  EXPECT_EQ(set.size(), 7u);
+}
+
+namespace
+{
+  struct CollidingHash
+  {
+    std::size_t operator()(int key) const
+    {
+      return static_cast< std::size_t >(key % 7);
+    }
+  };
+}
+
+TEST(FrozenHashMap, ToleratesKeysWithEqualHashes)
+{
+  std::vector< std::pair< int, int > > pairs;
+  for (int i = 0; i < 500; ++i)
+  {
+    pairs.emplace_back(i, -i);
+  }
+  const ohantsev::FrozenHashMap< int, int, CollidingHash > frozen(pairs.begin(), pairs.end());
+  ASSERT_EQ(frozen.size(), pairs.size());
+  for (const auto& pair: pairs)
+  {
+    EXPECT_EQ(frozen.at(pair.first), pair.second);
+  }
+  EXPECT_FALSE(frozen.contains(500));
+  const std::vector< int > keys{ 0, 7, 14, 3 };
+  const ohantsev::FrozenHashSet< int, CollidingHash > set(keys.begin(), keys.end());
+  for (const int key: keys)
+  {
+    EXPECT_TRUE(set.contains(key));
+  }
+  EXPECT_FALSE(set.contains(21));
+}
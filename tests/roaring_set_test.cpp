@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+#include <gtest/gtest.h>
+#include "roaring_set.h"
+
+namespace
+{
+  void expectSame(const ohantsev::RoaringSet& set, const std::set< std::uint32_t >& expected)
+  {
+    ASSERT_EQ(set.size(), expected.size());
+    EXPECT_TRUE(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+  }
+
+  std::set< std::uint32_t > fill(std::mt19937& random, ohantsev::RoaringSet& set)
+  {
+    std::set< std::uint32_t > expected;
+    const auto add = [&](std::uint32_t value)
+    {
+      set.insert(value);
+      expected.insert(value);
+    };
+    const int blocks = static_cast< int >(random() % 4);
+    for (int block = 0; block < blocks; ++block)
+    {
+      const std::uint32_t base = (random() % 6) << 16;
+      switch (random() % 4)
+      {
+      case 0:
+        for (int i = 0; i < 3000; ++i)
+        {
+          add(base | (random() & 0xFFFF));
+        }
+        break;
+      case 1:
+        for (int i = 0; i < 30000; ++i)
+        {
+          add(base | (random() & 0xFFFF));
+        }
+        break;
+      case 2:
+      {
+        const std::uint32_t first = random() & 0xFFFF;
+        const std::uint32_t last = std::min< std::uint32_t >(first + random() % 20000, 0x10000);
+        for (std::uint32_t low = first; low < last; ++low)
+        {
+          add(base | low);
+        }
+        break;
+      }
+      default:
+        for (std::uint32_t low = 0; low < 0x10000; low += 1 + random() % 3)
+        {
+          add(base | low);
+        }
+      }
+    }
+    if (random() % 2)
+    {
+      set.shrinkToFit();
+    }
+    return expected;
+  }
+
+  std::uint32_t randomKey(std::mt19937& random)
+  {
+    return ((random() % 6) << 16) | (random() & 0xFFFF);
+  }
+}
+
+TEST(RoaringSet, MatchesStdSet)
+{
+  std::mt19937 random(51);
+  for (int round = 0; round < 40; ++round)
+  {
+    ohantsev::RoaringSet set;
+    std::set< std::uint32_t > expected = fill(random, set);
+    expectSame(set, expected);
+    for (int step = 0; step < 5000; ++step)
+    {
+      const std::uint32_t key = randomKey(random);
+      switch (random() % 3)
+      {
+      case 0:
+        EXPECT_EQ(set.insert(key), expected.insert(key).second);
+        break;
+      case 1:
+        EXPECT_EQ(set.remove(key), expected.erase(key) == 1);
+        break;
+      default:
+      {
+        auto found = set.find(key);
+        auto reference = expected.find(key);
+        ASSERT_EQ(found == set.end(), reference == expected.end());
+        if (reference != expected.end())
+        {
+          EXPECT_EQ(*found, key);
+          EXPECT_EQ(++found == set.end(), ++reference == expected.end());
+          if (reference != expected.end())
+          {
+            EXPECT_EQ(*found, *reference);
+          }
+        }
+      }
+      }
+    }
+    expectSame(set, expected);
+    set.shrinkToFit();
+    expectSame(set, expected);
+  }
+}
+
+TEST(RoaringSet, SetAlgebraMatchesStdAlgorithms)
+{
+  std::mt19937 random(52);
+  for (int round = 0; round < 40; ++round)
+  {
+    ohantsev::RoaringSet lhs;
+    ohantsev::RoaringSet rhs;
+    const std::set< std::uint32_t > left = fill(random, lhs);
+    const std::set< std::uint32_t > right = fill(random, rhs);
+    std::set< std::uint32_t > united;
+    std::set< std::uint32_t > common;
+    std::set< std::uint32_t > difference;
+    std::set_union(left.begin(), left.end(), right.begin(), right.end(), std::inserter(united, united.end()));
+    std::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::inserter(common, common.end()));
+    std::set_difference(left.begin(), left.end(), right.begin(), right.end(),
+      std::inserter(difference, difference.end()));
+    ohantsev::RoaringSet unionSet = lhs;
+    expectSame(unionSet.unite(rhs), united);
+    ohantsev::RoaringSet intersection = lhs;
+    expectSame(intersection.intersect(rhs), common);
+    ohantsev::RoaringSet subtraction = lhs;
+    expectSame(subtraction.subtract(rhs), difference);
+    ohantsev::RoaringSet self = lhs;
+    expectSame(self.unite(self), left);
+    expectSame(self.intersect(self), left);
+    EXPECT_TRUE(self.subtract(self).empty());
+  }
+}
+
+TEST(RoaringSet, ArrayKernelsMatchStdAlgorithms)
+{
+  std::mt19937 random(53);
+  for (int round = 0; round < 200; ++round)
+  {
+    const std::uint32_t range = 16 + random() % 8000;
+    ohantsev::RoaringSet lhs;
+    ohantsev::RoaringSet rhs;
+    std::set< std::uint32_t > left;
+    std::set< std::uint32_t > right;
+    for (std::uint32_t i = random() % 2000; i > 0; --i)
+    {
+      const std::uint32_t key = random() % range;
+      lhs.insert(key);
+      left.insert(key);
+    }
+    for (std::uint32_t i = random() % 2000; i > 0; --i)
+    {
+      const std::uint32_t key = random() % range;
+      rhs.insert(key);
+      right.insert(key);
+    }
+    std::set< std::uint32_t > common;
+    std::set< std::uint32_t > difference;
+    std::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::inserter(common, common.end()));
+    std::set_difference(left.begin(), left.end(), right.begin(), right.end(),
+      std::inserter(difference, difference.end()));
+    ohantsev::RoaringSet intersection = lhs;
+    expectSame(intersection.intersect(rhs), common);
+    ohantsev::RoaringSet subtraction = lhs;
+    expectSame(subtraction.subtract(rhs), difference);
+  }
+}
+
+TEST(RoaringSet, CompressesDenseRanges)
+{
+  ohantsev::RoaringSet set;
+  for (std::uint32_t key = 0; key < 1000000; ++key)
+  {
+    set.insert(key);
+  }
+  EXPECT_LT(set.memoryUsage(), 1000000 / 4);
+  set.shrinkToFit();
+  EXPECT_LT(set.memoryUsage(), 4096u);
+  EXPECT_EQ(set.size(), 1000000u);
+}
+
+TEST(RoaringSet, EditsRunsInPlace)
+{
+  ohantsev::RoaringSet set;
+  std::set< std::uint32_t > expected;
+  for (std::uint32_t key = 0; key < 1000000; ++key)
+  {
+    set.insert(key);
+    expected.insert(key);
+  }
+  set.shrinkToFit();
+  const std::size_t compressed = set.memoryUsage();
+  EXPECT_TRUE(set.remove(500000));
+  EXPECT_TRUE(set.insert(2000000));
+  expected.erase(500000);
+  expected.insert(2000000);
+  EXPECT_LT(set.memoryUsage(), compressed + 1024);
+  std::mt19937 random(54);
+  for (int step = 0; step < 20000; ++step)
+  {
+    const std::uint32_t key = random() % 1000100;
+    if (random() % 2)
+    {
+      EXPECT_EQ(set.insert(key), expected.insert(key).second);
+    }
+    else
+    {
+      EXPECT_EQ(set.remove(key), expected.erase(key) == 1);
+    }
+  }
+  expectSame(set, expected);
+  for (std::uint32_t key = 0; key < 70000; ++key)
+  {
+    set.remove(key);
+    expected.erase(key);
+  }
+  expectSame(set, expected);
+}
+
+TEST(RoaringSet, HandlesExtremeKeys)
+{
+  const std::vector< std::uint32_t > keys{ 5, 1, 5, 0xFFFFFFFFu, 0 };
+  ohantsev::RoaringSet set(keys.begin(), keys.end());
+  EXPECT_EQ(set.size(), 4u);
+  EXPECT_EQ(*set.begin(), 0u);
+  EXPECT_NE(set.find(0xFFFFFFFFu), set.end());
+  EXPECT_EQ(set.find(2), set.end());
+}
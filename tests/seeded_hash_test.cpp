@@ -0,0 +1,82 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <gtest/gtest.h>
+#include "seeded_hash.h"
+
+namespace
+{
+  struct Point
+  {
+    int x;
+    int y;
+  };
+
+  struct SaltedPointHash
+  {
+    std::size_t salt;
+
+    std::size_t operator()(const Point& point) const
+    {
+      return (static_cast< std::size_t >(point.x) * 31 + static_cast< std::size_t >(point.y)) ^ salt;
+    }
+  };
+}
+
+TEST(SeededHash, SeedSelectsTheFunction)
+{
+  const ohantsev::SeededHash< std::string > first(1);
+  const ohantsev::SeededHash< std::string > same(1);
+  const ohantsev::SeededHash< std::string > second(2);
+  EXPECT_EQ(first("key"), same("key"));
+  EXPECT_NE(first("key"), second("key"));
+  ohantsev::SeededHash< int > reseeded(7);
+  const std::size_t before = reseeded(12345);
+  reseeded.reseed();
+  EXPECT_NE(reseeded.seed(), 7u);
+  EXPECT_NE(reseeded(12345), before);
+}
+
+TEST(SeededHash, SpreadsSequentialKeys)
+{
+  const ohantsev::SeededHash< int > intHash(3);
+  const ohantsev::SeededHash< std::string > stringHash(3);
+  std::set< std::size_t > intBuckets;
+  std::set< std::size_t > stringHashes;
+  for (int i = 0; i < 4096; ++i)
+  {
+    intBuckets.insert(intHash(i) % 1024);
+    stringHashes.insert(stringHash(std::to_string(i)));
+  }
+  EXPECT_GT(intBuckets.size(), 900u);
+  EXPECT_EQ(stringHashes.size(), 4096u);
+}
+
+TEST(SeededHash, BlocksCannotCancelTheState)
+{
+  const std::uint64_t secret = 0x8EBC6AF09C88C6E3ull;
+  for (const std::uint64_t seed: { std::uint64_t{ 1 }, std::uint64_t{ 2 } })
+  {
+    const ohantsev::SeededHash< std::string > hash(seed);
+    std::set< std::size_t > hashes;
+    for (std::uint64_t i = 0; i < 1000; ++i)
+    {
+      std::string key(16, '\0');
+      std::memcpy(&key[0], &i, sizeof(i));
+      std::memcpy(&key[8], &secret, sizeof(secret));
+      hashes.insert(hash(key));
+    }
+    EXPECT_EQ(hashes.size(), 1000u);
+  }
+}
+
+TEST(SeededHash, KeepsBaseInstance)
+{
+  const ohantsev::SeededHash< Point, SaltedPointHash > hash(5, SaltedPointHash{ 99 });
+  EXPECT_EQ(hash.base().salt, 99u);
+  const ohantsev::SeededHash< Point, SaltedPointHash > other(5, SaltedPointHash{ 100 });
+  EXPECT_NE(hash(Point{ 1, 2 }), other(Point{ 1, 2 }));
+  EXPECT_EQ(hash(Point{ 1, 2 }), hash(Point{ 1, 2 }));
+}
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <gtest/gtest.h>
+#include "SkipDictionaryList.h"
+
+namespace
+{
+  std::string print(const SkipDictionaryList< int >& list)
+  {
+    std::ostringstream out;
+    out << list;
+    return out.str();
+  }
+
+  std::string printReversed(const SkipDictionaryList< int >& list)
+  {
+    std::ostringstream out;
+    list.reversePrint(out);
+    return out.str();
+  }
+
+  template< class Range >
+  std::string print(const Range& keys)
+  {
+    std::ostringstream out;
+    bool first = true;
+    for (const int key: keys)
+    {
+      out << (first ? "" : " ") << key;
+      first = false;
+    }
+    return out.str();
+  }
+
+  SkipDictionaryList< int > makeList(const std::set< int >& keys)
+  {
+    SkipDictionaryList< int > list;
+    for (const int key: keys)
+    {
+      list.insertItem(key);
+    }
+    return list;
+  }
+
+  std::set< int > randomKeys(std::mt19937& random, const std::size_t count, const int range)
+  {
+    std::set< int > keys;
+    while (keys.size() < count)
+    {
+      keys.insert(static_cast< int >(random() % range));
+    }
+    return keys;
+  }
+}
+
+TEST(SkipDictionaryList, MatchesStdSet)
+{
+  std::mt19937 random(1);
+  SkipDictionaryList< int > list;
+  std::set< int > expected;
+  for (int step = 0; step < 20000; ++step)
+  {
+    const int key = static_cast< int >(random() % 1024);
+    switch (random() % 4)
+    {
+    case 0:
+    case 1:
+      EXPECT_EQ(list.insertItem(key), expected.insert(key).second);
+      break;
+    case 2:
+      EXPECT_EQ(list.deleteItem(key), expected.erase(key) == 1);
+      break;
+    default:
+      EXPECT_EQ(list.searchItem(key), expected.count(key) == 1);
+    }
+    if (step % 4096 == 0)
+    {
+      ASSERT_EQ(print(list), print(expected));
+    }
+  }
+  EXPECT_EQ(print(list), print(expected));
+  EXPECT_EQ(printReversed(list), print(std::set< int, std::greater< int > >(expected.begin(), expected.end())));
+  list.clear();
+  EXPECT_EQ(print(list), "");
+  EXPECT_FALSE(list.searchItem(0));
+  EXPECT_TRUE(list.insertItem(0));
+}
+
+TEST(SkipDictionaryList, SetOperationsMatchStdSet)
+{
+  std::mt19937 random(2);
+  for (const std::size_t firstSize: { 0, 1, 10, 500, 3000 })
+  {
+    for (const std::size_t secondSize: { 0, 1, 10, 500, 3000 })
+    {
+      const int range = static_cast< int >(2 * std::max(firstSize, secondSize) + 2);
+      const std::set< int > first = randomKeys(random, firstSize, range);
+      const std::set< int > second = randomKeys(random, secondSize, range);
+
+      std::set< int > intersection;
+      std::set_intersection(first.begin(), first.end(), second.begin(), second.end(),
+        std::inserter(intersection, intersection.end()));
+      EXPECT_EQ(print(getIntersection(makeList(first), makeList(second))), print(intersection));
+
+      std::set< int > united(first);
+      united.insert(second.begin(), second.end());
+      SkipDictionaryList< int > merged = makeList(first);
+      SkipDictionaryList< int > other = makeList(second);
+      merged.merge(other);
+      EXPECT_EQ(print(merged), print(united));
+      EXPECT_EQ(printReversed(merged), print(std::set< int, std::greater< int > >(united.begin(), united.end())));
+      EXPECT_EQ(print(other), print(second));
+
+      std::set< int > difference;
+      std::set_difference(first.begin(), first.end(), second.begin(), second.end(),
+        std::inserter(difference, difference.end()));
+      SkipDictionaryList< int > reduced = makeList(first);
+      reduced.deleteItems(other);
+      EXPECT_EQ(print(reduced), print(difference));
+      EXPECT_EQ(printReversed(reduced), print(std::set< int, std::greater< int > >(difference.begin(),
+        difference.end())));
+    }
+  }
+}
+
+TEST(SkipDictionaryList, SetOperationsWithItself)
+{
+  std::mt19937 random(4);
+  const std::set< int > keys = randomKeys(random, 300, 1000);
+  SkipDictionaryList< int > list = makeList(keys);
+  list.merge(list);
+  EXPECT_EQ(print(list), print(keys));
+  list.deleteItems(list);
+  EXPECT_EQ(print(list), "");
+  EXPECT_EQ(printReversed(list), "");
+  EXPECT_TRUE(list.insertItem(5));
+  EXPECT_EQ(print(list), print(std::set< int >{ 5 }));
+}
+
+TEST(SkipDictionaryList, CopiesAndMoves)
+{
+  std::mt19937 random(3);
+  const std::set< int > keys = randomKeys(random, 300, 1000);
+  SkipDictionaryList< int > list = makeList(keys);
+  SkipDictionaryList< int > copy(list);
+  EXPECT_EQ(print(copy), print(keys));
+  copy.deleteItem(*keys.begin());
+  EXPECT_TRUE(list.searchItem(*keys.begin()));
+  SkipDictionaryList< int > moved(std::move(copy));
+  EXPECT_EQ(print(copy), "");
+  EXPECT_FALSE(moved.searchItem(*keys.begin()));
+  list = moved;
+  EXPECT_EQ(print(list), print(moved));
+  list = SkipDictionaryList< int >();
+  EXPECT_EQ(print(list), "");
+  EXPECT_TRUE(list.insertItem(5));
+  EXPECT_TRUE(moved.insertItem(*keys.begin()));
+  EXPECT_EQ(print(moved), print(keys));
+}
@@ -0,0 +1,190 @@
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "unique_ptr.h"
+
+namespace
+{
+  struct Tracked
+  {
+    static int live;
+
+    Tracked()
+    {
+      ++live;
+    }
+
+    explicit Tracked(const bool fail)
+    {
+      if (fail)
+      {
+        throw std::runtime_error("construction failed");
+      }
+      ++live;
+    }
+
+    ~Tracked()
+    {
+      --live;
+    }
+  };
+
+  int Tracked::live = 0;
+
+  struct RecordingDelete
+  {
+    std::vector< int* >* deleted;
+
+    void operator()(int* pointer) const noexcept
+    {
+      deleted->push_back(pointer);
+      delete pointer;
+    }
+  };
+
+  struct ArrayRecordingDelete
+  {
+    std::vector< Tracked* >* deleted;
+
+    void operator()(Tracked* pointer) const noexcept
+    {
+      deleted->push_back(pointer);
+      delete[] pointer;
+    }
+  };
+
+  struct AllocationLog
+  {
+    static std::size_t allocated;
+    static std::size_t deallocated;
+  };
+
+  std::size_t AllocationLog::allocated = 0;
+  std::size_t AllocationLog::deallocated = 0;
+
+  template< class T >
+  struct CountingAllocator
+  {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template< class U >
+    CountingAllocator(const CountingAllocator< U >&) noexcept
+    {}
+
+    T* allocate(const std::size_t count)
+    {
+      ++AllocationLog::allocated;
+      return std::allocator< T >().allocate(count);
+    }
+
+    void deallocate(T* pointer, const std::size_t count) noexcept
+    {
+      ++AllocationLog::deallocated;
+      std::allocator< T >().deallocate(pointer, count);
+    }
+  };
+
+  template< class T, class U >
+  bool operator==(const CountingAllocator< T >&, const CountingAllocator< U >&) noexcept
+  {
+    return true;
+  }
+
+  template< class T, class U >
+  bool operator!=(const CountingAllocator< T >&, const CountingAllocator< U >&) noexcept
+  {
+    return false;
+  }
+}
+
+TEST(UniquePtr, CustomDeleterRunsOncePerPointer)
+{
+  std::vector< int* > deleted;
+  int* first = new int(1);
+  int* second = new int(2);
+  int* third = new int(3);
+  {
+    ohantsev::UniquePtr< int, RecordingDelete > pointer(first, RecordingDelete{ &deleted });
+    pointer.reset(second);
+    ASSERT_EQ(deleted, std::vector< int* >{ first });
+    pointer.reset(second);
+    EXPECT_EQ(deleted.size(), 1u);
+
+    ohantsev::UniquePtr< int, RecordingDelete > moved(std::move(pointer));
+    EXPECT_EQ(pointer.get(), nullptr);
+    EXPECT_EQ(*moved, 2);
+    ohantsev::UniquePtr< int, RecordingDelete > other(third, RecordingDelete{ &deleted });
+    other = std::move(moved);
+    EXPECT_EQ((std::vector< int* >{ first, third }), deleted);
+
+    int* released = other.release();
+    EXPECT_EQ(released, second);
+    other.reset(released);
+  }
+  EXPECT_EQ((std::vector< int* >{ first, third, second }), deleted);
+}
+
+TEST(UniquePtr, ArrayDestroysEveryElement)
+{
+  Tracked::live = 0;
+  {
+    ohantsev::UniquePtr< Tracked[] > array = ohantsev::makeUnique< Tracked[] >(7);
+    EXPECT_EQ(Tracked::live, 7);
+    EXPECT_EQ(&array[3], array.get() + 3);
+    array.reset(new Tracked[2]);
+    EXPECT_EQ(Tracked::live, 2);
+    ohantsev::UniquePtr< Tracked[] > moved(std::move(array));
+    EXPECT_FALSE(array);
+    EXPECT_EQ(Tracked::live, 2);
+  }
+  EXPECT_EQ(Tracked::live, 0);
+
+  std::vector< Tracked* > deleted;
+  Tracked* elements = new Tracked[4];
+  {
+    ohantsev::UniquePtr< Tracked[], ArrayRecordingDelete > array(elements, ArrayRecordingDelete{ &deleted });
+    array = nullptr;
+    EXPECT_EQ(Tracked::live, 0);
+  }
+  EXPECT_EQ(deleted, std::vector< Tracked* >{ elements });
+}
+
+TEST(UniquePtr, EmptyDeleterAddsNoSpace)
+{
+  using allocator_delete = ohantsev::AllocatorDelete< CountingAllocator< int > >;
+  EXPECT_EQ(sizeof(ohantsev::UniquePtr< int >), sizeof(int*));
+  EXPECT_EQ(sizeof(ohantsev::UniquePtr< int[] >), sizeof(int*));
+  EXPECT_EQ(sizeof(allocator_delete), 1u);
+  EXPECT_EQ((sizeof(ohantsev::UniquePtr< int, allocator_delete >)), sizeof(int*));
+  EXPECT_EQ((sizeof(ohantsev::UniquePtr< int, ohantsev::AllocatorDelete< std::allocator< int > > >)), sizeof(int*));
+  EXPECT_EQ((sizeof(ohantsev::UniquePtr< int, RecordingDelete >)), 2 * sizeof(int*));
+}
+
+TEST(UniquePtr, AllocateUniqueBalancesAllocator)
+{
+  AllocationLog::allocated = 0;
+  AllocationLog::deallocated = 0;
+  Tracked::live = 0;
+  {
+    auto pointer = ohantsev::allocateUnique< Tracked >(CountingAllocator< char >());
+    EXPECT_EQ(AllocationLog::allocated, 1u);
+    EXPECT_EQ(Tracked::live, 1);
+    auto other = ohantsev::allocateUnique< Tracked >(CountingAllocator< char >(), false);
+    other = std::move(pointer);
+    EXPECT_EQ(AllocationLog::allocated, 2u);
+    EXPECT_EQ(AllocationLog::deallocated, 1u);
+    EXPECT_EQ(Tracked::live, 1);
+    other.reset();
+    EXPECT_EQ(AllocationLog::deallocated, 2u);
+  }
+  EXPECT_EQ(Tracked::live, 0);
+  EXPECT_THROW(ohantsev::allocateUnique< Tracked >(CountingAllocator< Tracked >(), true), std::runtime_error);
+  EXPECT_EQ(AllocationLog::allocated, 3u);
+  EXPECT_EQ(AllocationLog::deallocated, 3u);
+  EXPECT_EQ(Tracked::live, 0);
+}
@@ -1,17 +1,52 @@
 #ifndef UNIQUE_PTR_H
 #define UNIQUE_PTR_H
 #include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include "ebo_storage.h"
 
 namespace ohantsev
 {
   template< class T >
-  class UniquePtr
+  struct DefaultDelete
+  {
+    void operator()(T* pointer) const noexcept
+    {
+      delete pointer;
+    }
+  };
+
+  template< class T >
+  struct DefaultDelete< T[] >
+  {
+    void operator()(T* pointer) const noexcept
+    {
+      delete[] pointer;
+    }
+  };
+
+  template< class Alloc >
+  class AllocatorDelete: private EboStorage< Alloc >
+  {
+  public:
+    using traits = std::allocator_traits< Alloc >;
+    using value_type = typename traits::value_type;
+
+    AllocatorDelete() = default;
+    explicit AllocatorDelete(const Alloc& alloc);
+    void operator()(value_type* pointer) noexcept;
+  };
+
+  template< class T, class Deleter = DefaultDelete< T > >
+  class UniquePtr: private EboStorage< Deleter >
   {
   public:
     UniquePtr() = default;
     ~UniquePtr() noexcept;
     explicit UniquePtr(T* pointer) noexcept;
+    UniquePtr(T* pointer, const Deleter& deleter) noexcept;
     UniquePtr(const UniquePtr&) = delete;
     UniquePtr& operator=(const UniquePtr&) = delete;
     UniquePtr(UniquePtr&& rhs) noexcept;
@@ -21,6 +56,8 @@ namespace ohantsev
     T& operator*() const;
     T* operator->() const;
     T* get() const noexcept;
+    Deleter& getDeleter() noexcept;
+    const Deleter& getDeleter() const noexcept;
     T* release() noexcept;
     void reset(T* pointer = nullptr) noexcept;
     explicit operator bool() const noexcept;
@@ -29,94 +66,291 @@ namespace ohantsev
     T* pointer_{ nullptr };
   };
 
-  template< class T >
-  UniquePtr<T>::~UniquePtr() noexcept
+  template< class T, class Deleter >
+  class UniquePtr< T[], Deleter >: private EboStorage< Deleter >
   {
-    delete pointer_;
+  public:
+    UniquePtr() = default;
+    ~UniquePtr() noexcept;
+    explicit UniquePtr(T* pointer) noexcept;
+    UniquePtr(T* pointer, const Deleter& deleter) noexcept;
+    UniquePtr(const UniquePtr&) = delete;
+    UniquePtr& operator=(const UniquePtr&) = delete;
+    UniquePtr(UniquePtr&& rhs) noexcept;
+    UniquePtr& operator=(UniquePtr&& rhs) noexcept;
+    explicit UniquePtr(std::nullptr_t) noexcept;
+    UniquePtr& operator=(std::nullptr_t) noexcept;
+    T& operator[](std::size_t index) const;
+    T* get() const noexcept;
+    Deleter& getDeleter() noexcept;
+    const Deleter& getDeleter() const noexcept;
+    T* release() noexcept;
+    void reset(T* pointer = nullptr) noexcept;
+    explicit operator bool() const noexcept;
+
+  private:
+    T* pointer_{ nullptr };
+  };
+
+  template< class Alloc >
+  AllocatorDelete<Alloc>::AllocatorDelete(const Alloc& alloc):
+    EboStorage< Alloc >(alloc)
+  {}
+
+  template< class Alloc >
+  void AllocatorDelete<Alloc>::operator()(value_type* pointer) noexcept
+  {
+    Alloc& alloc = this->get();
+    traits::destroy(alloc, pointer);
+    traits::deallocate(alloc, pointer, 1);
   }
 
-  template< class T >
-  UniquePtr<T>::UniquePtr(T* pointer) noexcept:
+  template< class T, class Deleter >
+  UniquePtr<T, Deleter>::~UniquePtr() noexcept
+  {
+    if (pointer_)
+    {
+      getDeleter()(pointer_);
+    }
+  }
+
+  template< class T, class Deleter >
+  UniquePtr<T, Deleter>::UniquePtr(T* pointer) noexcept:
     pointer_(pointer)
   {}
 
-  template< class T >
-  UniquePtr<T>::UniquePtr(UniquePtr&& rhs) noexcept:
+  template< class T, class Deleter >
+  UniquePtr<T, Deleter>::UniquePtr(T* pointer, const Deleter& deleter) noexcept:
+    EboStorage< Deleter >(deleter),
+    pointer_(pointer)
+  {}
+
+  template< class T, class Deleter >
+  UniquePtr<T, Deleter>::UniquePtr(UniquePtr&& rhs) noexcept:
+    EboStorage< Deleter >(std::move(rhs.getDeleter())),
     pointer_(rhs.pointer_)
   {
     rhs.pointer_ = nullptr;
   }
 
-  template< class T >
-  UniquePtr<T>& UniquePtr<T>::operator=(UniquePtr&& rhs) noexcept
+  template< class T, class Deleter >
+  UniquePtr<T, Deleter>& UniquePtr<T, Deleter>::operator=(UniquePtr&& rhs) noexcept
   {
     if (this != &rhs)
     {
       reset(rhs.release());
+      getDeleter() = std::move(rhs.getDeleter());
     }
     return *this;
   }
 
-  template< class T >
-  UniquePtr<T>::UniquePtr(std::nullptr_t) noexcept:
+  template< class T, class Deleter >
+  UniquePtr<T, Deleter>::UniquePtr(std::nullptr_t) noexcept:
     pointer_(nullptr)
   {}
 
-  template< class T >
-  UniquePtr<T>& UniquePtr<T>::operator=(std::nullptr_t) noexcept
+  template< class T, class Deleter >
+  UniquePtr<T, Deleter>& UniquePtr<T, Deleter>::operator=(std::nullptr_t) noexcept
   {
     reset();
     return *this;
   }
 
-  template< class T >
-  T& UniquePtr<T>::operator*() const
+  template< class T, class Deleter >
+  T& UniquePtr<T, Deleter>::operator*() const
   {
     assert(pointer_ != nullptr);
     return *pointer_;
   }
 
-  template< class T >
-  T* UniquePtr<T>::operator->() const
+  template< class T, class Deleter >
+  T* UniquePtr<T, Deleter>::operator->() const
   {
     assert(pointer_ != nullptr);
     return pointer_;
   }
 
-  template< class T >
-  T* UniquePtr<T>::get() const noexcept
+  template< class T, class Deleter >
+  T* UniquePtr<T, Deleter>::get() const noexcept
   {
     return pointer_;
   }
 
-  template< class T >
-  T* UniquePtr<T>::release() noexcept
+  template< class T, class Deleter >
+  Deleter& UniquePtr<T, Deleter>::getDeleter() noexcept
+  {
+    return this->EboStorage< Deleter >::get();
+  }
+
+  template< class T, class Deleter >
+  const Deleter& UniquePtr<T, Deleter>::getDeleter() const noexcept
+  {
+    return this->EboStorage< Deleter >::get();
+  }
+
+  template< class T, class Deleter >
+  T* UniquePtr<T, Deleter>::release() noexcept
   {
     T* pointer = pointer_;
     pointer_ = nullptr;
     return pointer;
   }
 
-  template< class T >
-  void UniquePtr<T>::reset(T* pointer) noexcept
+  template< class T, class Deleter >
+  void UniquePtr<T, Deleter>::reset(T* pointer) noexcept
   {
     if (pointer_ != pointer)
     {
-      delete pointer_;
+      T* old = pointer_;
       pointer_ = pointer;
+      if (old)
+      {
+        getDeleter()(old);
+      }
     }
   }
 
-  template< class T >
-  UniquePtr<T>::operator bool() const noexcept
+  template< class T, class Deleter >
+  UniquePtr<T, Deleter>::operator bool() const noexcept
+  {
+    return (pointer_ != nullptr);
+  }
+
+  template< class T, class Deleter >
+  UniquePtr<T[], Deleter>::~UniquePtr() noexcept
+  {
+    if (pointer_)
+    {
+      getDeleter()(pointer_);
+    }
+  }
+
+  template< class T, class Deleter >
+  UniquePtr<T[], Deleter>::UniquePtr(T* pointer) noexcept:
+    pointer_(pointer)
+  {}
+
+  template< class T, class Deleter >
+  UniquePtr<T[], Deleter>::UniquePtr(T* pointer, const Deleter& deleter) noexcept:
+    EboStorage< Deleter >(deleter),
+    pointer_(pointer)
+  {}
+
+  template< class T, class Deleter >
+  UniquePtr<T[], Deleter>::UniquePtr(UniquePtr&& rhs) noexcept:
+    EboStorage< Deleter >(std::move(rhs.getDeleter())),
+    pointer_(rhs.pointer_)
+  {
+    rhs.pointer_ = nullptr;
+  }
+
+  template< class T, class Deleter >
+  UniquePtr<T[], Deleter>& UniquePtr<T[], Deleter>::operator=(UniquePtr&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      reset(rhs.release());
+      getDeleter() = std::move(rhs.getDeleter());
+    }
+    return *this;
+  }
+
+  template< class T, class Deleter >
+  UniquePtr<T[], Deleter>::UniquePtr(std::nullptr_t) noexcept:
+    pointer_(nullptr)
+  {}
+
+  template< class T, class Deleter >
+  UniquePtr<T[], Deleter>& UniquePtr<T[], Deleter>::operator=(std::nullptr_t) noexcept
+  {
+    reset();
+    return *this;
+  }
+
+  template< class T, class Deleter >
+  T& UniquePtr<T[], Deleter>::operator[](const std::size_t index) const
+  {
+    assert(pointer_ != nullptr);
+    return pointer_[index];
+  }
+
+  template< class T, class Deleter >
+  T* UniquePtr<T[], Deleter>::get() const noexcept
+  {
+    return pointer_;
+  }
+
+  template< class T, class Deleter >
+  Deleter& UniquePtr<T[], Deleter>::getDeleter() noexcept
+  {
+    return this->EboStorage< Deleter >::get();
+  }
+
+  template< class T, class Deleter >
+  const Deleter& UniquePtr<T[], Deleter>::getDeleter() const noexcept
+  {
+    return this->EboStorage< Deleter >::get();
+  }
+
+  template< class T, class Deleter >
+  T* UniquePtr<T[], Deleter>::release() noexcept
+  {
+    T* pointer = pointer_;
+    pointer_ = nullptr;
+    return pointer;
+  }
+
+  template< class T, class Deleter >
+  void UniquePtr<T[], Deleter>::reset(T* pointer) noexcept
+  {
+    if (pointer_ != pointer)
+    {
+      T* old = pointer_;
+      pointer_ = pointer;
+      if (old)
+      {
+        getDeleter()(old);
+      }
+    }
+  }
+
+  template< class T, class Deleter >
+  UniquePtr<T[], Deleter>::operator bool() const noexcept
   {
     return (pointer_ != nullptr);
   }
 
   template< class T, class... Args >
-  UniquePtr< T > makeUnique(Args&&... args)
+  std::enable_if_t< !std::is_array< T >::value, UniquePtr< T > > makeUnique(Args&&... args)
   {
     return UniquePtr< T >(new T(std::forward< Args >(args)...));
   }
+
+  template< class T >
+  std::enable_if_t< std::is_array< T >::value && std::extent< T >::value == 0, UniquePtr< T > >
+  makeUnique(const std::size_t size)
+  {
+    return UniquePtr< T >(new std::remove_extent_t< T >[size]());
+  }
+
+  template< class T, class Alloc, class... Args >
+  auto allocateUnique(const Alloc& alloc, Args&&... args)
+  {
+    using allocator_type = typename std::allocator_traits< Alloc >::template rebind_alloc< T >;
+    using traits = std::allocator_traits< allocator_type >;
+    allocator_type allocator(alloc);
+    T* pointer = traits::allocate(allocator, 1);
+    try
+    {
+      traits::construct(allocator, pointer, std::forward< Args >(args)...);
+    }
+    catch (...)
+    {
+      traits::deallocate(allocator, pointer, 1);
+      throw;
+    }
+    using deleter_type = AllocatorDelete< allocator_type >;
+    return UniquePtr< T, deleter_type >(pointer, deleter_type(allocator));
+  }
 }
 #endif